@@ -0,0 +1,132 @@
+/*****************************************************************************
+ * main.cpp: ParseCache cold/warm scan benchmark
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+static const char* cachePath = "parse-cache-benchmark.bin";
+
+/* The corpus is made of copies of the sample, so every file is a distinct
+   cache entry with the same parsing cost */
+static std::vector<std::string> generateCorpus(const char* sample, unsigned int count)
+{
+    std::ifstream in(sample, std::ios::binary);
+    std::string content{std::istreambuf_iterator<char>(in),
+                        std::istreambuf_iterator<char>()};
+    std::vector<std::string> corpus;
+    for (auto i = 0u; i < count; ++i)
+    {
+        auto path = "parse-cache-corpus-" + std::to_string(i) + ".mp4";
+        std::ofstream out(path, std::ios::binary);
+        out.write(content.data(), content.size());
+        corpus.push_back(std::move(path));
+    }
+    return corpus;
+}
+
+/* Returns the number of media that had to be parsed */
+static unsigned int scan(VLC::Instance& instance, VLC::ParseCache& cache,
+                         const std::vector<std::string>& corpus)
+{
+    VLC::Parser parser(instance);
+    std::mutex mutex;
+    std::condition_variable cond;
+    unsigned int pending = 0;
+
+    VLC::Parser::Callbacks cbs([&](VLC::Parser::Task&& task, VLC::Parser::Status status) {
+        auto media = task.getMedia();
+        if (status == VLC::Parser::Status::Done)
+            cache.store(media);
+        std::lock_guard<std::mutex> lock(mutex);
+        --pending;
+        cond.notify_all();
+    });
+
+    unsigned int parsed = 0;
+    VLC::ParseCache::Entry entry;
+    for (const auto& path : corpus)
+    {
+        VLC::Media media(path, VLC::Media::FromPath);
+        if (cache.lookup(media, entry))
+            continue;
+        VLC::Parser::Request req(media);
+        req.setParseFlags(VLC::Parser::ParseFlags::Parse |
+                          VLC::Parser::ParseFlags::FetchLocal);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++pending;
+        }
+        parser.queue(req, cbs);
+        ++parsed;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [&] { return pending == 0; });
+    return parsed;
+}
+
+static void run(VLC::Instance& instance, const char* name,
+                const std::vector<std::string>& corpus)
+{
+    auto start = std::chrono::steady_clock::now();
+    VLC::ParseCache cache(cachePath);
+    auto loaded = std::chrono::steady_clock::now();
+    auto parsed = scan(instance, cache, corpus);
+    auto scanned = std::chrono::steady_clock::now();
+    cache.save();
+    auto saved = std::chrono::steady_clock::now();
+
+    using ms = std::chrono::duration<double, std::milli>;
+    std::cout << name << ": " << corpus.size() << " files, "
+              << parsed << " parsed, "
+              << "load " << ms(loaded - start).count() << "ms, "
+              << "scan " << ms(scanned - loaded).count() << "ms, "
+              << "save " << ms(saved - scanned).count() << "ms" << std::endl;
+}
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <sample file> [corpus size]" << std::endl;
+        return 1;
+    }
+    auto count = ac > 2 ? static_cast<unsigned int>(atoi(av[2])) : 200u;
+    auto corpus = generateCorpus(av[1], count);
+
+    auto instance = VLC::Instance(0, nullptr);
+
+    remove(cachePath);
+    run(instance, "cold", corpus);
+    run(instance, "warm", corpus);
+
+    remove(cachePath);
+    for (const auto& path : corpus)
+        remove(path.c_str());
+    return 0;
+}
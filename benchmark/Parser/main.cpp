@@ -0,0 +1,265 @@
+/*****************************************************************************
+ * main.cpp: Parser and thumbnailer throughput benchmark
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct Run
+{
+    unsigned int threads;
+    double filesPerSecond;
+    double p50;
+    double p99;
+    unsigned int failed;
+};
+
+/* Remux the sample to a different container, through the stream output */
+static bool remux(VLC::Instance& instance, const char* sample, const char* mux,
+                  const std::string& dst)
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool stopped = false;
+    bool failed = false;
+
+    VLC::MediaPlayer::Callbacks cbs;
+    cbs.onStateChanged([&](VLC::MediaPlayer::LibvlcState state) {
+        if (state != VLC::MediaPlayer::LibvlcState::Stopped &&
+            state != VLC::MediaPlayer::LibvlcState::Error)
+            return;
+        std::lock_guard<std::mutex> lock(mutex);
+        failed = failed || state == VLC::MediaPlayer::LibvlcState::Error;
+        stopped = true;
+        cond.notify_all();
+    });
+    VLC::MediaPlayer mp(instance, cbs);
+    VLC::Media media(sample, VLC::Media::FromPath);
+    media.addOption(std::string(":sout=#std{access=file,mux=") + mux + ",dst=" + dst + "}");
+    mp.setMedia(media);
+    if (!mp.play())
+        return false;
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [&stopped] { return stopped; });
+    return !failed;
+}
+
+static void copyFile(const std::string& src, const std::string& dst)
+{
+    std::ifstream in(src, std::ios::binary);
+    std::ofstream out(dst, std::ios::binary);
+    out << in.rdbuf();
+}
+
+/* Each container variant is remuxed once, and then replicated, so the corpus
+   mixes demuxers without spending the benchmark time in the stream output */
+static std::vector<std::string> generateCorpus(VLC::Instance& instance, const char* sample,
+                                               unsigned int count)
+{
+    static const char* muxers[][2] = { { "mp4", "mp4" }, { "mkv", "mkv" }, { "ts", "ts" } };
+    std::vector<std::string> variants;
+    for (const auto& m : muxers)
+    {
+        auto path = std::string("parser-corpus-variant.") + m[1];
+        if (remux(instance, sample, m[0], path))
+            variants.push_back(path);
+        else
+            std::cerr << "Failed to remux the sample to " << m[0] << std::endl;
+    }
+    if (variants.empty())
+        variants.push_back(sample);
+    std::vector<std::string> corpus;
+    for (auto i = 0u; i < count; ++i)
+    {
+        const auto& src = variants[i % variants.size()];
+        auto path = "parser-corpus-" + std::to_string(i) + src.substr(src.rfind('.'));
+        copyFile(src, path);
+        corpus.push_back(std::move(path));
+    }
+    for (const auto& v : variants)
+    {
+        if (v != sample)
+            std::remove(v.c_str());
+    }
+    return corpus;
+}
+
+static Run summarize(unsigned int threads, std::vector<double>& latencies,
+                     Clock::duration elapsed, unsigned int failed)
+{
+    std::sort(begin(latencies), end(latencies));
+    Run r;
+    r.threads = threads;
+    r.filesPerSecond = latencies.size() / std::chrono::duration<double>(elapsed).count();
+    r.p50 = latencies[latencies.size() / 2];
+    r.p99 = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+    r.failed = failed;
+    return r;
+}
+
+/* Queue the whole corpus at once. The latency of a request is measured from
+   its submission, so it includes the time spent waiting for a thread */
+static Run benchParse(VLC::Instance& instance, const std::vector<std::string>& corpus,
+                      unsigned int threads)
+{
+    VLC::Parser parser(instance, VLC::Parser::Config().setMaxParserThreads(threads));
+    std::vector<Clock::time_point> starts(corpus.size());
+    std::vector<double> latencies;
+    latencies.reserve(corpus.size());
+    unsigned int failed = 0;
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    VLC::Parser::Callbacks cbs([&](VLC::Parser::Task&&, VLC::Parser::Status status, void* ctx) {
+        auto index = reinterpret_cast<uintptr_t>(ctx);
+        auto latency = std::chrono::duration<double, std::milli>(Clock::now() - starts[index]);
+        std::lock_guard<std::mutex> lock(mutex);
+        latencies.push_back(latency.count());
+        if (status != VLC::Parser::Status::Done)
+            ++failed;
+        cond.notify_all();
+    });
+
+    auto start = Clock::now();
+    for (auto i = 0u; i < corpus.size(); ++i)
+    {
+        VLC::Media media(corpus[i], VLC::Media::FromPath);
+        VLC::Parser::Request req(media);
+        req.setParseFlags(VLC::Parser::ParseFlags::Parse)
+           .setUserContext(reinterpret_cast<void*>(static_cast<uintptr_t>(i)));
+        starts[i] = Clock::now();
+        parser.queue(req, cbs);
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [&] { return latencies.size() == corpus.size(); });
+    return summarize(threads, latencies, Clock::now() - start, failed);
+}
+
+static Run benchThumbnail(VLC::Instance& instance, const std::vector<std::string>& corpus,
+                          unsigned int threads)
+{
+    VLC::Parser parser(instance, VLC::Parser::Config().setMaxThumbnailerThreads(threads));
+    std::vector<Clock::time_point> starts(corpus.size());
+    std::vector<double> latencies;
+    latencies.reserve(corpus.size());
+    unsigned int failed = 0;
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    VLC::Parser::ThumbnailerCallbacks cbs([&](VLC::Parser::Task&&, const VLC::Picture& picture,
+                                              void* ctx) {
+        auto index = reinterpret_cast<uintptr_t>(ctx);
+        auto latency = std::chrono::duration<double, std::milli>(Clock::now() - starts[index]);
+        std::lock_guard<std::mutex> lock(mutex);
+        latencies.push_back(latency.count());
+        if (!picture.isValid())
+            ++failed;
+        cond.notify_all();
+    });
+
+    auto start = Clock::now();
+    for (auto i = 0u; i < corpus.size(); ++i)
+    {
+        VLC::Media media(corpus[i], VLC::Media::FromPath);
+        VLC::Parser::ThumbnailerRequest req(media);
+        req.setSize(320, 180, true)
+           .setPictureType(VLC::Picture::Type::Jpg)
+           .setSeekPosition(0.3, VLC::Parser::ThumbnailSeekSpeed::Fast)
+           .setUserContext(reinterpret_cast<void*>(static_cast<uintptr_t>(i)));
+        starts[i] = Clock::now();
+        parser.queueThumbnailing(req, cbs);
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [&] { return latencies.size() == corpus.size(); });
+    return summarize(threads, latencies, Clock::now() - start, failed);
+}
+
+static void writeRuns(std::ostream& out, const char* name, const std::vector<Run>& runs)
+{
+    out << "  \"" << name << "\": [\n";
+    for (auto i = 0u; i < runs.size(); ++i)
+    {
+        const auto& r = runs[i];
+        out << "    { \"threads\": " << r.threads
+            << ", \"filesPerSecond\": " << r.filesPerSecond
+            << ", \"p50Ms\": " << r.p50
+            << ", \"p99Ms\": " << r.p99
+            << ", \"failed\": " << r.failed
+            << " }" << (i + 1 < runs.size() ? "," : "") << "\n";
+    }
+    out << "  ]";
+}
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <sample> [corpus size] [output.json]" << std::endl;
+        return 1;
+    }
+    auto count = ac > 2 ? static_cast<unsigned int>(atoi(av[2])) : 200u;
+    if (count == 0)
+        count = 200;
+    auto cores = std::max(std::thread::hardware_concurrency(), 1u);
+
+    auto instance = VLC::Instance(0, nullptr);
+    auto corpus = generateCorpus(instance, av[1], count);
+
+    // 1, 2, 4... up to the core count, which is always measured
+    std::vector<unsigned int> threads;
+    for (auto t = 1u; t < cores; t *= 2)
+        threads.push_back(t);
+    threads.push_back(cores);
+
+    std::vector<Run> parseRuns, thumbnailRuns;
+    for (auto t : threads)
+    {
+        parseRuns.push_back(benchParse(instance, corpus, t));
+        thumbnailRuns.push_back(benchThumbnail(instance, corpus, t));
+    }
+
+    std::ofstream file;
+    if (ac > 3)
+        file.open(av[3]);
+    std::ostream& out = ac > 3 ? file : std::cout;
+    out << "{\n"
+        << "  \"corpus\": " << corpus.size() << ",\n"
+        << "  \"cores\": " << cores << ",\n";
+    writeRuns(out, "parser", parseRuns);
+    out << ",\n";
+    writeRuns(out, "thumbnailer", thumbnailRuns);
+    out << "\n}" << std::endl;
+
+    for (const auto& path : corpus)
+        std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*****************************************************************************
+ * main.cpp: PixelConvert kernels throughput benchmark
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+using Isa = VLC::PixelConvert::Isa;
+using Layout = VLC::PixelConvert::Layout;
+
+static const uint32_t width = 1920;
+static const uint32_t height = 1080;
+
+/* Returns the throughput in source megapixels per second */
+static double measure(unsigned int iterations, const std::function<void()>& kernel)
+{
+    kernel();
+    auto start = std::chrono::steady_clock::now();
+    for (auto i = 0u; i < iterations; ++i)
+        kernel();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(width) * height * iterations / elapsed.count() / 1e6;
+}
+
+int main(int ac, char** av)
+{
+    auto iterations = ac > 1 ? static_cast<unsigned int>(atoi(av[1])) : 200u;
+
+    std::vector<uint8_t> rgb(width * height * 4);
+    std::vector<uint8_t> yuv(width * height * 3 / 2);
+    for (auto i = 0u; i < rgb.size(); ++i)
+        rgb[i] = static_cast<uint8_t>(i * 31 + i / 7);
+    for (auto i = 0u; i < yuv.size(); ++i)
+        yuv[i] = static_cast<uint8_t>(i * 17 + i / 5);
+    std::vector<uint8_t> out(width * height * 4);
+    auto y = yuv.data();
+    auto u = y + width * height;
+    auto v = u + width * height / 4;
+
+    std::cout << "isa\targb>bgra\trgba>bgra\targb>gray\ti420>bgra\tbox(4bpp)\tbox(1bpp)\t(MP/s)" << std::endl;
+    for (auto isa : {Isa::Scalar, Isa::Sse2, Isa::Avx2})
+    {
+        if (VLC::PixelConvert::resolve(isa) != isa)
+            continue;
+        std::cout << (isa == Isa::Scalar ? "scalar" : (isa == Isa::Sse2 ? "sse2" : "avx2"));
+        std::cout << '\t' << measure(iterations, [&] {
+            VLC::PixelConvert::toBgra(Layout::Argb, rgb.data(), width * 4, out.data(), width * 4,
+                                      width, height, isa);
+        });
+        std::cout << '\t' << measure(iterations, [&] {
+            VLC::PixelConvert::toBgra(Layout::Rgba, rgb.data(), width * 4, out.data(), width * 4,
+                                      width, height, isa);
+        });
+        std::cout << '\t' << measure(iterations, [&] {
+            VLC::PixelConvert::toGray(Layout::Argb, rgb.data(), width * 4, out.data(), width,
+                                      width, height, isa);
+        });
+        std::cout << '\t' << measure(iterations, [&] {
+            VLC::PixelConvert::i420ToBgra(y, width, u, width / 2, v, width / 2, out.data(), width * 4,
+                                          width, height, isa);
+        });
+        std::cout << '\t' << measure(iterations, [&] {
+            VLC::PixelConvert::downscale(rgb.data(), width * 4, out.data(), width * 2,
+                                         width, height, 4, isa);
+        });
+        std::cout << '\t' << measure(iterations, [&] {
+            VLC::PixelConvert::downscale(y, width, out.data(), width / 2, width, height, 1, isa);
+        });
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+/*****************************************************************************
+ * main.cpp: TimelinePreview thumbnailer threads benchmark
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <file> [nbTiles]" << std::endl;
+        return 1;
+    }
+    auto nbTiles = ac > 2 ? static_cast<unsigned int>(atoi(av[2])) : 100u;
+
+    auto instance = VLC::Instance(0, nullptr);
+    VLC::Media media(av[1], VLC::Media::FromPath);
+
+    std::cout << "threads\twall(ms)\tmin(ms)\tavg(ms)\tmax(ms)\tfailed" << std::endl;
+    for (auto threads : {1u, 2u, 4u, 8u})
+    {
+        VLC::Parser parser(instance, VLC::Parser::Config().setMaxThumbnailerThreads(threads));
+        VLC::TimelinePreview preview(nbTiles, 160, 90);
+        auto report = preview.generate(parser, media);
+        std::cout << threads << '\t' << report.wallTime.count() << '\t'
+                  << report.minLatency.count() / 1000. << '\t'
+                  << report.averageLatency.count() / 1000. << '\t'
+                  << report.maxLatency.count() / 1000. << '\t'
+                  << report.failed << std::endl;
+    }
+    return 0;
+}
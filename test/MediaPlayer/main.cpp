@@ -29,6 +29,7 @@
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 constexpr auto playbackDuration = std::chrono::seconds(2);
 
@@ -177,6 +178,223 @@ void testSharedCallbacksTwoPlayers(VLC::Instance& instance,
     assert(mediaChanges.load() == 2);
 }
 
+/* A StatsSampler attached to a playing media must produce increasing samples
+   with non zero decoding rates, readable through its handle */
+void testStatsSampler(VLC::Instance& instance, const char* mediaPath)
+{
+    VLC::StatsSampler sampler(std::chrono::milliseconds(100), 8);
+    VLC::MediaPlayer mp(instance);
+    VLC::Media media(mediaPath, VLC::Media::FromPath);
+    auto handle = sampler.add(media);
+
+    mp.setMedia(media);
+    assert(mp.play());
+    std::this_thread::sleep_for(playbackDuration);
+
+    VLC::StatsSampler::Sample sample;
+    assert(handle.latest(sample));
+    assert(sample.index > 0);
+    assert(sample.interval.count() > 0);
+    assert(sample.counters.decodedVideo > 0);
+
+    /* the ring only keeps the last 8 samples, in order */
+    auto history = handle.history();
+    assert(history.size() == 8);
+    for (auto i = 1u; i < history.size(); ++i)
+        assert(history[i].index == history[i - 1].index + 1);
+    bool decoding = false;
+    for (const auto& s : history)
+        decoding = decoding || s.rates.decodedVideo > 0;
+    assert(decoding);
+
+    sampler.remove(handle);
+    mp.stopAsync();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    /* the handle remains readable once removed */
+    assert(handle.latest(sample));
+}
+
+/* A VideoFrameSink must hand out 64 bytes aligned planes, deliver the frames
+   in display order, drop pictures while the consumer holds the whole pool,
+   and recycle the frames once they are released */
+void testVideoFrameSink(VLC::Instance& instance, const char* mediaPath)
+{
+    std::mutex mutex;
+    std::vector<VLC::VideoFrameSink::Frame> held;
+    bool holding = true;
+    bool ordered = true;
+    bool aligned = true;
+    uint64_t last = 0;
+    uint64_t count = 0;
+
+    VLC::VideoFrameSink sink("I420", [&](VLC::VideoFrameSink::Frame&& frame) {
+        for (auto i = 0u; i < frame.format().nbPlanes; ++i)
+        {
+            if (reinterpret_cast<uintptr_t>(frame.plane(i)) % 64 != 0 ||
+                frame.pitch(i) % 64 != 0)
+                aligned = false;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (count++ > 0 && frame.sequence() != last + 1)
+            ordered = false;
+        last = frame.sequence();
+        if (holding)
+            held.push_back(std::move(frame));
+    }, 2);
+    VLC::MediaPlayer mp(instance);
+    VLC::Media media(mediaPath, VLC::Media::FromPath);
+    mp.setMedia(media);
+    sink.attach(mp);
+    assert(mp.play());
+    std::this_thread::sleep_for(playbackDuration / 2);
+
+    /* the consumer holds every frame, so the video output runs dry */
+    auto stats = sink.stats();
+    assert(stats.delivered > 0);
+    assert(stats.dropped > 0);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        assert(held.size() == stats.delivered);
+        assert(held.size() <= stats.poolSize);
+        for (auto i = 1u; i < held.size(); ++i)
+            assert(held[i].plane(0) != held[0].plane(0));
+        holding = false;
+        held.clear();
+    }
+
+    /* released frames go back to the pool */
+    std::this_thread::sleep_for(playbackDuration / 2);
+    assert(sink.stats().delivered > stats.delivered);
+    mp.stopAsync();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    std::lock_guard<std::mutex> lock(mutex);
+    assert(ordered);
+    assert(aligned);
+}
+
+/* A slow consumer of a VideoFrameMailbox must only see the newest frames,
+   while the video output keeps going and overwrites the ones not taken */
+void testVideoFrameMailbox(VLC::Instance& instance, const char* mediaPath)
+{
+    VLC::VideoFrameMailbox mailbox("RV32");
+    VLC::MediaPlayer mp(instance);
+    VLC::Media media(mediaPath, VLC::Media::FromPath);
+    mp.setMedia(media);
+    mailbox.attach(mp);
+    assert(!mailbox.latest().isValid());
+    assert(mp.play());
+
+    uint64_t last = 0;
+    unsigned int taken = 0;
+    auto deadline = std::chrono::steady_clock::now() + playbackDuration;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        auto frame = mailbox.latest();
+        if (!frame.isValid())
+            continue;
+        assert(frame.width() > 0 && frame.height() > 0);
+        assert(reinterpret_cast<uintptr_t>(frame.plane(0)) % 64 == 0);
+        /* the same frame is returned until a newer one is published */
+        auto again = mailbox.latest();
+        assert(again.sequence() >= frame.sequence());
+        assert(taken == 0 || frame.sequence() > last);
+        last = again.sequence();
+        ++taken;
+    }
+    mp.stopAsync();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    auto stats = mailbox.stats();
+    assert(taken > 0);
+    assert(stats.consumed >= taken);
+    assert(stats.overwritten > 0);
+    assert(stats.produced == stats.consumed + stats.overwritten + (mailbox.hasNewFrame() ? 1 : 0));
+}
+
+/* A VideoTimingProbe wrapped around plain video callbacks must measure the
+   lock hold time and the display pacing, against the track frame rate */
+void testVideoTimingProbe(VLC::Instance& instance, const char* mediaPath)
+{
+    const uint32_t width = 320;
+    const uint32_t height = 180;
+    std::vector<uint8_t> buffer(width * height * 4);
+    std::atomic<int> displayed{0};
+
+    VLC::VideoTimingProbe probe(std::chrono::seconds(4));
+    VLC::MediaPlayer mp(instance);
+    VLC::Media media(mediaPath, VLC::Media::FromPath);
+    mp.setMedia(media);
+    mp.setVideoFormat("RV32", width, height, width * 4);
+    probe.setVideoCallbacks(mp, [&](void** planes) -> void* {
+        planes[0] = buffer.data();
+        return nullptr;
+    }, nullptr, [&](void*) {
+        ++displayed;
+    });
+    assert(mp.play());
+    std::this_thread::sleep_for(playbackDuration / 2);
+
+    auto tracks = mp.tracks(VLC::MediaTrack::Type::Video, true);
+    assert(tracks.size() == 1);
+    probe.setFrameRate(tracks[0]);
+    std::this_thread::sleep_for(playbackDuration / 2);
+    mp.stopAsync();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    auto s = probe.snapshot();
+    assert(s.totalFrames == static_cast<uint64_t>(displayed.load()));
+    assert(s.frames > 1 && s.frames <= s.totalFrames);
+    assert(s.lockHold.count > 0);
+    assert(s.displayInterval.count > 0);
+    assert(s.frameDuration.count() > 0);
+    assert(s.jitter.count > 0);
+    assert(s.late <= s.totalLate && s.totalLate < s.totalFrames);
+    /* frames are displayed at the media rate, not as fast as decoded */
+    assert(s.displayInterval.percentile(50) >= s.frameDuration / 2);
+    assert(s.lockHold.percentile(50) <= s.lockHold.percentile(99));
+}
+
+/* A VideoFormat must produce aligned layouts, and the format callback must
+   make libvlc downscale the video to the requested box */
+void testVideoFormat(VLC::Instance& instance, const char* mediaPath)
+{
+    VLC::VideoFormat::Layout layout;
+    assert(VLC::VideoFormat("NV12").negotiate(1919, 1079, layout));
+    assert(layout.nbPlanes == 2);
+    assert(layout.pitches[0] == 1920 && layout.pitches[1] == 1920);
+    assert(layout.lines[0] == 1079 && layout.lines[1] == 540);
+    assert(VLC::VideoFormat("UYVY").setLinesAlignment(16).negotiate(101, 99, layout));
+    assert(layout.width == 102 && layout.pitches[0] == 256 && layout.lines[0] == 112);
+    /* anamorphic pictures are downscaled to square pixels */
+    assert(VLC::VideoFormat("RV32").setMaxSize(640, 0).setSar(4, 3).negotiate(720, 480, layout));
+    assert(layout.width == 640 && layout.height == 320);
+    assert(!VLC::VideoFormat::isSupported("ABCD"));
+
+    std::atomic<int> frames{0};
+    std::atomic<bool> valid{true};
+    auto format = VLC::VideoFormat("I420").setPitchAlignment(128).setMaxSize(160, 160);
+    VLC::VideoFrameSink sink(format, [&](VLC::VideoFrameSink::Frame&& frame) {
+        const auto& f = frame.format();
+        if (f.width > 160 || f.height > 160 || f.width % 2 != 0 ||
+            f.pitches[0] % 128 != 0 || f.pitches[1] % 128 != 0 ||
+            reinterpret_cast<uintptr_t>(frame.plane(1)) % 64 != 0)
+            valid = false;
+        ++frames;
+    });
+    VLC::MediaPlayer mp(instance);
+    VLC::Media media(mediaPath, VLC::Media::FromPath);
+    mp.setMedia(media);
+    sink.attach(mp);
+    assert(mp.play());
+    std::this_thread::sleep_for(playbackDuration / 2);
+    mp.stopAsync();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    assert(frames > 0);
+    assert(valid);
+}
+
 int main(int ac, char** av)
 {
     if (ac < 2)
@@ -195,6 +413,11 @@ int main(int ac, char** av)
     testBasicCallbacks(instance, av[1]);
     testCopyAssignSharesUnderlyingPlayer(instance, av[1]);
     testSharedCallbacksTwoPlayers(instance, av[1]);
+    testStatsSampler(instance, av[1]);
+    testVideoFrameSink(instance, av[1]);
+    testVideoFrameMailbox(instance, av[1]);
+    testVideoTimingProbe(instance, av[1]);
+    testVideoFormat(instance, av[1]);
 
     return 0;
 }
@@ -0,0 +1,126 @@
+/*****************************************************************************
+ * adaptive.cpp: AdaptiveParser test
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <cassert>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <file to parse>" << std::endl;
+        return 1;
+    }
+
+    const char* vlcArgs = "-vv";
+    auto instance = VLC::Instance(1, &vlcArgs);
+
+    VLC::AdaptiveParser::Tuning tuning;
+    tuning.interval = std::chrono::milliseconds(0);
+    tuning.minSamples = 2;
+    auto config = VLC::Parser::Config().setMaxParserThreads(4).setMaxThumbnailerThreads(2);
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    unsigned int parsed = 0;
+    unsigned int thumbnailed = 0;
+    const auto nbParse = 64u;
+    const auto nbThumbnails = 8u;
+    {
+        VLC::AdaptiveParser parser(instance, config, tuning);
+        // Starts with a single request in flight
+        assert(parser.limit(VLC::AdaptiveParser::Kind::Parse) == 1);
+        assert(parser.limit(VLC::AdaptiveParser::Kind::Thumbnail) == 1);
+
+        for (auto i = 0u; i < nbParse; ++i)
+        {
+            VLC::Media media(av[1], VLC::Media::FromPath);
+            parser.parse(media, [&](VLC::Media&, VLC::Parser::Status status) {
+                assert(status == VLC::Parser::Status::Done);
+                std::lock_guard<std::mutex> lock(mtx);
+                ++parsed;
+                cv.notify_all();
+            });
+        }
+        for (auto i = 0u; i < nbThumbnails; ++i)
+        {
+            VLC::Media media(av[1], VLC::Media::FromPath);
+            VLC::Parser::ThumbnailerRequest req(media);
+            req.setSize(160, 90, true)
+               .setPictureType(VLC::Picture::Type::Argb)
+               .setSeekPosition(i / 10., VLC::Parser::ThumbnailSeekSpeed::Fast);
+            parser.thumbnail(req, [&](VLC::Media&, const VLC::Picture& picture) {
+                assert(picture.isValid());
+                std::lock_guard<std::mutex> lock(mtx);
+                ++thumbnailed;
+                cv.notify_all();
+            });
+        }
+        // The media were released by the caller, but are held until
+        // dispatched
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&] { return parsed == nbParse && thumbnailed == nbThumbnails; });
+        }
+
+        auto parseLimit = parser.limit(VLC::AdaptiveParser::Kind::Parse);
+        assert(parseLimit >= 1 && parseLimit <= 4);
+        auto thumbnailLimit = parser.limit(VLC::AdaptiveParser::Kind::Thumbnail);
+        assert(thumbnailLimit >= 1 && thumbnailLimit <= 2);
+
+        auto decisions = parser.decisions();
+        assert(!decisions.empty());
+        for (const auto& d : decisions)
+        {
+            auto max = d.kind == VLC::AdaptiveParser::Kind::Parse ? 4u : 2u;
+            assert(d.limit >= 1 && d.limit <= max);
+            assert(d.throughput > 0);
+            switch (d.action)
+            {
+            case VLC::AdaptiveParser::Action::Increase:
+                assert(d.limit == d.previousLimit + 1);
+                break;
+            case VLC::AdaptiveParser::Action::Decrease:
+                assert(d.limit == std::max(d.previousLimit / 2, 1u));
+                break;
+            case VLC::AdaptiveParser::Action::Hold:
+                assert(d.limit == d.previousLimit);
+                break;
+            }
+        }
+        assert(parser.pending(VLC::AdaptiveParser::Kind::Parse) == 0);
+
+        // Requests still pending are cancelled on destruction
+        for (auto i = 0u; i < nbParse; ++i)
+        {
+            VLC::Media media(av[1], VLC::Media::FromPath);
+            parser.parse(media, [&](VLC::Media&, VLC::Parser::Status) {
+                std::lock_guard<std::mutex> lock(mtx);
+                ++parsed;
+            });
+        }
+    }
+    assert(parsed == 2 * nbParse);
+    return 0;
+}
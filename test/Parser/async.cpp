@@ -0,0 +1,84 @@
+/*****************************************************************************
+ * async.cpp: Parser::parseAsync/thumbnailAsync tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <file to parse>" << std::endl;
+        return 1;
+    }
+
+    const char* vlcArgs = "-vv";
+    auto instance = VLC::Instance(1, &vlcArgs);
+
+    VLC::Parser::Config cfg;
+    cfg.setMaxParserThreads(4);
+    VLC::Parser parser(instance, cfg);
+
+    /* a single request resolves to a complete result */
+    auto single = parser.parseAsync(VLC::Media(av[1], VLC::Media::FromPath),
+                                    VLC::Parser::ParseFlags::Parse);
+    assert(single.waitFor(std::chrono::seconds(5)));
+    const auto& result = single.get();
+    assert(result.status == VLC::Parser::Status::Done);
+    auto parsed = result.media;
+    assert(parsed.isValid());
+    assert(parsed.duration().count() > 0);
+    assert(result.picture.isValid() == false);
+
+    /* many requests can be awaited at once */
+    std::vector<VLC::Future<VLC::Parser::Result>> futures;
+    for (auto i = 0; i < 32; ++i)
+        futures.push_back(parser.parseAsync(VLC::Media(av[1], VLC::Media::FromPath)));
+    auto any = VLC::whenAny(futures);
+    auto all = VLC::whenAll(futures);
+    assert(all.waitFor(std::chrono::seconds(30)));
+    assert(any.isReady());
+    assert(any.get() < futures.size());
+    assert(all.get().size() == futures.size());
+    for (const auto& r : all.get())
+        assert(r.status == VLC::Parser::Status::Done);
+
+    /* an empty list is immediately ready */
+    assert(VLC::whenAll(std::vector<VLC::Future<int>>{}).isReady());
+
+    /* thumbnails carry the generated picture */
+    VLC::Media media(av[1], VLC::Media::FromPath);
+    VLC::Parser::ThumbnailerRequest thumbReq(media);
+    thumbReq.setSize(320, 0)
+            .setPictureType(VLC::Picture::Type::Argb)
+            .setSeekPosition(0.5, VLC::Parser::ThumbnailSeekSpeed::Fast);
+    auto thumb = parser.thumbnailAsync(thumbReq);
+    assert(thumb.waitFor(std::chrono::seconds(15)));
+    assert(thumb.get().status == VLC::Parser::Status::Done);
+    assert(thumb.get().picture.isValid());
+    assert(thumb.get().picture.width() == 320);
+    assert(thumb.get().media.isValid());
+
+    return 0;
+}
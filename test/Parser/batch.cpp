@@ -0,0 +1,106 @@
+/*****************************************************************************
+ * batch.cpp: ParseBatch tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+constexpr size_t window = 4;
+
+/* Every media of the batch gets parsed, without ever exceeding the window */
+void testBatch(VLC::Parser& parser, const char* mediaPath)
+{
+    VLC::ParseBatch batch(parser, window);
+    std::atomic<size_t> parsed{0};
+    std::atomic<size_t> progressReports{0};
+    batch.onProgress([&](const VLC::ParseBatch::Progress& p) {
+        assert(p.inFlight <= window);
+        ++progressReports;
+    }, std::chrono::milliseconds(0));
+
+    auto remaining = 50;
+    auto progress = batch.run([&](VLC::Media& media) {
+        if (remaining-- == 0)
+            return false;
+        media = VLC::Media(mediaPath, VLC::Media::FromPath);
+        return true;
+    }, [&](VLC::Media& media, VLC::Parser::Status status) {
+        assert(media.isValid());
+        assert(status == VLC::Parser::Status::Done);
+        assert(batch.progress().inFlight <= window);
+        ++parsed;
+    });
+
+    assert(parsed.load() == 50);
+    assert(progress.queued == 50);
+    assert(progress.completed == 50);
+    assert(progress.failed == 0);
+    assert(progress.inFlight == 0);
+    assert(progress.throughput > 0);
+    assert(progressReports.load() == 50);
+
+    /* iterator ranges are supported as well */
+    std::vector<VLC::Media> media;
+    for (auto i = 0; i < 8; ++i)
+        media.emplace_back(mediaPath, VLC::Media::FromPath);
+    progress = batch.run(begin(media), end(media), nullptr);
+    assert(progress.completed == media.size());
+}
+
+/* Cancelling an endless batch from its own callback stops it */
+void testCancel(VLC::Parser& parser, const char* mediaPath)
+{
+    VLC::ParseBatch batch(parser, window);
+    std::atomic<size_t> parsed{0};
+    auto progress = batch.run([&](VLC::Media& media) {
+        media = VLC::Media(mediaPath, VLC::Media::FromPath);
+        return true;
+    }, [&](VLC::Media&, VLC::Parser::Status) {
+        if (++parsed == 10)
+            batch.cancelAll();
+    });
+    assert(progress.completed >= 10);
+    assert(progress.completed == progress.queued);
+    assert(progress.inFlight == 0);
+}
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <file to parse>" << std::endl;
+        return 1;
+    }
+
+    const char* vlcArgs = "-vv";
+    auto instance = VLC::Instance(1, &vlcArgs);
+
+    VLC::Parser::Config cfg;
+    cfg.setMaxParserThreads(2);
+    VLC::Parser parser(instance, cfg);
+
+    testBatch(parser, av[1]);
+    testCancel(parser, av[1]);
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*****************************************************************************
+ * coalesce.cpp: RequestCoalescer test
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <file to thumbnail>" << std::endl;
+        return 1;
+    }
+
+    const char* vlcArgs = "-vv";
+    auto instance = VLC::Instance(1, &vlcArgs);
+
+    VLC::Parser parser(instance);
+    VLC::RequestCoalescer coalescer(parser);
+    VLC::Media media(av[1], VLC::Media::FromPath);
+
+    VLC::Parser::ThumbnailerRequest req(media);
+    req.setSize(320, 240, true)
+       .setPictureType(VLC::Picture::Type::Png)
+       .setSeekPosition(0.5, VLC::Parser::ThumbnailSeekSpeed::Precise);
+
+    std::vector<VLC::Future<VLC::Parser::Result>> futures;
+    for (auto i = 0; i < 4; ++i)
+        futures.push_back(coalescer.thumbnail(req));
+
+    // A different request isn't merged
+    VLC::Parser::ThumbnailerRequest otherReq(media);
+    otherReq.setSize(160, 120, true)
+            .setPictureType(VLC::Picture::Type::Png)
+            .setSeekPosition(0.5, VLC::Parser::ThumbnailSeekSpeed::Precise);
+    futures.push_back(coalescer.thumbnail(otherReq));
+
+    auto stats = coalescer.stats();
+    assert(stats.queued == 2);
+    assert(stats.coalesced == 3);
+
+    VLC::whenAll(futures).wait();
+    for (const auto& f : futures)
+        assert(f.get().status == VLC::Parser::Status::Done);
+    // The single result is shared by all the waiters
+    for (auto i = 1; i < 4; ++i)
+        assert(futures[i].get().picture == futures[0].get().picture);
+    assert(futures[4].get().picture != futures[0].get().picture);
+    assert(coalescer.stats().inFlight == 0);
+
+    // Finished requests are forgotten
+    auto parsed = coalescer.parse(media);
+    auto parsedAgain = coalescer.parse(media);
+    assert(parsed.get().status == VLC::Parser::Status::Done);
+    assert(parsedAgain.get().status == VLC::Parser::Status::Done);
+    stats = coalescer.stats();
+    assert(stats.queued == 3);
+    assert(stats.coalesced == 4);
+
+    // Parsing results live in the media instance, so another instance with
+    // the same MRL gets its own request
+    VLC::Media sameMrl(av[1], VLC::Media::FromPath);
+    auto parsedOther = coalescer.parse(sameMrl);
+    assert(parsedOther.get().status == VLC::Parser::Status::Done);
+    assert(parsedOther.get().media == sameMrl);
+    assert(sameMrl.isParsed());
+    assert(coalescer.stats().queued == 4);
+
+    auto thumbnailAgain = coalescer.thumbnail(req);
+    assert(thumbnailAgain.get().status == VLC::Parser::Status::Done);
+    assert(coalescer.stats().queued == 5);
+    return 0;
+}
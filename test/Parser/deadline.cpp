@@ -0,0 +1,95 @@
+/*****************************************************************************
+ * deadline.cpp: DeadlineParser tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <file to parse>" << std::endl;
+        return 1;
+    }
+
+    const char* vlcArgs = "-vv";
+    auto instance = VLC::Instance(1, &vlcArgs);
+
+    VLC::Parser parser(instance);
+    VLC::DeadlineParser deadlines(parser, std::chrono::milliseconds(1));
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool parsed = false;
+    bool thumbnailed = false;
+    VLC::DeadlineParser::Outcome parseOutcome;
+    VLC::DeadlineParser::Outcome thumbnailOutcome;
+
+    /* a generous budget doesn't get in the way */
+    VLC::Media media(av[1], VLC::Media::FromPath);
+    VLC::Parser::Request req(media);
+    req.setParseFlags(VLC::Parser::ParseFlags::Parse);
+    deadlines.queue(req, std::chrono::seconds(10),
+                    [&](VLC::Media&, VLC::DeadlineParser::Outcome outcome) {
+        std::lock_guard<std::mutex> lock(mutex);
+        parseOutcome = outcome;
+        parsed = true;
+        cond.notify_all();
+    });
+
+    /* a precise seek can't complete within a millisecond */
+    VLC::Media thumbMedia(av[1], VLC::Media::FromPath);
+    VLC::Parser::ThumbnailerRequest thumbReq(thumbMedia);
+    thumbReq.setSeekPosition(0.9, VLC::Parser::ThumbnailSeekSpeed::Precise);
+    deadlines.queueThumbnailing(thumbReq, std::chrono::milliseconds(1),
+                                [&](VLC::Media&, const VLC::Picture& picture,
+                                    VLC::DeadlineParser::Outcome outcome) {
+        assert(picture.isValid() == false);
+        std::lock_guard<std::mutex> lock(mutex);
+        thumbnailOutcome = outcome;
+        thumbnailed = true;
+        cond.notify_all();
+    });
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        assert(cond.wait_for(lock, std::chrono::seconds(15),
+                             [&] { return parsed && thumbnailed; }));
+    }
+    assert(parseOutcome == VLC::DeadlineParser::Outcome::Done);
+    assert(thumbnailOutcome == VLC::DeadlineParser::Outcome::DeadlineExceeded);
+
+    auto counters = deadlines.counters();
+    assert(counters.queued == 2);
+    assert(counters.done == 1);
+    assert(counters.deadlineExceeded == 1);
+    assert(counters.failed == 0 && counters.timeout == 0 && counters.cancelled == 0);
+    auto latencies = 0u;
+    for (auto l : counters.latency)
+        latencies += l;
+    assert(latencies == 1);
+
+    return 0;
+}
@@ -52,6 +52,7 @@ int main(int ac, char** av)
     std::mutex stateMutex;
     std::condition_variable stateCv;
     std::unique_ptr<VLC::Parser::TaskIdentifier> queuedTaskId;
+    VLC::ParsedMediaInfo info;
 
     VLC::Parser::Callbacks cbs([&](VLC::Parser::Task&& task, VLC::Parser::Status status) {
         std::lock_guard<std::mutex> lk(stateMutex);
@@ -59,6 +60,7 @@ int main(int ac, char** av)
         auto media = task.getMedia();
         assert(media.isValid());
         reportedDuration.store(media.duration().count());
+        info = VLC::ParsedMediaInfo(media);
         parserStatus = status;
         parsingFinished = true;
         stateCv.notify_all();
@@ -77,5 +79,83 @@ int main(int ac, char** av)
     assert(parserStatus == VLC::Parser::Status::Done);
     assert(reportedDuration.load() > 0);
 
+    /* the bulk meta snapshot must match the metas read one by one */
+    auto snapshot = media.metaSnapshot();
+    for (auto i = 0u; i < VLC::Media::MetaSnapshot::NbMetas; ++i)
+    {
+        auto meta = static_cast<libvlc_meta_t>(i);
+        assert(snapshot.get(meta) == media.meta(meta));
+        assert(snapshot.has(meta) == (snapshot.data(meta) != nullptr));
+    }
+
+    /* the parsed info snapshot must match the media accessors */
+    assert(info.isValid());
+    assert(info.duration() == media.duration());
+    assert(info.type() == media.type());
+    assert(info.mrl() == media.mrl());
+    auto nbTracks = 0u;
+    for (auto type : {VLC::MediaTrack::Audio, VLC::MediaTrack::Video, VLC::MediaTrack::Subtitle})
+    {
+        auto tracks = media.tracks(type);
+        auto infoTracks = info.tracks(type);
+        assert(infoTracks.size() == tracks.size());
+        for (auto i = 0u; i < tracks.size(); ++i)
+        {
+            assert(infoTracks[i].type == type);
+            assert(infoTracks[i].id == tracks[i].id());
+            assert(infoTracks[i].codec == tracks[i].codec());
+            assert(infoTracks[i].language == tracks[i].language());
+            if (type == VLC::MediaTrack::Video)
+            {
+                assert(infoTracks[i].width == tracks[i].width());
+                assert(infoTracks[i].height == tracks[i].height());
+            }
+        }
+        nbTracks += tracks.size();
+    }
+    assert(nbTracks > 0);
+    assert(info.tracks().size() == nbTracks);
+    assert(info.slaves().size() == media.slaves().size());
+    for (auto i = 0u; i < VLC::Media::MetaSnapshot::NbMetas; ++i)
+    {
+        auto meta = static_cast<libvlc_meta_t>(i);
+        auto value = info.meta(meta);
+        assert(value != nullptr ? value == media.meta(meta) : !snapshot.has(meta));
+    }
+
+    /* the user context of each request is handed back to the shared
+       callbacks, without waiting for queue() to return */
+    struct Context
+    {
+        VLC::Media media;
+        bool parsed;
+    };
+    Context contexts[2] = {
+        { VLC::Media(av[1], VLC::Media::FromPath), false },
+        { VLC::Media(av[1], VLC::Media::FromPath), false },
+    };
+    VLC::Parser::Callbacks ctxCbs([&](VLC::Parser::Task&& task, VLC::Parser::Status status,
+                                      void* context) {
+        auto ctx = static_cast<Context*>(context);
+        assert(ctx == &contexts[0] || ctx == &contexts[1]);
+        assert(status == VLC::Parser::Status::Done);
+        assert(task.getMedia() == ctx->media);
+        std::lock_guard<std::mutex> lk(stateMutex);
+        ctx->parsed = true;
+        stateCv.notify_all();
+    });
+    for (auto& ctx : contexts)
+    {
+        VLC::Parser::Request ctxReq(ctx.media);
+        ctxReq.setUserContext(&ctx);
+        parser.queue(ctxReq, ctxCbs);
+    }
+    {
+        std::unique_lock<std::mutex> lk(stateMutex);
+        assert(stateCv.wait_for(lk, std::chrono::seconds(5), [&] {
+            return contexts[0].parsed && contexts[1].parsed;
+        }));
+    }
+
     return 0;
 }
@@ -0,0 +1,141 @@
+/*****************************************************************************
+ * parsecache.cpp: ParseCache test
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static const char* cachePath = "parse-cache-test.bin";
+static const char* samplePath = "parse-cache-test-sample";
+
+static std::vector<char> readFile(const char* path)
+{
+    std::ifstream f(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const char* path, const char* data, size_t size)
+{
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(data, size);
+}
+
+static void parse(VLC::Parser& parser, VLC::Media& media)
+{
+    auto res = parser.parseAsync(media, VLC::Parser::ParseFlags::Parse |
+                                        VLC::Parser::ParseFlags::FetchLocal);
+    assert(res.get().status == VLC::Parser::Status::Done);
+}
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <file to parse>" << std::endl;
+        return 1;
+    }
+
+    const char* vlcArgs = "-vv";
+    auto instance = VLC::Instance(1, &vlcArgs);
+    VLC::Parser parser(instance);
+
+    // Work on a copy of the sample, so it can be modified
+    auto sample = readFile(av[1]);
+    assert(sample.empty() == false);
+    writeFile(samplePath, sample.data(), sample.size());
+    std::remove(cachePath);
+
+    {
+        VLC::ParseCache cache(cachePath);
+        assert(cache.size() == 0);
+
+        VLC::Media media(samplePath, VLC::Media::FromPath);
+        VLC::ParseCache::Entry entry;
+        assert(!cache.lookup(media, entry));
+        parse(parser, media);
+        assert(cache.store(media));
+        assert(cache.size() == 1);
+
+        // A hit is served without parsing the media
+        VLC::Media other(samplePath, VLC::Media::FromPath);
+        assert(cache.lookup(other, entry));
+        assert(!other.isParsed());
+        assert(entry.duration == media.duration());
+        assert(entry.type == media.type());
+        auto snapshot = media.metaSnapshot();
+        for (auto i = 0u; i < VLC::Media::MetaSnapshot::NbMetas; ++i)
+        {
+            auto meta = static_cast<libvlc_meta_t>(i);
+            assert(entry.meta.has(meta) == snapshot.has(meta));
+            assert(entry.meta.get(meta) == snapshot.get(meta));
+        }
+        assert(!entry.tracks.empty());
+        assert(cache.save());
+    }
+
+    // The entries survive a reload
+    {
+        VLC::ParseCache cache(cachePath);
+        assert(cache.size() == 1);
+        VLC::Media media(samplePath, VLC::Media::FromPath);
+        VLC::ParseCache::Entry reloaded;
+        assert(cache.lookup(media, reloaded));
+        assert(reloaded.duration.count() > 0);
+        assert(!reloaded.tracks.empty());
+    }
+
+    // A truncated or corrupted cache file is rejected
+    auto content = readFile(cachePath);
+    writeFile(cachePath, content.data(), content.size() - 1);
+    {
+        VLC::ParseCache cache(cachePath);
+        assert(cache.size() == 0);
+    }
+    content[0] ^= 0xff;
+    writeFile(cachePath, content.data(), content.size());
+    {
+        VLC::ParseCache cache(cachePath);
+        assert(cache.size() == 0);
+    }
+    content[0] ^= 0xff;
+    writeFile(cachePath, content.data(), content.size());
+
+    // Changing the file size invalidates its entry
+    sample.push_back(0);
+    writeFile(samplePath, sample.data(), sample.size());
+    {
+        VLC::ParseCache cache(cachePath);
+        assert(cache.size() == 1);
+        VLC::Media media(samplePath, VLC::Media::FromPath);
+        VLC::ParseCache::Entry entry;
+        assert(!cache.lookup(media, entry));
+        assert(cache.size() == 0);
+    }
+
+    std::remove(cachePath);
+    std::remove(samplePath);
+    return 0;
+}
@@ -0,0 +1,134 @@
+/*****************************************************************************
+ * perceptualhash.cpp: PerceptualHash & HammingIndex test
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+static void testIndex()
+{
+    std::mt19937_64 rng(42);
+    VLC::HammingIndex index;
+    std::vector<uint64_t> hashes;
+    for (auto i = 0u; i < 20000; ++i)
+    {
+        hashes.push_back(rng());
+        index.add(hashes.back(), i);
+    }
+    assert(index.size() == hashes.size());
+
+    for (auto radius : {0u, 3u, 5u, 10u, 24u})
+    {
+        for (auto q = 0u; q < 50; ++q)
+        {
+            // Flip a few bits of an indexed hash
+            auto query = hashes[q * 17];
+            for (auto b = 0u; b < q % 8; ++b)
+                query ^= uint64_t{1} << (rng() % 64);
+            auto matches = index.search(query, radius);
+            size_t expected = 0;
+            for (auto h : hashes)
+            {
+                if (VLC::HammingIndex::distance(h, query) <= radius)
+                    ++expected;
+            }
+            assert(matches.size() == expected);
+            for (auto i = 1u; i < matches.size(); ++i)
+                assert(matches[i - 1].distance <= matches[i].distance);
+            for (const auto& m : matches)
+                assert(VLC::HammingIndex::distance(hashes[m.id], query) == m.distance);
+        }
+    }
+
+    VLC::HammingIndex::Match match;
+    auto query = hashes[123] ^ 0x5;
+    assert(index.nearest(query, 10, match));
+    assert(match.id == 123);
+    assert(match.distance == 2);
+
+    // A radius larger than the hash size must not loop for long
+    assert(index.nearest(~query, std::numeric_limits<uint32_t>::max(), match));
+}
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <file to fingerprint>" << std::endl;
+        return 1;
+    }
+
+    testIndex();
+
+    assert(VLC::PerceptualHash::distance(0, ~uint64_t{0}) == 64);
+    assert(VLC::PerceptualHash::combine({0x3, 0x1, 0x6}) == 0x3);
+
+    const char* vlcArgs = "-vv";
+    auto instance = VLC::Instance(1, &vlcArgs);
+    VLC::Parser parser(instance, VLC::Parser::Config().setMaxThumbnailerThreads(2));
+    VLC::Media media(av[1], VLC::Media::FromPath);
+
+    // The same frame at different sizes hashes to close values
+    std::vector<VLC::Future<VLC::Parser::Result>> futures;
+    for (auto size : {64u, 256u})
+    {
+        VLC::Parser::ThumbnailerRequest req(media);
+        req.setSize(size, 0)
+           .setPictureType(VLC::Picture::Type::Argb)
+           .setSeekPosition(.5, VLC::Parser::ThumbnailSeekSpeed::Precise);
+        futures.push_back(parser.thumbnailAsync(req));
+    }
+    auto small = VLC::ImageView(futures[0].get().picture);
+    auto large = VLC::ImageView(futures[1].get().picture);
+    for (auto algo : {VLC::PerceptualHash::Algorithm::DHash, VLC::PerceptualHash::Algorithm::PHash})
+    {
+        auto h = VLC::PerceptualHash::hash(algo, small);
+        assert(h == VLC::PerceptualHash::hash(algo, small));
+        assert(VLC::PerceptualHash::distance(h, VLC::PerceptualHash::hash(algo, large)) <= 10);
+    }
+
+    auto a = VLC::PerceptualHash::fingerprint(parser, media, 4).get();
+    auto b = VLC::PerceptualHash::fingerprint(parser, media, 4).get();
+    assert(a.hashes.size() == 4);
+    assert(a.nbValid == 4);
+    assert(VLC::PerceptualHash::distance(a, b) <= 2);
+
+    VLC::HammingIndex index;
+    index.add(a.combined, 1);
+    VLC::HammingIndex::Match match;
+    assert(index.nearest(b.combined, 8, match));
+    assert(match.id == 1);
+
+    bool threw = false;
+    try
+    {
+        VLC::PerceptualHash::fingerprint(parser, media, 0);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    assert(threw);
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*****************************************************************************
+ * savepool.cpp: PictureSavePool test
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <string>
+
+static bool isPng(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    char signature[8];
+    in.read(signature, sizeof(signature));
+    return in.good() && signature[1] == 'P' && signature[2] == 'N' && signature[3] == 'G';
+}
+
+static VLC::Picture thumbnail(VLC::Parser& parser, VLC::Media& media, VLC::Picture::Type type)
+{
+    VLC::Parser::ThumbnailerRequest req(media);
+    req.setSize(160, 90, true)
+       .setPictureType(type)
+       .setSeekPosition(.5, VLC::Parser::ThumbnailSeekSpeed::Fast);
+    auto res = parser.thumbnailAsync(req).get();
+    assert(res.status == VLC::Parser::Status::Done);
+    return res.picture;
+}
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <file to thumbnail>" << std::endl;
+        return 1;
+    }
+
+    const char* vlcArgs = "-vv";
+    auto instance = VLC::Instance(1, &vlcArgs);
+    VLC::Parser parser(instance);
+    VLC::Media media(av[1], VLC::Media::FromPath);
+
+    auto argb = thumbnail(parser, media, VLC::Picture::Type::Argb);
+    auto png = thumbnail(parser, media, VLC::Picture::Type::Png);
+    size_t argbSize;
+    argb.buffer(&argbSize);
+
+    {
+        VLC::PictureSavePool pool(argbSize * 4, 2);
+        auto encoded = pool.save(argb, "savepool-argb.png", VLC::PictureSavePool::Format::Png);
+        auto native = pool.save(png, "savepool-native.png");
+        assert(encoded.get());
+        assert(native.get());
+        assert(isPng("savepool-argb.png"));
+        assert(isPng("savepool-native.png"));
+
+        // Failures are reported, not thrown
+        auto failed = pool.save(png, "/nonexistent/directory/thumbnail.png");
+        assert(failed.get() == false);
+        pool.flush();
+        auto stats = pool.stats();
+        assert(stats.saved == 2);
+        assert(stats.failed == 1);
+        assert(stats.pending == 0);
+        assert(stats.pendingBytes == 0);
+    }
+
+    {
+        // Block the single worker from the completion callback, so the
+        // queue fills up deterministically
+        VLC::PictureSavePool pool(argbSize, 1);
+        std::promise<void> gate;
+        auto gateFuture = gate.get_future().share();
+        std::promise<void> started;
+        assert(pool.trySave(argb, "savepool-1.png", [&](const std::string&, bool success) {
+            assert(success);
+            started.set_value();
+            gateFuture.wait();
+        }, VLC::PictureSavePool::Format::Png));
+        started.get_future().wait();
+
+        auto queued = pool.trySave(argb, "savepool-2.png", VLC::PictureSavePool::Format::Png);
+        assert(queued.isValid());
+        auto rejected = pool.trySave(argb, "savepool-3.png", VLC::PictureSavePool::Format::Png);
+        assert(rejected.isValid() == false);
+        assert(pool.stats().rejected == 1);
+        assert(pool.stats().pendingBytes == argbSize);
+
+        gate.set_value();
+        assert(queued.get());
+        pool.flush();
+        assert(pool.stats().saved == 2);
+    }
+
+    for (auto path : {"savepool-argb.png", "savepool-native.png", "savepool-1.png", "savepool-2.png"})
+        remove(path);
+    return 0;
+}
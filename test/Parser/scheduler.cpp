@@ -0,0 +1,102 @@
+/*****************************************************************************
+ * scheduler.cpp: ParserScheduler tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+constexpr int nbBulk = 40;
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <file to parse>" << std::endl;
+        return 1;
+    }
+
+    const char* vlcArgs = "-vv";
+    auto instance = VLC::Instance(1, &vlcArgs);
+
+    VLC::Parser::Config cfg;
+    cfg.setMaxParserThreads(1);
+    VLC::ParserScheduler scheduler(instance, cfg);
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<int> completions;
+
+    auto onParsed = [&](int id) {
+        return [&, id](VLC::Media& media, VLC::Parser::Status status) {
+            assert(media.isValid());
+            assert(status == (id == nbBulk - 2 ? VLC::Parser::Status::Cancelled
+                                               : VLC::Parser::Status::Done));
+            /* never more requests in flight than parser threads */
+            assert(scheduler.inFlight() <= 1);
+            std::lock_guard<std::mutex> lock(mutex);
+            completions.push_back(id);
+            cond.notify_all();
+        };
+    };
+
+    std::vector<VLC::ParserScheduler::Ticket> tickets;
+    for (auto i = 0; i < nbBulk; ++i)
+        tickets.push_back(scheduler.submit(VLC::Media(av[1], VLC::Media::FromPath),
+                                           VLC::ParserScheduler::Priority::Bulk,
+                                           onParsed(i)));
+    /* an interactive request preempts the queued bulk ones, and so does a
+       promoted bulk request */
+    scheduler.submit(VLC::Media(av[1], VLC::Media::FromPath),
+                     VLC::ParserScheduler::Priority::Interactive, onParsed(-1));
+    assert(scheduler.promote(tickets.back()));
+
+    /* cancelled requests are reported right away */
+    assert(scheduler.cancel(tickets[nbBulk - 2]) == true);
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        assert(cond.wait_for(lock, std::chrono::seconds(60), [&] {
+            return completions.size() == nbBulk + 1;
+        }));
+    }
+
+    /* the cancellation was reported before anything else could finish */
+    auto it = std::find(begin(completions), end(completions), nbBulk - 2);
+    assert(it - begin(completions) <= 1);
+    it = std::find(begin(completions), end(completions), -1);
+    assert(it - begin(completions) <= 3);
+    it = std::find(begin(completions), end(completions), nbBulk - 1);
+    assert(it - begin(completions) <= 4);
+
+    auto interactive = scheduler.stats(VLC::ParserScheduler::Priority::Interactive);
+    auto bulk = scheduler.stats(VLC::ParserScheduler::Priority::Bulk);
+    assert(interactive.pending == 0 && bulk.pending == 0);
+    assert(interactive.dispatched == 2);
+    assert(bulk.dispatched == nbBulk - 2);
+    assert(bulk.maxWait > interactive.maxWait);
+
+    return 0;
+}
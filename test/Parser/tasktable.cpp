@@ -0,0 +1,129 @@
+/*****************************************************************************
+ * tasktable.cpp: ParserTaskTable tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+constexpr uint32_t nbTasks = 16;
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <file to parse>" << std::endl;
+        return 1;
+    }
+
+    const char* vlcArgs = "-vv";
+    auto instance = VLC::Instance(1, &vlcArgs);
+
+    VLC::Parser parser(instance);
+    for (auto capacity : {0u, std::numeric_limits<uint32_t>::max()})
+    {
+        bool threw = false;
+        try
+        {
+            VLC::ParserTaskTable invalid(parser, capacity);
+        }
+        catch (const std::invalid_argument&)
+        {
+            threw = true;
+        }
+        assert(threw);
+    }
+    VLC::ParserTaskTable table(parser, nbTasks);
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    unsigned int done = 0;
+    unsigned int cancelled = 0;
+    VLC::Parser::Callbacks cbs([&](VLC::Parser::Task&&, VLC::Parser::Status status) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (status == VLC::Parser::Status::Cancelled)
+            ++cancelled;
+        else if (status == VLC::Parser::Status::Done)
+            ++done;
+        cond.notify_all();
+    });
+
+    auto queueAll = [&](std::vector<VLC::ParserTaskTable::Id>& ids) {
+        std::vector<VLC::Media> media;
+        for (auto i = 0u; i < nbTasks; ++i)
+        {
+            media.emplace_back(av[1], VLC::Media::FromPath);
+            VLC::Parser::Request req(media.back());
+            ids.push_back(table.queue(req, cbs, i % 2));
+        }
+    };
+    auto waitFor = [&](unsigned int count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        assert(cond.wait_for(lock, std::chrono::seconds(30),
+                             [&] { return done + cancelled == count; }));
+    };
+
+    /* once finished, ids are stale and cancelling them is a no-op */
+    std::vector<VLC::ParserTaskTable::Id> ids;
+    queueAll(ids);
+    waitFor(nbTasks);
+    assert(done == nbTasks);
+    assert(table.size() == 0);
+    for (const auto& id : ids)
+    {
+        assert(table.isRunning(id) == false);
+        assert(table.cancel(id) == false);
+    }
+
+    /* the table is bounded, unless a task already finished */
+    std::vector<VLC::ParserTaskTable::Id> reused;
+    queueAll(reused);
+    bool full = false;
+    try
+    {
+        VLC::Media media(av[1], VLC::Media::FromPath);
+        VLC::Parser::Request req(media);
+        table.queue(req, cbs);
+    }
+    catch (const std::runtime_error&)
+    {
+        full = true;
+    }
+
+    /* slots are reused with a new generation */
+    for (auto i = 0u; i < nbTasks; ++i)
+        assert(reused[i] != ids[i]);
+
+    /* cancel a whole group: the single parser thread can't have finished
+       all of its tasks yet */
+    auto nbCancelled = table.cancelGroup(1);
+    assert(nbCancelled > 0);
+    waitFor(2 * nbTasks + (full ? 0 : 1));
+    assert(cancelled == nbCancelled);
+    assert(table.size() == 0);
+
+    return 0;
+}
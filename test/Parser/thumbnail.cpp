@@ -25,6 +25,7 @@
 #include <condition_variable>
 #include <cstdio>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <utility>
@@ -94,5 +95,39 @@ int main(int ac, char** av)
         std::remove(outPath);
     }
 
+    /* a raw thumbnail can be viewed, row by row, without copying its pixels */
+    VLC::Parser::ThumbnailerRequest argbReq(media);
+    argbReq.setSize(64, 48, true)
+           .setPictureType(VLC::Picture::Type::Argb)
+           .setSeekPosition(0.5, VLC::Parser::ThumbnailSeekSpeed::Fast);
+    auto result = parser.thumbnailAsync(argbReq).get();
+    assert(result.status == VLC::Parser::Status::Done);
+    VLC::ImageView view(result.picture);
+    result = VLC::Parser::Result{};
+    /* the view keeps the picture alive */
+    assert(view.picture().isValid());
+    assert(view.width() == 64 && view.height() == 48);
+    assert(view.stride() >= view.rowBytes());
+    assert(std::distance(view.begin(), view.end()) == 48);
+    auto rowIndex = 0u;
+    for (auto row : view)
+        assert(row == view.data() + rowIndex++ * view.stride());
+
+    auto region = view.subview(8, 4, 16, 10);
+    assert(region.width() == 16 && region.height() == 10);
+    assert(region.stride() == view.stride());
+    assert(region.row(0) == view.pixel(8, 4));
+    assert(*(region.begin() + 9) == view.pixel(8, 13));
+    bool outOfRange = false;
+    try
+    {
+        view.subview(60, 0, 8, 8);
+    }
+    catch (const std::out_of_range&)
+    {
+        outOfRange = true;
+    }
+    assert(outOfRange);
+
     return 0;
 }
@@ -0,0 +1,129 @@
+/*****************************************************************************
+ * thumbnailcache.cpp: ThumbnailCache test
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <cassert>
+#include <condition_variable>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+
+static const char* cacheDir = "thumbnail-cache-test";
+
+static void cleanup()
+{
+    for (auto i = 0; i < 256; ++i)
+    {
+        char shard[8];
+        snprintf(shard, sizeof(shard), "/%02x", i);
+        std::remove((std::string(cacheDir) + shard).c_str());
+    }
+    std::remove(cacheDir);
+}
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <file to thumbnail>" << std::endl;
+        return 1;
+    }
+
+    const char* vlcArgs = "-vv";
+    auto instance = VLC::Instance(1, &vlcArgs);
+
+    VLC::Parser parser(instance);
+    VLC::Media media(av[1], VLC::Media::FromPath);
+    VLC::Parser::ThumbnailerRequest req(media);
+    req.setSize(320, 240, true)
+       .setPictureType(VLC::Picture::Type::Png)
+       .setSeekPosition(0.5, VLC::Parser::ThumbnailSeekSpeed::Fast);
+
+    size_t generatedSize = 0;
+    {
+        VLC::ThumbnailCache cache(parser, cacheDir, 16 * 1024 * 1024);
+        cache.clear();
+
+        std::mutex mtx;
+        std::condition_variable cv;
+        bool done = false;
+        auto hit = cache.queueThumbnailing(req, [&](VLC::Media&, const VLC::ThumbnailCache::Image& image) {
+            assert(image.isValid());
+            assert(image.type() == VLC::Picture::Type::Png);
+            image.buffer(&generatedSize);
+            std::lock_guard<std::mutex> lock(mtx);
+            done = true;
+            cv.notify_all();
+        });
+        assert(!hit);
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&done] { return done; });
+        }
+        assert(generatedSize > 0);
+
+        // Served synchronously, without the thumbnailer
+        bool called = false;
+        hit = cache.queueThumbnailing(req, [&](VLC::Media&, const VLC::ThumbnailCache::Image& image) {
+            size_t size;
+            image.buffer(&size);
+            assert(size == generatedSize);
+            called = true;
+        });
+        assert(hit && called);
+
+        // A different request is a different entry
+        VLC::Parser::ThumbnailerRequest otherReq(media);
+        otherReq.setSize(160, 120, true)
+                .setPictureType(VLC::Picture::Type::Png)
+                .setSeekPosition(0.5, VLC::Parser::ThumbnailSeekSpeed::Fast);
+        VLC::ThumbnailCache::Image image;
+        assert(!cache.lookup(otherReq, image));
+
+        auto stats = cache.stats();
+        assert(stats.hits == 1);
+        assert(stats.misses == 2);
+        assert(stats.stores == 1);
+        assert(stats.entries == 1);
+        assert(stats.bytesSaved == generatedSize);
+    }
+
+    // The entry survives a restart
+    {
+        VLC::ThumbnailCache cache(parser, cacheDir, 16 * 1024 * 1024);
+        VLC::ThumbnailCache::Image image;
+        assert(cache.lookup(req, image));
+        assert(image.width() > 0 && image.height() > 0);
+        assert(cache.stats().hitRatio() == 1.);
+    }
+
+    // The size cap is enforced when loading
+    {
+        VLC::ThumbnailCache cache(parser, cacheDir, 1);
+        auto stats = cache.stats();
+        assert(stats.entries == 0);
+        assert(stats.bytes == 0);
+        assert(stats.evictions == 1);
+    }
+
+    cleanup();
+    return 0;
+}
@@ -0,0 +1,103 @@
+/*****************************************************************************
+ * timeline.cpp: TimelinePreview test
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <file to preview>" << std::endl;
+        return 1;
+    }
+
+    const char* vlcArgs = "-vv";
+    auto instance = VLC::Instance(1, &vlcArgs);
+
+    VLC::Parser parser(instance, VLC::Parser::Config().setMaxThumbnailerThreads(2));
+    VLC::Media media(av[1], VLC::Media::FromPath);
+
+    VLC::TimelinePreview preview(12, 64, 36, 5);
+    assert(preview.width() == 5 * 64);
+    assert(preview.height() == 3 * 36);
+    assert(preview.atlas().size() == preview.width() * preview.height() * 4u);
+
+    auto report = preview.generate(parser, media);
+    assert(report.failed == 0);
+    assert(report.minLatency <= report.averageLatency);
+    assert(report.averageLatency <= report.maxLatency);
+
+    const auto& tiles = preview.tiles();
+    assert(tiles.size() == 12);
+    for (auto i = 0u; i < tiles.size(); ++i)
+    {
+        assert(tiles[i].valid);
+        assert(tiles[i].x == (i % 5) * 64);
+        assert(tiles[i].y == (i / 5) * 36);
+        if (i > 0)
+            assert(tiles[i].position > tiles[i - 1].position);
+    }
+
+    // The last tile of the last row isn't used, and stays transparent
+    const auto& atlas = preview.atlas();
+    assert(atlas[(preview.height() - 1) * preview.width() * 4 + (preview.width() - 1) * 4] == 0);
+
+    auto duration = std::chrono::microseconds{std::chrono::seconds{60}};
+    assert(preview.tileAt(std::chrono::microseconds{0}, duration) == 0);
+    assert(preview.tileAt(duration / 2, duration) == 6);
+    assert(preview.tileAt(duration * 2, duration) == 11);
+
+    assert(preview.saveAtlas("timeline-test.png"));
+    {
+        std::ifstream in("timeline-test.png", std::ios::binary);
+        char signature[8];
+        in.read(signature, sizeof(signature));
+        assert(in.good());
+        assert(signature[1] == 'P' && signature[2] == 'N' && signature[3] == 'G');
+    }
+    assert(preview.saveIndex("timeline-test.vtt", "timeline-test.png", duration));
+    {
+        std::ifstream in("timeline-test.vtt");
+        std::string line;
+        std::getline(in, line);
+        assert(line == "WEBVTT");
+        std::getline(in, line);
+        std::getline(in, line);
+        assert(line == "00:00:00.000 --> 00:00:05.000");
+        std::getline(in, line);
+        assert(line == "timeline-test.png#xywh=0,0,64,36");
+    }
+    std::remove("timeline-test.png");
+    std::remove("timeline-test.vtt");
+
+    // A new generation doesn't report the previous tiles
+    VLC::Media missing("timeline-test-missing-file", VLC::Media::FromPath);
+    report = preview.generate(parser, missing);
+    assert(report.failed == tiles.size());
+    for (const auto& t : tiles)
+        assert(!t.valid);
+    return 0;
+}
@@ -0,0 +1,107 @@
+/*****************************************************************************
+ * treescanner.cpp: TreeScanner test
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+static void copyFile(const std::string& src, const std::string& dst)
+{
+    std::ifstream in(src, std::ios::binary);
+    std::ofstream out(dst, std::ios::binary);
+    out << in.rdbuf();
+}
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <file to parse>" << std::endl;
+        return 1;
+    }
+
+    /* tree/
+         0.mp4
+         a/1.mp4
+         b/c/2.mp4 */
+    char cwd[4096];
+    assert(getcwd(cwd, sizeof(cwd)) != nullptr);
+    auto root = std::string(cwd) + "/treescanner-test";
+    mkdir(root.c_str(), 0755);
+    mkdir((root + "/a").c_str(), 0755);
+    mkdir((root + "/b").c_str(), 0755);
+    mkdir((root + "/b/c").c_str(), 0755);
+    const std::string files[] = { root + "/0.mp4", root + "/a/1.mp4", root + "/b/c/2.mp4" };
+    for (const auto& f : files)
+        copyFile(av[1], f);
+
+    const char* vlcArgs = "-vv";
+    auto instance = VLC::Instance(1, &vlcArgs);
+    VLC::Parser parser(instance, VLC::Parser::Config().setMaxParserThreads(2));
+
+    std::mutex mtx;
+    std::set<std::string> parsedFiles;
+    unsigned int directories = 0;
+    VLC::TreeScanner scanner(parser, 2, 3);
+    std::vector<VLC::Media> roots = { VLC::Media(root, VLC::Media::FromPath) };
+    auto stats = scanner.run(roots, [&](const VLC::TreeScanner::Entry& entry) {
+        assert(entry.status == VLC::Parser::Status::Done);
+        assert(entry.info.isValid());
+        std::lock_guard<std::mutex> lock(mtx);
+        if (entry.info.type() == VLC::Media::Type::Directory)
+            ++directories;
+        else
+        {
+            assert(entry.info.duration().count() > 0);
+            parsedFiles.insert(entry.info.mrl());
+        }
+    });
+
+    assert(parsedFiles.size() == 3);
+    assert(directories == 4);
+    assert(stats.parsed == 7);
+    assert(stats.failed == 0);
+    assert(stats.expanded == 4);
+    assert(stats.maxDepth == 3);
+
+    /* the depth limit stops the recursion */
+    VLC::TreeScanner shallow(parser, 2, 1, VLC::Parser::ParseFlags::Parse, 1);
+    stats = shallow.run(roots, nullptr);
+    // root, 0.mp4, a, b
+    assert(stats.parsed == 4);
+    assert(stats.maxDepth == 1);
+
+    for (const auto& f : files)
+        std::remove(f.c_str());
+    rmdir((root + "/b/c").c_str());
+    rmdir((root + "/b").c_str());
+    rmdir((root + "/a").c_str());
+    rmdir(root.c_str());
+    return 0;
+}
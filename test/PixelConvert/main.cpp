@@ -0,0 +1,190 @@
+/*****************************************************************************
+ * main.cpp: PixelConvert tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using Isa = VLC::PixelConvert::Isa;
+using Layout = VLC::PixelConvert::Layout;
+
+/* Every implementation supported by the CPU, scalar excepted */
+static std::vector<Isa> vectorIsas()
+{
+    std::vector<Isa> res;
+    for (auto isa : {Isa::Sse2, Isa::Avx2})
+    {
+        if (VLC::PixelConvert::resolve(isa) == isa)
+            res.push_back(isa);
+    }
+    return res;
+}
+
+static std::vector<uint8_t> randomBuffer(std::mt19937& rng, size_t size)
+{
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<uint8_t> buffer(size);
+    for (auto& b : buffer)
+        b = static_cast<uint8_t>(dist(rng));
+    return buffer;
+}
+
+/* Sizes around the vector widths, with padded rows */
+static const uint32_t widths[] = {1, 2, 3, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 130};
+static const uint32_t heights[] = {1, 2, 3, 6};
+static const uint32_t padding = 12;
+
+static void testKnownValues()
+{
+    const uint8_t argb[] = {0x10, 0x20, 0x30, 0x40};
+    const uint8_t rgba[] = {0x20, 0x30, 0x40, 0x10};
+    uint8_t out[4];
+    VLC::PixelConvert::toBgra(Layout::Argb, argb, 4, out, 4, 1, 1, Isa::Scalar);
+    assert(out[0] == 0x40 && out[1] == 0x30 && out[2] == 0x20 && out[3] == 0x10);
+    VLC::PixelConvert::toBgra(Layout::Rgba, rgba, 4, out, 4, 1, 1, Isa::Scalar);
+    assert(out[0] == 0x40 && out[1] == 0x30 && out[2] == 0x20 && out[3] == 0x10);
+    VLC::PixelConvert::toBgra(Layout::Xrgb, argb, 4, out, 4, 1, 1, Isa::Scalar);
+    assert(out[3] == 0xff);
+
+    const uint8_t white[] = {0xff, 0xff, 0xff, 0xff};
+    const uint8_t black[] = {0xff, 0, 0, 0};
+    uint8_t gray;
+    VLC::PixelConvert::toGray(Layout::Argb, white, 4, &gray, 1, 1, 1, Isa::Scalar);
+    assert(gray == 255);
+    VLC::PixelConvert::toGray(Layout::Argb, black, 4, &gray, 1, 1, 1, Isa::Scalar);
+    assert(gray == 0);
+
+    /* Limited range extremes */
+    const uint8_t y[] = {235, 16};
+    const uint8_t c = 128;
+    uint8_t bgra[8];
+    VLC::PixelConvert::i420ToBgra(y, 2, &c, 1, &c, 1, bgra, 8, 2, 1, Isa::Scalar);
+    for (auto i = 0; i < 4; ++i)
+    {
+        assert(bgra[i] == 255);
+        assert(bgra[4 + i] == (i == 3 ? 255 : 0));
+    }
+
+    const uint8_t block[] = {1, 2, 3, 5};
+    uint8_t avg;
+    VLC::PixelConvert::downscale(block, 2, &avg, 1, 2, 2, 1, Isa::Scalar);
+    assert(avg == 3);
+
+    bool threw = false;
+    try
+    {
+        VLC::PixelConvert::downscale(block, 2, &avg, 1, 2, 2, 3);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    assert(threw == true);
+}
+
+static void testRgbConversions(std::mt19937& rng, Isa isa)
+{
+    for (auto layout : {Layout::Argb, Layout::Rgba, Layout::Xrgb, Layout::Bgra})
+    {
+        for (auto w : widths)
+        {
+            for (auto h : heights)
+            {
+                auto pitch = w * 4 + padding;
+                auto src = randomBuffer(rng, pitch * h);
+                std::vector<uint8_t> expected(w * 4 * h), actual(w * 4 * h);
+                VLC::PixelConvert::toBgra(layout, src.data(), pitch, expected.data(), w * 4, w, h, Isa::Scalar);
+                VLC::PixelConvert::toBgra(layout, src.data(), pitch, actual.data(), w * 4, w, h, isa);
+                assert(expected == actual);
+
+                std::vector<uint8_t> expectedGray(w * h), actualGray(w * h);
+                VLC::PixelConvert::toGray(layout, src.data(), pitch, expectedGray.data(), w, w, h, Isa::Scalar);
+                VLC::PixelConvert::toGray(layout, src.data(), pitch, actualGray.data(), w, w, h, isa);
+                assert(expectedGray == actualGray);
+            }
+        }
+    }
+}
+
+static void testI420(std::mt19937& rng, Isa isa)
+{
+    for (auto w : widths)
+    {
+        for (auto h : heights)
+        {
+            auto cw = (w + 1) / 2;
+            auto ch = (h + 1) / 2;
+            auto yPitch = w + padding;
+            auto cPitch = cw + padding;
+            auto y = randomBuffer(rng, yPitch * h);
+            auto u = randomBuffer(rng, cPitch * ch);
+            auto v = randomBuffer(rng, cPitch * ch);
+            std::vector<uint8_t> expected(w * 4 * h), actual(w * 4 * h);
+            VLC::PixelConvert::i420ToBgra(y.data(), yPitch, u.data(), cPitch, v.data(), cPitch,
+                                          expected.data(), w * 4, w, h, Isa::Scalar);
+            VLC::PixelConvert::i420ToBgra(y.data(), yPitch, u.data(), cPitch, v.data(), cPitch,
+                                          actual.data(), w * 4, w, h, isa);
+            assert(expected == actual);
+        }
+    }
+}
+
+static void testDownscale(std::mt19937& rng, Isa isa)
+{
+    for (auto bpp : {1u, 4u})
+    {
+        for (auto w : widths)
+        {
+            for (auto h : heights)
+            {
+                auto pitch = w * bpp + padding;
+                auto src = randomBuffer(rng, pitch * h);
+                auto outPitch = w / 2 * bpp;
+                std::vector<uint8_t> expected(outPitch * (h / 2)), actual(outPitch * (h / 2));
+                VLC::PixelConvert::downscale(src.data(), pitch, expected.data(), outPitch, w, h, bpp, Isa::Scalar);
+                VLC::PixelConvert::downscale(src.data(), pitch, actual.data(), outPitch, w, h, bpp, isa);
+                assert(expected == actual);
+            }
+        }
+    }
+}
+
+int main(int, char**)
+{
+    testKnownValues();
+
+    std::mt19937 rng(42);
+    auto isas = vectorIsas();
+    for (auto isa : isas)
+    {
+        std::cout << "Checking " << (isa == Isa::Avx2 ? "AVX2" : "SSE2")
+                  << " kernels against the scalar ones" << std::endl;
+        testRgbConversions(rng, isa);
+        testI420(rng, isa);
+        testDownscale(rng, isa);
+    }
+    if (isas.empty() == true)
+        std::cout << "No vector implementation supported" << std::endl;
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*****************************************************************************
+ * main.cpp: SharedFrameSink & SharedFrameConsumer test
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/SharedFrameRing.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+constexpr uint32_t width = 320;
+constexpr uint32_t height = 180;
+
+/* Runs in the child process: read frames until the sink is destroyed */
+static int consume(int fd)
+{
+    VLC::SharedFrameConsumer consumer(fd);
+    if (consumer.format().width != width || consumer.format().height != height ||
+        consumer.format().nbPlanes != 3)
+        return 2;
+
+    VLC::SharedFrameConsumer::Frame frame;
+    uint64_t nbFrames = 0;
+    uint64_t lastSequence = 0;
+    int64_t lastPts = 0;
+    bool varying = false;
+    while (true)
+    {
+        auto status = consumer.next(frame, std::chrono::seconds(10));
+        if (status == VLC::SharedFrameConsumer::Status::Closed)
+            break;
+        if (status != VLC::SharedFrameConsumer::Status::Ready)
+            return 3;
+        if (frame.sequence() <= lastSequence || frame.pts() < lastPts)
+            return 4;
+        lastSequence = frame.sequence();
+        lastPts = frame.pts();
+        /* the luma plane holds an actual picture */
+        auto luma = frame.plane(0);
+        for (auto x = 1u; x < width && !varying; ++x)
+            varying = luma[(height / 2) * frame.pitch(0) + x] != luma[(height / 2) * frame.pitch(0)];
+        ++nbFrames;
+    }
+    frame.reset();
+    std::cout << "Consumer read " << nbFrames << " frames, skipped "
+              << consumer.skipped() << std::endl;
+    return nbFrames > 0 && varying ? 0 : 5;
+}
+
+int main(int ac, char** av)
+{
+    if (ac < 2)
+    {
+        std::cerr << "usage: " << av[0] << " <file to play>" << std::endl;
+        return 1;
+    }
+
+    bool threw = false;
+    try
+    {
+        VLC::SharedFrameSink invalid("XXXX", width, height);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    /* a ring whose layout points out of the mapping is rejected */
+    {
+        VLC::SharedFrameSink corrupted("I420", width, height);
+        auto size = static_cast<size_t>(lseek(corrupted.fd(), 0, SEEK_END));
+        auto base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, corrupted.fd(), 0);
+        assert(base != MAP_FAILED);
+        auto header = static_cast<VLC::detail::ring::Header*>(base);
+        auto rejected = [&corrupted] {
+            try
+            {
+                VLC::SharedFrameConsumer consumer(corrupted.fd());
+            }
+            catch (const std::runtime_error&)
+            {
+                return true;
+            }
+            return false;
+        };
+        assert(!rejected());
+        auto planeOffset = header->planeOffsets[2];
+        header->planeOffsets[2] = static_cast<uint32_t>(header->slotSize);
+        assert(rejected());
+        header->planeOffsets[2] = planeOffset;
+        header->descriptorsOffset = size - sizeof(VLC::detail::ring::Descriptor);
+        assert(rejected());
+        munmap(base, size);
+    }
+
+    std::unique_ptr<VLC::SharedFrameSink> sink(new VLC::SharedFrameSink("I420", width, height, 4));
+
+    /* fork before libvlc starts any thread */
+    auto pid = fork();
+    assert(pid >= 0);
+    if (pid == 0)
+        _exit(consume(sink->fd()));
+
+    {
+        const char* vlcArgs = "-vv";
+        auto instance = VLC::Instance(1, &vlcArgs);
+        VLC::MediaPlayer mp(instance);
+        VLC::Media media(av[1], VLC::Media::FromPath);
+        mp.setMedia(media);
+        sink->attach(mp);
+        assert(mp.play());
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+        mp.stopAsync();
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+
+    auto stats = sink->stats();
+    assert(stats.published > 0);
+    /* the consumer only holds one frame at a time */
+    assert(stats.dropped == 0);
+
+    /* destroying the sink closes the ring for the consumer */
+    sink.reset();
+    int status;
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    return 0;
+}
@@ -0,0 +1,438 @@
+/*****************************************************************************
+ * AdaptiveParser.hpp: Adaptive concurrency for Parser requests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_ADAPTIVEPARSER_HPP
+#define LIBVLC_CXX_ADAPTIVEPARSER_HPP
+
+#include "Instance.hpp"
+#include "Media.hpp"
+#include "Picture.hpp"
+#include "Parser.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace VLC
+{
+
+///
+/// \brief The AdaptiveParser class tunes the number of concurrent parser and
+/// thumbnailer requests to the storage the media are read from.
+///
+/// The parser is created with the configured maximum number of threads, but
+/// the AdaptiveParser only hands libvlc as many requests as its current
+/// limit allows, and keeps the others queued. The limit is adjusted with an
+/// additive increase, multiplicative decrease controller: after each
+/// measurement window, the limit grows by one while the throughput keeps up
+/// and the request latency stays close to the best one observed, and is
+/// halved as soon as the latency degrades, or the throughput drops, which
+/// is what happens once a spinning disk or a network mount starts seeking
+/// between too many files.
+///
+/// Parse and thumbnailer requests run on distinct libvlc thread pools, and
+/// are controlled independently. Every decision is recorded, see decisions().
+///
+class AdaptiveParser
+{
+public:
+    enum class Kind
+    {
+        Parse,
+        Thumbnail,
+    };
+
+    static constexpr size_t NbKinds = 2;
+
+    enum class Action
+    {
+        Increase,
+        Decrease,
+        Hold,
+    };
+
+    ///
+    /// \brief A controller decision, taken at the end of a measurement window
+    ///
+    struct Decision
+    {
+        std::chrono::steady_clock::time_point time;
+        Kind kind;
+        Action action;
+        unsigned int previousLimit;
+        unsigned int limit;
+        /// Completed requests per second during the window
+        double throughput;
+        /// Average time between dispatching a request to libvlc and its
+        /// completion during the window
+        std::chrono::microseconds latency;
+    };
+
+    struct Tuning
+    {
+        Tuning()
+            : interval( 500 )
+            , minSamples( 4 )
+            , latencyTolerance( 1.5 )
+            , throughputTolerance( 0.1 )
+            , maxDecisions( 1024 )
+        {
+        }
+
+        /// Minimum measurement window duration
+        std::chrono::milliseconds interval;
+        /// Minimum number of completions in a measurement window
+        unsigned int minSamples;
+        /// The window latency is considered degraded past this factor of
+        /// the best latency observed
+        double latencyTolerance;
+        /// The throughput is considered dropping past this fraction of
+        /// the previous window throughput
+        double throughputTolerance;
+        /// Number of decisions kept, the oldest ones are discarded
+        size_t maxDecisions;
+    };
+
+    using OnParsed = std::function<void(Media&, Parser::Status)>;
+    /**
+     * Thumbnailer completion prototype. The picture is invalid if the
+     * request failed.
+     */
+    using OnThumbnailed = std::function<void(Media&, const Picture&)>;
+
+    /**
+     * \param instance The VLC instance
+     * \param config The parser configuration. Its maximum parser and
+     * thumbnailer threads are the upper bounds of the concurrency limits.
+     * \param tuning The controller parameters
+     */
+    AdaptiveParser( const Instance& instance, const Parser::Config& config = Parser::Config(),
+                    const Tuning& tuning = Tuning() )
+        : m_parser( instance, config )
+        , m_tuning( tuning )
+        , m_cbs( [this]( Parser::Task&&, Parser::Status status, void* context ) {
+            complete( std::unique_ptr<Item>( static_cast<Item*>( context ) ), status, nullptr );
+        } )
+        , m_thumbnailerCbs( [this]( Parser::Task&&, const Picture& picture, void* context ) {
+            complete( std::unique_ptr<Item>( static_cast<Item*>( context ) ),
+                      picture.isValid() ? Parser::Status::Done : Parser::Status::Failed,
+                      &picture );
+        } )
+    {
+        m_gates[static_cast<size_t>( Kind::Parse )].init(
+                    std::max<uint32_t>( config.maxParserThreads(), 1 ) );
+        m_gates[static_cast<size_t>( Kind::Thumbnail )].init(
+                    std::max<uint32_t>( config.maxThumbnailerThreads(), 1 ) );
+    }
+
+    AdaptiveParser( const AdaptiveParser& ) = delete;
+    AdaptiveParser& operator=( const AdaptiveParser& ) = delete;
+
+    /**
+     * Cancels all pending and in flight requests, and waits for them.
+     */
+    ~AdaptiveParser()
+    {
+        std::vector<std::unique_ptr<Item>> pending;
+        {
+            std::lock_guard<std::recursive_mutex> lock( m_mutex );
+            m_stopping = true;
+            for ( auto& g : m_gates )
+            {
+                for ( auto& i : g.pending )
+                    pending.push_back( std::move( i ) );
+                g.pending.clear();
+            }
+            m_parser.cancelAll();
+        }
+        for ( auto& i : pending )
+            notify( *i, Parser::Status::Cancelled, nullptr );
+        std::unique_lock<std::recursive_mutex> lock( m_mutex );
+        m_cond.wait( lock, [this] {
+            return m_gates[0].inFlight == 0 && m_gates[1].inFlight == 0;
+        } );
+    }
+
+    /**
+     * Queue a parse request
+     *
+     * \param media The media to parse
+     * \param onParsed Called once the request finishes
+     * \param flags The parse flags
+     */
+    void parse( Media media, OnParsed onParsed,
+                Parser::ParseFlags flags = Parser::ParseFlags::Parse )
+    {
+        std::unique_ptr<Item> item( new Item( Kind::Parse, std::move( media ) ) );
+        item->flags = flags;
+        item->onParsed = std::move( onParsed );
+        submit( std::move( item ) );
+    }
+
+    /**
+     * Queue a thumbnailer request. The request user context is ignored.
+     *
+     * \param request The thumbnailer request. The media is held until the
+     * request is handed to libvlc.
+     * \param onThumbnailed Called once the request finishes
+     */
+    void thumbnail( const Parser::ThumbnailerRequest& request, OnThumbnailed onThumbnailed )
+    {
+        std::unique_ptr<Item> item( new Item( Kind::Thumbnail, request.media() ) );
+        item->thumbnailerRequest.reset( new Parser::ThumbnailerRequest( request ) );
+        item->onThumbnailed = std::move( onThumbnailed );
+        submit( std::move( item ) );
+    }
+
+    /**
+     * Returns the current concurrency limit for a kind of request
+     */
+    unsigned int limit( Kind kind ) const
+    {
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        return m_gates[static_cast<size_t>( kind )].limit;
+    }
+
+    /**
+     * Returns the number of requests waiting to be handed to libvlc
+     */
+    size_t pending( Kind kind ) const
+    {
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        return m_gates[static_cast<size_t>( kind )].pending.size();
+    }
+
+    /**
+     * Returns the controller decisions, oldest first
+     */
+    std::vector<Decision> decisions() const
+    {
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        return std::vector<Decision>( begin( m_decisions ), end( m_decisions ) );
+    }
+
+private:
+    struct Item
+    {
+        Item( Kind k, Media m )
+            : kind( k )
+            , media( std::move( m ) )
+            , flags( Parser::ParseFlags::Parse )
+        {
+        }
+
+        Kind kind;
+        Media media;
+        Parser::ParseFlags flags;
+        std::unique_ptr<Parser::ThumbnailerRequest> thumbnailerRequest;
+        OnParsed onParsed;
+        OnThumbnailed onThumbnailed;
+        std::chrono::steady_clock::time_point dispatched;
+    };
+
+    struct Gate
+    {
+        void init( unsigned int max )
+        {
+            maxLimit = max;
+            limit = 1;
+            inFlight = 0;
+            completed = 0;
+            totalLatency = std::chrono::microseconds{ 0 };
+            bestLatency = std::chrono::microseconds{ 0 };
+            previousThroughput = 0;
+            windowStart = std::chrono::steady_clock::now();
+        }
+
+        std::deque<std::unique_ptr<Item>> pending;
+        unsigned int maxLimit;
+        unsigned int limit;
+        unsigned int inFlight;
+        /* Current measurement window */
+        unsigned int completed;
+        std::chrono::microseconds totalLatency;
+        std::chrono::steady_clock::time_point windowStart;
+        /* Previous windows */
+        std::chrono::microseconds bestLatency;
+        double previousThroughput;
+    };
+
+    void submit( std::unique_ptr<Item> item )
+    {
+        std::vector<std::unique_ptr<Item>> failed;
+        {
+            std::lock_guard<std::recursive_mutex> lock( m_mutex );
+            m_gates[static_cast<size_t>( item->kind )].pending.push_back( std::move( item ) );
+            dispatchLocked( failed );
+        }
+        for ( auto& i : failed )
+            notify( *i, Parser::Status::Failed, nullptr );
+    }
+
+    void dispatchLocked( std::vector<std::unique_ptr<Item>>& failed )
+    {
+        for ( auto& g : m_gates )
+        {
+            while ( m_stopping == false && g.inFlight < g.limit && g.pending.empty() == false )
+            {
+                auto item = std::move( g.pending.front() );
+                g.pending.pop_front();
+                item->dispatched = std::chrono::steady_clock::now();
+                // The item is owned by the request until its completion
+                auto context = item.release();
+                try
+                {
+                    if ( context->kind == Kind::Parse )
+                    {
+                        Parser::Request req( context->media );
+                        req.setParseFlags( context->flags ).setUserContext( context );
+                        m_parser.queue( req, m_cbs );
+                    }
+                    else
+                    {
+                        context->thumbnailerRequest->setUserContext( context );
+                        m_parser.queueThumbnailing( *context->thumbnailerRequest, m_thumbnailerCbs );
+                    }
+                }
+                catch ( const std::runtime_error& )
+                {
+                    failed.emplace_back( context );
+                    continue;
+                }
+                ++g.inFlight;
+            }
+        }
+    }
+
+    void complete( std::unique_ptr<Item> item, Parser::Status status, const Picture* picture )
+    {
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - item->dispatched );
+        notify( *item, status, picture );
+        std::vector<std::unique_ptr<Item>> failed;
+        {
+            std::lock_guard<std::recursive_mutex> lock( m_mutex );
+            auto& g = m_gates[static_cast<size_t>( item->kind )];
+            --g.inFlight;
+            // Cancelled requests say nothing about the storage
+            if ( status != Parser::Status::Cancelled )
+            {
+                ++g.completed;
+                g.totalLatency += latency;
+                adjustLocked( item->kind, g );
+            }
+            dispatchLocked( failed );
+            m_cond.notify_all();
+        }
+        for ( auto& i : failed )
+            notify( *i, Parser::Status::Failed, nullptr );
+    }
+
+    void adjustLocked( Kind kind, Gate& g )
+    {
+        auto now = std::chrono::steady_clock::now();
+        auto elapsed = now - g.windowStart;
+        if ( g.completed < m_tuning.minSamples || elapsed < m_tuning.interval )
+            return;
+
+        Decision d;
+        d.time = now;
+        d.kind = kind;
+        d.previousLimit = g.limit;
+        d.throughput = g.completed / std::chrono::duration<double>( elapsed ).count();
+        d.latency = g.totalLatency / static_cast<int64_t>( g.completed );
+
+        // The best latency slowly ages, so that a single lucky window
+        // doesn't pin the reference forever
+        if ( g.bestLatency.count() == 0 || d.latency < g.bestLatency )
+            g.bestLatency = d.latency;
+        else
+            g.bestLatency += g.bestLatency / 20;
+
+        // Without pending requests, the throughput follows the demand, not
+        // the parser capacity
+        auto saturated = g.pending.empty() == false;
+        auto latencyDegraded = d.latency.count() >
+                g.bestLatency.count() * m_tuning.latencyTolerance;
+        auto throughputDropped = saturated == true && g.previousThroughput > 0 &&
+                d.throughput < g.previousThroughput * ( 1 - m_tuning.throughputTolerance );
+
+        if ( ( latencyDegraded == true || throughputDropped == true ) && g.limit > 1 )
+        {
+            g.limit = std::max( g.limit / 2, 1u );
+            d.action = Action::Decrease;
+            // The latency measured at the lower limit is the new reference
+            g.bestLatency = std::chrono::microseconds{ 0 };
+        }
+        else if ( latencyDegraded == false && throughputDropped == false &&
+                  saturated == true && g.limit < g.maxLimit )
+        {
+            ++g.limit;
+            d.action = Action::Increase;
+        }
+        else
+            d.action = Action::Hold;
+        d.limit = g.limit;
+
+        if ( saturated == true )
+            g.previousThroughput = d.throughput;
+        g.completed = 0;
+        g.totalLatency = std::chrono::microseconds{ 0 };
+        g.windowStart = now;
+
+        m_decisions.push_back( d );
+        while ( m_decisions.size() > m_tuning.maxDecisions )
+            m_decisions.pop_front();
+    }
+
+    static void notify( Item& item, Parser::Status status, const Picture* picture )
+    {
+        if ( item.kind == Kind::Parse )
+        {
+            if ( item.onParsed )
+                item.onParsed( item.media, status );
+        }
+        else if ( item.onThumbnailed )
+            item.onThumbnailed( item.media, picture != nullptr ? *picture : Picture() );
+    }
+
+private:
+    Parser m_parser;
+    const Tuning m_tuning;
+    Parser::Callbacks m_cbs;
+    Parser::ThumbnailerCallbacks m_thumbnailerCbs;
+
+    mutable std::recursive_mutex m_mutex;
+    std::condition_variable_any m_cond;
+    std::array<Gate, NbKinds> m_gates;
+    std::deque<Decision> m_decisions;
+    bool m_stopping = false;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_ADAPTIVEPARSER_HPP
@@ -0,0 +1,363 @@
+/*****************************************************************************
+ * DeadlineParser.hpp: Per request deadlines for Parser requests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_DEADLINEPARSER_HPP
+#define LIBVLC_CXX_DEADLINEPARSER_HPP
+
+#include "Media.hpp"
+#include "Picture.hpp"
+#include "Parser.hpp"
+
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace VLC
+{
+
+///
+/// \brief The DeadlineParser class queues Parser requests with an individual
+/// deadline.
+///
+/// Parser::Config::setTimeout applies to all the requests of a parser. The
+/// DeadlineParser instead lets each request have its own budget: requests
+/// still running when it expires are cancelled with Parser::cancelRequest,
+/// and reported as Outcome::DeadlineExceeded, which is distinct from
+/// libvlc's own timeout.
+///
+/// Deadlines are tracked with a hashed timer wheel, ticking at the provided
+/// resolution, so arming and expiring a deadline are constant time.
+///
+class DeadlineParser
+{
+public:
+    enum class Outcome
+    {
+        Failed = static_cast<int>( Parser::Status::Failed ),
+        /// The parser timeout, set by Parser::Config::setTimeout, expired
+        Timeout = static_cast<int>( Parser::Status::Timeout ),
+        /// The request was cancelled, but not because of its deadline
+        Cancelled = static_cast<int>( Parser::Status::Cancelled ),
+        Done = static_cast<int>( Parser::Status::Done ),
+        /// The request deadline expired
+        DeadlineExceeded,
+    };
+
+    ///
+    /// \brief Outcome counters, along with a latency histogram of the
+    /// successful requests, to help choosing budgets.
+    ///
+    struct Counters
+    {
+        static constexpr size_t NbBuckets = 16;
+
+        uint64_t queued;
+        uint64_t done;
+        uint64_t failed;
+        uint64_t timeout;
+        uint64_t cancelled;
+        uint64_t deadlineExceeded;
+        /// Bucket n counts the requests which succeeded in less than
+        /// 2^n milliseconds, and more than 2^(n-1). The last bucket also
+        /// holds all the slower requests.
+        std::array<uint64_t, NbBuckets> latency;
+    };
+
+    using OnParsed = std::function<void(Media&, Outcome)>;
+    /**
+     * Thumbnailer completion prototype. libvlc doesn't report why a
+     * thumbnailer request failed, so the outcome is either Done, Failed or
+     * DeadlineExceeded.
+     */
+    using OnThumbnailed = std::function<void(Media&, const Picture&, Outcome)>;
+
+    /**
+     * \param parser The parser to queue requests to. It must outlive this object
+     * \param resolution The timer wheel tick duration. Deadlines are rounded
+     * up to the next tick.
+     * \param nbSlots The number of timer wheel slots. Deadlines longer than
+     * nbSlots * resolution are supported, but cost one extra check per
+     * wheel revolution.
+     */
+    DeadlineParser( Parser& parser,
+                    std::chrono::milliseconds resolution = std::chrono::milliseconds( 10 ),
+                    size_t nbSlots = 256 )
+        : m_parser( parser )
+        , m_cbs( [this]( Parser::Task&& task, Parser::Status status ) {
+            complete( task, static_cast<Outcome>( status ), nullptr );
+        } )
+        , m_thumbnailerCbs( [this]( Parser::Task&& task, const Picture& picture ) {
+            complete( task, picture.isValid() ? Outcome::Done : Outcome::Failed, &picture );
+        } )
+        , m_resolution( resolution )
+        , m_wheel( nbSlots )
+        , m_cursor( 0 )
+        , m_nextSeq( 0 )
+        , m_inCallbacks( 0 )
+        , m_stopping( false )
+        , m_cancelling( false )
+        , m_counters()
+    {
+        if ( resolution.count() <= 0 || nbSlots == 0 )
+            throw std::invalid_argument( "Invalid timer wheel configuration" );
+        m_thread = std::thread( &DeadlineParser::run, this );
+    }
+
+    DeadlineParser( const DeadlineParser& ) = delete;
+    DeadlineParser& operator=( const DeadlineParser& ) = delete;
+
+    /**
+     * Cancels the requests in flight, and waits for their completion.
+     */
+    ~DeadlineParser()
+    {
+        {
+            std::lock_guard<std::recursive_mutex> lock( m_mutex );
+            m_stopping = true;
+            m_cond.notify_all();
+        }
+        m_thread.join();
+        std::unique_lock<std::recursive_mutex> lock( m_mutex );
+        std::vector<Parser::TaskIdentifier> tasks;
+        for ( const auto& r : m_requests )
+            tasks.push_back( r.first );
+        for ( auto& t : tasks )
+        {
+            // A synchronous cancellation removes the task from the map
+            if ( m_requests.count( t ) != 0 )
+                m_parser.cancelRequest( t );
+        }
+        m_cond.wait( lock, [this] {
+            return m_requests.empty() == true && m_inCallbacks == 0;
+        } );
+    }
+
+    /**
+     * Queue a parse request, which will be cancelled if it doesn't complete
+     * within its budget.
+     *
+     * \param request The parse request
+     * \param budget The request budget. 0 disables the deadline.
+     * \param onParsed Called from a parser thread once the request finishes
+     * \return The identifier of the queued task
+     */
+    Parser::TaskIdentifier queue( const Parser::Request& request,
+                                  std::chrono::milliseconds budget, OnParsed onParsed )
+    {
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        // The lock is held across queue(), so the completion can't happen
+        // before the request is registered
+        auto task = m_parser.queue( request, m_cbs );
+        add( task, budget, std::move( onParsed ), nullptr );
+        return task;
+    }
+
+    /**
+     * Queue a thumbnailer request, which will be cancelled if it doesn't
+     * complete within its budget.
+     *
+     * \see queue()
+     */
+    Parser::TaskIdentifier queueThumbnailing( const Parser::ThumbnailerRequest& request,
+                                              std::chrono::milliseconds budget,
+                                              OnThumbnailed onThumbnailed )
+    {
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        auto task = m_parser.queueThumbnailing( request, m_thumbnailerCbs );
+        add( task, budget, nullptr, std::move( onThumbnailed ) );
+        return task;
+    }
+
+    /**
+     * Returns a snapshot of the outcome counters
+     */
+    Counters counters() const
+    {
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        return m_counters;
+    }
+
+private:
+    struct Pending
+    {
+        OnParsed onParsed;
+        OnThumbnailed onThumbnailed;
+        uint64_t seq;
+        bool expired;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    struct Timer
+    {
+        Parser::TaskIdentifier task;
+        /* Guards against a new task reusing the address of a finished one */
+        uint64_t seq;
+        size_t rounds;
+    };
+
+    void add( const Parser::TaskIdentifier& task, std::chrono::milliseconds budget,
+              OnParsed onParsed, OnThumbnailed onThumbnailed )
+    {
+        Pending pending;
+        pending.onParsed = std::move( onParsed );
+        pending.onThumbnailed = std::move( onThumbnailed );
+        pending.seq = m_nextSeq++;
+        pending.expired = false;
+        pending.start = std::chrono::steady_clock::now();
+        ++m_counters.queued;
+        if ( budget.count() > 0 )
+        {
+            auto ticks = static_cast<size_t>( ( budget.count() + m_resolution.count() - 1 ) /
+                                              m_resolution.count() );
+            auto slot = ( m_cursor + ticks ) % m_wheel.size();
+            m_wheel[slot].push_back( Timer{ task, pending.seq, ( ticks - 1 ) / m_wheel.size() } );
+        }
+        m_requests.emplace( task, std::move( pending ) );
+    }
+
+    void run()
+    {
+        std::unique_lock<std::recursive_mutex> lock( m_mutex );
+        auto next = std::chrono::steady_clock::now();
+        while ( true )
+        {
+            next += m_resolution;
+            if ( m_cond.wait_until( lock, next, [this] { return m_stopping; } ) == true )
+                return;
+            m_cursor = ( m_cursor + 1 ) % m_wheel.size();
+            auto timers = std::move( m_wheel[m_cursor] );
+            m_wheel[m_cursor].clear();
+            std::vector<Parser::TaskIdentifier> expired;
+            for ( auto& t : timers )
+            {
+                auto it = m_requests.find( t.task );
+                // Timers aren't removed when a request completes
+                if ( it == end( m_requests ) || it->second.seq != t.seq )
+                    continue;
+                if ( t.rounds > 0 )
+                {
+                    --t.rounds;
+                    m_wheel[m_cursor].push_back( t );
+                    continue;
+                }
+                it->second.expired = true;
+                expired.push_back( t.task );
+            }
+            if ( expired.empty() == true )
+                continue;
+            // libvlc may report the cancellation synchronously: cancel
+            // without the lock, so the user callbacks don't run with it held
+            m_cancelling = true;
+            lock.unlock();
+            for ( auto& t : expired )
+                m_parser.cancelRequest( t );
+            lock.lock();
+            m_cancelling = false;
+            auto retained = std::move( m_retained );
+            m_retained.clear();
+            lock.unlock();
+            retained.clear();
+            lock.lock();
+        }
+    }
+
+    void complete( Parser::Task& task, Outcome outcome, const Picture* picture )
+    {
+        Pending pending;
+        {
+            std::lock_guard<std::recursive_mutex> lock( m_mutex );
+            auto it = m_requests.find( Parser::TaskIdentifier( task ) );
+            assert( it != end( m_requests ) );
+            pending = std::move( it->second );
+            m_requests.erase( it );
+            ++m_inCallbacks;
+            // Keep the task alive while the timer thread may still cancel it,
+            // so a new task can't reuse its address meanwhile
+            if ( m_cancelling == true )
+                m_retained.push_back( task );
+            if ( pending.expired == true && outcome != Outcome::Done )
+                outcome = Outcome::DeadlineExceeded;
+            switch ( outcome )
+            {
+            case Outcome::Done:
+            {
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - pending.start ).count();
+                auto bucket = 0u;
+                while ( bucket < Counters::NbBuckets - 1 && ( 1ll << bucket ) <= elapsed )
+                    ++bucket;
+                ++m_counters.latency[bucket];
+                ++m_counters.done;
+                break;
+            }
+            case Outcome::Failed:
+                ++m_counters.failed;
+                break;
+            case Outcome::Timeout:
+                ++m_counters.timeout;
+                break;
+            case Outcome::Cancelled:
+                ++m_counters.cancelled;
+                break;
+            case Outcome::DeadlineExceeded:
+                ++m_counters.deadlineExceeded;
+                break;
+            }
+        }
+        auto media = task.getMedia();
+        if ( pending.onParsed )
+            pending.onParsed( media, outcome );
+        else if ( pending.onThumbnailed )
+            pending.onThumbnailed( media, *picture, outcome );
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        --m_inCallbacks;
+        m_cond.notify_all();
+    }
+
+private:
+    Parser& m_parser;
+    Parser::Callbacks m_cbs;
+    Parser::ThumbnailerCallbacks m_thumbnailerCbs;
+    const std::chrono::milliseconds m_resolution;
+
+    mutable std::recursive_mutex m_mutex;
+    std::condition_variable_any m_cond;
+    std::unordered_map<Parser::TaskIdentifier, Pending> m_requests;
+    std::vector<std::vector<Timer>> m_wheel;
+    size_t m_cursor;
+    uint64_t m_nextSeq;
+    unsigned int m_inCallbacks;
+    bool m_stopping;
+    /* Set while the timer thread cancels expired tasks without the lock */
+    bool m_cancelling;
+    std::vector<Parser::Task> m_retained;
+    Counters m_counters;
+    std::thread m_thread;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_DEADLINEPARSER_HPP
@@ -0,0 +1,304 @@
+/*****************************************************************************
+ * Future.hpp: Minimal future/promise with continuations
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_FUTURE_HPP
+#define LIBVLC_CXX_FUTURE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace VLC
+{
+
+template <typename T>
+class Promise;
+
+namespace detail
+{
+    template <typename T>
+    class FutureState
+    {
+    public:
+        using Continuation = std::function<void(const T&)>;
+
+        FutureState() : m_ready( false ) {}
+
+        bool isReady() const
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            return m_ready;
+        }
+
+        void wait() const
+        {
+            std::unique_lock<std::mutex> lock( m_mutex );
+            m_cond.wait( lock, [this] { return m_ready; } );
+        }
+
+        template <typename Rep, typename Period>
+        bool waitFor( const std::chrono::duration<Rep, Period>& timeout ) const
+        {
+            std::unique_lock<std::mutex> lock( m_mutex );
+            return m_cond.wait_for( lock, timeout, [this] { return m_ready; } );
+        }
+
+        const T& get() const
+        {
+            wait();
+            return m_value;
+        }
+
+        void then( Continuation cont )
+        {
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                if ( m_ready == false )
+                {
+                    m_continuations.push_back( std::move( cont ) );
+                    return;
+                }
+            }
+            cont( m_value );
+        }
+
+        void setValue( T value )
+        {
+            std::vector<Continuation> continuations;
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                if ( m_ready == true )
+                    throw std::logic_error( "Promise already satisfied" );
+                m_value = std::move( value );
+                m_ready = true;
+                continuations = std::move( m_continuations );
+            }
+            m_cond.notify_all();
+            // The value is immutable from now on, so it can be read unlocked
+            for ( const auto& c : continuations )
+                c( m_value );
+        }
+
+    private:
+        mutable std::mutex m_mutex;
+        mutable std::condition_variable m_cond;
+        bool m_ready;
+        T m_value;
+        std::vector<Continuation> m_continuations;
+    };
+}
+
+///
+/// \brief The Future class is a handle on a value which will be provided later
+/// by a \ref Promise.
+///
+/// Unlike std::future, a Future can be copied, its value can be read many
+/// times, and continuations can be attached to it, which is what allows
+/// \ref whenAll and \ref whenAny to await many futures without blocking a
+/// thread per future.
+///
+template <typename T>
+class Future
+{
+public:
+    Future() = default;
+
+    /**
+     * Returns true if this future is bound to a promise
+     */
+    bool isValid() const
+    {
+        return m_state != nullptr;
+    }
+
+    /**
+     * Returns true if the value is available. This never blocks.
+     */
+    bool isReady() const
+    {
+        return m_state->isReady();
+    }
+
+    /**
+     * Blocks until the value is available
+     */
+    void wait() const
+    {
+        m_state->wait();
+    }
+
+    /**
+     * Blocks until the value is available, or the timeout expires
+     *
+     * \param timeout The maximum time to wait for
+     * \return true if the value is available, false if the timeout expired
+     */
+    template <typename Rep, typename Period>
+    bool waitFor( const std::chrono::duration<Rep, Period>& timeout ) const
+    {
+        return m_state->waitFor( timeout );
+    }
+
+    /**
+     * Blocks until the value is available, and returns it.
+     *
+     * The returned reference remains valid as long as a Future sharing the
+     * same state is alive.
+     */
+    const T& get() const
+    {
+        return m_state->get();
+    }
+
+    /**
+     * Register a continuation, called with the value once available.
+     *
+     * The continuation is called from the thread which provides the value,
+     * or immediately from the calling thread if the value is already
+     * available. It must not block.
+     *
+     * \param cont A function object compatible with void(const T&)
+     */
+    template <typename Func>
+    void then( Func&& cont ) const
+    {
+        m_state->then( std::forward<Func>( cont ) );
+    }
+
+private:
+    explicit Future( std::shared_ptr<detail::FutureState<T>> state )
+        : m_state( std::move( state ) )
+    {
+    }
+
+    std::shared_ptr<detail::FutureState<T>> m_state;
+
+    friend class Promise<T>;
+};
+
+///
+/// \brief The Promise class is the producing side of a \ref Future
+///
+template <typename T>
+class Promise
+{
+public:
+    Promise()
+        : m_state( std::make_shared<detail::FutureState<T>>() )
+    {
+    }
+
+    /**
+     * Returns a future bound to this promise. Can be called multiple times.
+     */
+    Future<T> future() const
+    {
+        return Future<T>( m_state );
+    }
+
+    /**
+     * Provide the value, waking up all waiters and calling the registered
+     * continuations from the calling thread.
+     *
+     * \throw std::logic_error if a value was already provided
+     */
+    void setValue( T value ) const
+    {
+        m_state->setValue( std::move( value ) );
+    }
+
+private:
+    std::shared_ptr<detail::FutureState<T>> m_state;
+};
+
+/**
+ * Returns a future which becomes ready once all the provided futures are.
+ *
+ * \param futures The futures to wait for
+ * \return A future holding the values of all the futures, in order
+ */
+template <typename T>
+Future<std::vector<T>> whenAll( const std::vector<Future<T>>& futures )
+{
+    struct State
+    {
+        Promise<std::vector<T>> promise;
+        std::vector<Future<T>> futures;
+        std::atomic<size_t> remaining;
+    };
+    auto state = std::make_shared<State>();
+    state->futures = futures;
+    state->remaining = futures.size() + 1;
+    auto res = state->promise.future();
+    auto done = [state]() {
+        if ( --state->remaining != 0 )
+            return;
+        std::vector<T> values;
+        values.reserve( state->futures.size() );
+        for ( const auto& f : state->futures )
+            values.push_back( f.get() );
+        state->promise.setValue( std::move( values ) );
+    };
+    for ( const auto& f : futures )
+        f.then( [done]( const T& ) { done(); } );
+    // Account for the registration itself, so an empty list, or futures that
+    // are ready while we are still registering, complete exactly once
+    done();
+    return res;
+}
+
+/**
+ * Returns a future which becomes ready as soon as one of the provided futures
+ * is.
+ *
+ * \param futures The futures to wait for. Must not be empty.
+ * \return A future holding the index of the first ready future
+ */
+template <typename T>
+Future<size_t> whenAny( const std::vector<Future<T>>& futures )
+{
+    if ( futures.empty() == true )
+        throw std::invalid_argument( "whenAny requires at least one future" );
+    struct State
+    {
+        Promise<size_t> promise;
+        std::atomic_flag done;
+    };
+    auto state = std::make_shared<State>();
+    state->done.clear();
+    auto res = state->promise.future();
+    for ( auto i = 0u; i < futures.size(); ++i )
+    {
+        futures[i].then( [state, i]( const T& ) {
+            if ( state->done.test_and_set() == false )
+                state->promise.setValue( i );
+        } );
+    }
+    return res;
+}
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_FUTURE_HPP
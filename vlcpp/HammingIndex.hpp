@@ -0,0 +1,250 @@
+/*****************************************************************************
+ * HammingIndex.hpp: Hamming distance index over 64 bits hashes
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_HAMMINGINDEX_HPP
+#define LIBVLC_CXX_HAMMINGINDEX_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+# include <intrin.h>
+#endif
+
+namespace VLC
+{
+
+///
+/// \brief The HammingIndex class finds the 64 bits hashes close to a query
+/// hash, in terms of Hamming distance.
+///
+/// It implements multi-index hashing: the hashes are split in 4 chunks of
+/// 16 bits, and each chunk is indexed in its own table. Two hashes within a
+/// distance r have at least one chunk within a distance r / 4, so a search
+/// only visits the buckets close to the query chunks, instead of the whole
+/// set. When the radius is so large that this would visit more entries than
+/// a linear scan, the index falls back to a linear scan.
+///
+/// Adding hashes isn't thread safe, but concurrent searches are.
+///
+class HammingIndex
+{
+public:
+    struct Match
+    {
+        uint64_t id;
+        uint32_t distance;
+    };
+
+    HammingIndex()
+        : m_tables( NbChunks << ChunkBits )
+    {
+    }
+
+    /**
+     * Returns the number of differing bits between two hashes
+     */
+    static uint32_t distance( uint64_t a, uint64_t b )
+    {
+        auto x = a ^ b;
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<uint32_t>( __builtin_popcountll( x ) );
+#elif defined(_MSC_VER) && defined(_M_X64)
+        return static_cast<uint32_t>( __popcnt64( x ) );
+#else
+        x = x - ( ( x >> 1 ) & 0x5555555555555555ULL );
+        x = ( x & 0x3333333333333333ULL ) + ( ( x >> 2 ) & 0x3333333333333333ULL );
+        x = ( x + ( x >> 4 ) ) & 0x0f0f0f0f0f0f0f0fULL;
+        return static_cast<uint32_t>( ( x * 0x0101010101010101ULL ) >> 56 );
+#endif
+    }
+
+    /**
+     * Index a hash
+     *
+     * \param hash The hash to index
+     * \param id An identifier reported by the searches. Ids don't need to be
+     *           unique.
+     * \throw std::length_error if the index is full
+     */
+    void add( uint64_t hash, uint64_t id )
+    {
+        if ( m_hashes.size() >= std::numeric_limits<uint32_t>::max() )
+            throw std::length_error( "HammingIndex is full" );
+        auto entry = static_cast<uint32_t>( m_hashes.size() );
+        m_hashes.push_back( hash );
+        m_ids.push_back( id );
+        for ( auto c = 0u; c < NbChunks; ++c )
+            m_tables[bucket( c, chunk( hash, c ) )].push_back( entry );
+    }
+
+    void reserve( size_t size )
+    {
+        m_hashes.reserve( size );
+        m_ids.reserve( size );
+    }
+
+    size_t size() const
+    {
+        return m_hashes.size();
+    }
+
+    /**
+     * Returns all the indexed hashes within a distance of the query
+     *
+     * \param query The hash to look for
+     * \param radius The maximum distance, inclusive
+     * \return The matches, closest first
+     */
+    std::vector<Match> search( uint64_t query, uint32_t radius ) const
+    {
+        std::vector<Match> res;
+        auto sub = radius / NbChunks;
+        // Expected number of entries visited through the tables
+        auto visited = static_cast<double>( ballSize( sub ) ) * NbChunks *
+                ( static_cast<double>( m_hashes.size() ) / ( 1 << ChunkBits ) + 1 );
+        if ( sub >= ChunkBits || visited >= static_cast<double>( m_hashes.size() ) )
+        {
+            for ( auto i = 0u; i < m_hashes.size(); ++i )
+            {
+                auto d = distance( query, m_hashes[i] );
+                if ( d <= radius )
+                    res.push_back( Match{ m_ids[i], d } );
+            }
+        }
+        else
+        {
+            for ( auto c = 0u; c < NbChunks; ++c )
+            {
+                auto q = chunk( query, c );
+                forEachInBall( q, sub, [&]( uint32_t value ) {
+                    for ( auto entry : m_tables[bucket( c, value )] )
+                    {
+                        auto hash = m_hashes[entry];
+                        // An entry is reported from the first chunk close
+                        // enough to the query, so it is reported only once
+                        auto first = true;
+                        for ( auto k = 0u; k < c && first == true; ++k )
+                            first = distance( chunk( hash, k ), chunk( query, k ) ) > sub;
+                        if ( first == false )
+                            continue;
+                        auto d = distance( query, hash );
+                        if ( d <= radius )
+                            res.push_back( Match{ m_ids[entry], d } );
+                    }
+                } );
+            }
+        }
+        std::sort( begin( res ), end( res ), []( const Match& a, const Match& b ) {
+            return a.distance < b.distance;
+        } );
+        return res;
+    }
+
+    /**
+     * Find the closest indexed hash. The search radius grows progressively,
+     * so close matches are found faster than with search().
+     *
+     * \param query The hash to look for
+     * \param maxRadius The maximum distance, inclusive
+     * \param match Filled with the closest match, if any
+     * \return true if a hash was found within maxRadius
+     */
+    bool nearest( uint64_t query, uint32_t maxRadius, Match& match ) const
+    {
+        // No distance is larger than the hash size, and the loop below would
+        // otherwise run for about maxRadius / NbChunks iterations
+        maxRadius = std::min( maxRadius, NbChunks * ChunkBits );
+        // Each step searches all the distances reachable without visiting
+        // more buckets
+        for ( auto radius = NbChunks - 1; ; radius += NbChunks )
+        {
+            auto r = std::min( radius, maxRadius );
+            auto res = search( query, r );
+            if ( res.empty() == false )
+            {
+                match = res.front();
+                return true;
+            }
+            if ( r == maxRadius )
+                return false;
+        }
+    }
+
+private:
+    static constexpr uint32_t NbChunks = 4;
+    static constexpr uint32_t ChunkBits = 16;
+
+    static uint32_t chunk( uint64_t hash, uint32_t c )
+    {
+        return static_cast<uint32_t>( ( hash >> ( c * ChunkBits ) ) & 0xffff );
+    }
+
+    static size_t bucket( uint32_t c, uint32_t value )
+    {
+        return ( static_cast<size_t>( c ) << ChunkBits ) | value;
+    }
+
+    /* The number of chunk values within a distance of a chunk */
+    static size_t ballSize( uint32_t radius )
+    {
+        size_t res = 0;
+        size_t binomial = 1;
+        for ( auto k = 0u; k <= radius && k <= ChunkBits; ++k )
+        {
+            res += binomial;
+            binomial = binomial * ( ChunkBits - k ) / ( k + 1 );
+        }
+        return res;
+    }
+
+    /* Calls visit for every chunk value within a distance of center, by
+       enumerating the masks of each popcount in increasing order */
+    template <typename Visit>
+    static void forEachInBall( uint32_t center, uint32_t radius, Visit&& visit )
+    {
+        visit( center );
+        for ( auto k = 1u; k <= radius && k <= ChunkBits; ++k )
+        {
+            uint32_t mask = ( 1u << k ) - 1;
+            while ( mask < ( 1u << ChunkBits ) )
+            {
+                visit( center ^ mask );
+                // Next mask with the same popcount (Gosper's hack)
+                auto lowest = mask & ( ~mask + 1 );
+                auto ripple = mask + lowest;
+                mask = ( ( ( ripple ^ mask ) >> 2 ) / lowest ) | ripple;
+            }
+        }
+    }
+
+    std::vector<uint64_t> m_hashes;
+    std::vector<uint64_t> m_ids;
+    /* The entries of each chunk value, for each chunk */
+    std::vector<std::vector<uint32_t>> m_tables;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_HAMMINGINDEX_HPP
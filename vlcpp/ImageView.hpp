@@ -0,0 +1,252 @@
+/*****************************************************************************
+ * ImageView.hpp: Stride aware view over Picture pixels
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_IMAGEVIEW_HPP
+#define LIBVLC_CXX_IMAGEVIEW_HPP
+
+#include "Internal.hpp"
+#include "Picture.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+
+namespace VLC
+{
+
+///
+/// \brief The ImageView class is a read only view over the pixels of a raw
+/// Picture, or of a region of it.
+///
+/// The view holds a reference on the picture, so the pixels remain valid as
+/// long as the view, or any copy of it, is alive. Views are cheap to copy,
+/// and never copy the pixels.
+///
+/// Only raw pictures, ie. Picture::Type::Argb and Picture::Type::Rgba, can be
+/// viewed. Both use 4 bytes per pixel.
+///
+class ImageView
+{
+public:
+    ///
+    /// \brief Random access iterator over the rows of a view, dereferencing
+    /// to a pointer to the first pixel of the row
+    ///
+    class RowIterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = const uint8_t*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = value_type;
+
+        RowIterator() : m_row( nullptr ), m_stride( 0 ) {}
+
+        reference operator*() const { return m_row; }
+        reference operator[]( difference_type n ) const { return m_row + n * m_stride; }
+
+        RowIterator& operator++() { m_row += m_stride; return *this; }
+        RowIterator operator++( int ) { auto it = *this; m_row += m_stride; return it; }
+        RowIterator& operator--() { m_row -= m_stride; return *this; }
+        RowIterator operator--( int ) { auto it = *this; m_row -= m_stride; return it; }
+        RowIterator& operator+=( difference_type n ) { m_row += n * m_stride; return *this; }
+        RowIterator& operator-=( difference_type n ) { m_row -= n * m_stride; return *this; }
+        RowIterator operator+( difference_type n ) const { auto it = *this; return it += n; }
+        RowIterator operator-( difference_type n ) const { auto it = *this; return it -= n; }
+        difference_type operator-( const RowIterator& other ) const
+        {
+            return m_stride != 0 ? ( m_row - other.m_row ) / m_stride : 0;
+        }
+
+        bool operator==( const RowIterator& other ) const { return m_row == other.m_row; }
+        bool operator!=( const RowIterator& other ) const { return m_row != other.m_row; }
+        bool operator<( const RowIterator& other ) const { return m_row < other.m_row; }
+        bool operator>( const RowIterator& other ) const { return m_row > other.m_row; }
+        bool operator<=( const RowIterator& other ) const { return m_row <= other.m_row; }
+        bool operator>=( const RowIterator& other ) const { return m_row >= other.m_row; }
+
+    private:
+        RowIterator( const uint8_t* row, std::ptrdiff_t stride ) : m_row( row ), m_stride( stride ) {}
+
+        const uint8_t* m_row;
+        std::ptrdiff_t m_stride;
+
+        friend class ImageView;
+    };
+
+    static constexpr uint32_t BytesPerPixel = 4;
+
+    /**
+     * Create an empty view
+     */
+    ImageView()
+        : m_data( nullptr )
+        , m_width( 0 )
+        , m_height( 0 )
+        , m_stride( 0 )
+        , m_format( Picture::Type::Argb )
+    {
+    }
+
+    /**
+     * Create a view over all the pixels of a picture
+     *
+     * \param picture A valid raw picture
+     * \throw std::invalid_argument if the picture is invalid, or encoded
+     */
+    explicit ImageView( const Picture& picture )
+        : m_picture( picture )
+    {
+        if ( picture.isValid() == false )
+            throw std::invalid_argument( "Can't view an invalid picture" );
+        m_format = picture.type();
+        if ( m_format != Picture::Type::Argb && m_format != Picture::Type::Rgba )
+            throw std::invalid_argument( "Can't view the pixels of an encoded picture" );
+        size_t size;
+        m_data = picture.buffer( &size );
+        m_width = picture.width();
+        m_height = picture.height();
+        // libvlc only reports the stride of Argb pictures
+        m_stride = m_format == Picture::Type::Argb ? picture.stride() : m_width * BytesPerPixel;
+        if ( m_stride < m_width * BytesPerPixel ||
+             ( m_height != 0 && size < static_cast<size_t>( m_height - 1 ) * m_stride +
+                                       m_width * BytesPerPixel ) )
+            throw std::invalid_argument( "Inconsistent picture buffer size" );
+    }
+
+    bool isValid() const
+    {
+        return m_data != nullptr;
+    }
+
+    /**
+     * Returns a pointer to the first pixel of the view
+     */
+    const uint8_t* data() const
+    {
+        return m_data;
+    }
+
+    uint32_t width() const
+    {
+        return m_width;
+    }
+
+    uint32_t height() const
+    {
+        return m_height;
+    }
+
+    /**
+     * Returns the number of bytes between the start of two consecutive rows
+     */
+    uint32_t stride() const
+    {
+        return m_stride;
+    }
+
+    /**
+     * Returns the number of meaningful bytes in a row, without the padding
+     */
+    uint32_t rowBytes() const
+    {
+        return m_width * BytesPerPixel;
+    }
+
+    /**
+     * Returns true if the rows are contiguous, in which case the whole view
+     * can be processed as a single buffer of height() * rowBytes() bytes
+     */
+    bool isContiguous() const
+    {
+        return m_stride == rowBytes();
+    }
+
+    Picture::Type format() const
+    {
+        return m_format;
+    }
+
+    /**
+     * Returns the picture the view refers to
+     */
+    const Picture& picture() const
+    {
+        return m_picture;
+    }
+
+    /**
+     * Returns a pointer to the first pixel of a row. No bound checking is
+     * performed.
+     */
+    const uint8_t* row( uint32_t y ) const
+    {
+        return m_data + static_cast<size_t>( y ) * m_stride;
+    }
+
+    /**
+     * Returns a pointer to a pixel. No bound checking is performed.
+     */
+    const uint8_t* pixel( uint32_t x, uint32_t y ) const
+    {
+        return row( y ) + static_cast<size_t>( x ) * BytesPerPixel;
+    }
+
+    RowIterator begin() const
+    {
+        return RowIterator( m_data, m_stride );
+    }
+
+    RowIterator end() const
+    {
+        return RowIterator( row( m_height ), m_stride );
+    }
+
+    /**
+     * Returns a view over a region of this view, sharing the same pixels
+     *
+     * \param x, y The top left corner of the region, relative to this view
+     * \param width, height The region size
+     * \throw std::out_of_range if the region doesn't fit in this view
+     */
+    ImageView subview( uint32_t x, uint32_t y, uint32_t width, uint32_t height ) const
+    {
+        if ( x > m_width || width > m_width - x || y > m_height || height > m_height - y )
+            throw std::out_of_range( "ImageView region out of bounds" );
+        auto view = *this;
+        view.m_data = pixel( x, y );
+        view.m_width = width;
+        view.m_height = height;
+        return view;
+    }
+
+private:
+    Picture m_picture;
+    const uint8_t* m_data;
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_stride;
+    Picture::Type m_format;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_IMAGEVIEW_HPP
@@ -26,6 +26,7 @@
 
 #include "common.hpp"
 
+#include <cstring>
 #include <vector>
 #include <stdexcept>
 
@@ -92,6 +93,160 @@ public:
         Playlist = libvlc_media_type_playlist,
     };
 
+    ///
+    /// \brief The MetaSnapshot class is an immutable copy of all the metas of a
+    /// media, as returned by Media::metaSnapshot()
+    ///
+    /// All values are stored in a single string arena, indexed by offsets, and
+    /// a bitmask records which metas are present. Copying a snapshot only copies
+    /// a shared pointer, and a snapshot can be freely shared across threads.
+    ///
+    class MetaSnapshot
+    {
+    private:
+        struct Storage;
+
+    public:
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+        static constexpr unsigned int NbMetas = libvlc_meta_DiscTotal + 1;
+#else
+        static const unsigned int NbMetas = libvlc_meta_DiscTotal + 1;
+#endif
+
+        /**
+         * Create an empty snapshot, with no meta present
+         */
+        MetaSnapshot() = default;
+
+        /**
+         * Whether the snapshot contains a value for the provided meta
+         */
+        bool has( libvlc_meta_t meta ) const
+        {
+            return m_storage != nullptr && meta < NbMetas &&
+                    ( m_storage->mask & ( 1u << meta ) ) != 0;
+        }
+
+        /**
+         * Returns a bitmask of the present metas, with bit n set when the meta
+         * of value n is present
+         */
+        uint32_t presence() const
+        {
+            return m_storage != nullptr ? m_storage->mask : 0;
+        }
+
+        /**
+         * Returns a pointer to the nul terminated value of the provided meta,
+         * or nullptr if the meta isn't present.
+         *
+         * The pointer remains valid as long as this snapshot, or any copy of
+         * it, is alive.
+         *
+         * \param meta The meta to read
+         * \param length The value length, excluding the nul terminator [out] [optional]
+         */
+        const char* data( libvlc_meta_t meta, size_t* length = nullptr ) const
+        {
+            if ( has( meta ) == false )
+                return nullptr;
+            auto begin = m_storage->offsets[meta];
+            if ( length != nullptr )
+                *length = m_storage->offsets[meta + 1] - begin - 1;
+            return m_storage->arena.data() + begin;
+        }
+
+        /**
+         * Returns the value of the provided meta, or an empty string if it
+         * isn't present.
+         */
+        std::string get( libvlc_meta_t meta ) const
+        {
+            size_t length;
+            auto str = data( meta, &length );
+            if ( str == nullptr )
+                return {};
+            return std::string( str, length );
+        }
+
+        ///
+        /// \brief Builds a snapshot from individual values, for instance to
+        /// restore a snapshot which was serialized through its accessors.
+        ///
+        class Builder
+        {
+        public:
+            Builder()
+                : m_storage( std::make_shared<Storage>() )
+                , m_next( 0 )
+            {
+                m_storage->mask = 0;
+            }
+
+            /**
+             * Set the value of a meta. Metas must be set in increasing order.
+             *
+             * \param meta The meta to set
+             * \param value The value, which doesn't need to be nul terminated
+             * \param length The value length
+             * \throw std::invalid_argument if the meta is out of range or out
+             * of order
+             */
+            Builder& set( libvlc_meta_t meta, const char* value, size_t length )
+            {
+                if ( static_cast<unsigned int>( meta ) >= NbMetas ||
+                     static_cast<unsigned int>( meta ) < m_next )
+                    throw std::invalid_argument( "Invalid meta order" );
+                fillOffsets( meta );
+                m_storage->mask |= 1u << meta;
+                m_storage->arena.append( value, length );
+                // Keep a nul terminator so data() can return C strings
+                m_storage->arena.push_back( '\0' );
+                m_next = meta + 1;
+                return *this;
+            }
+
+            /**
+             * Returns the snapshot. The builder can't be used afterward.
+             */
+            MetaSnapshot build()
+            {
+                fillOffsets( NbMetas );
+                m_storage->arena.shrink_to_fit();
+                return MetaSnapshot( std::move( m_storage ) );
+            }
+
+        private:
+            /* Absent metas span 0 bytes */
+            void fillOffsets( unsigned int upTo )
+            {
+                for ( ; m_next <= upTo; ++m_next )
+                    m_storage->offsets[m_next] = static_cast<uint32_t>( m_storage->arena.size() );
+                m_next = upTo;
+            }
+
+            std::shared_ptr<Storage> m_storage;
+            unsigned int m_next;
+        };
+
+    private:
+        struct Storage
+        {
+            uint32_t mask;
+            /* Value n spans from offsets[n] to offsets[n + 1], including its
+               nul terminator. Absent values span 0 bytes */
+            std::array<uint32_t, NbMetas + 1> offsets;
+            std::string arena;
+        };
+
+        explicit MetaSnapshot( std::shared_ptr<const Storage> storage )
+            : m_storage( std::move( storage ) )
+        {
+        }
+
+        std::shared_ptr<const Storage> m_storage;
+    };
+
     /**
      * @brief Media Constructs a libvlc Media instance
      * @param instance  A libvlc instance
@@ -538,6 +693,30 @@ public:
         return str.get();
     }
 
+    /**
+     * Read all the metas of the media at once.
+     *
+     * This fetches every meta in a single pass, and stores them in a compact
+     * immutable \ref MetaSnapshot instead of allocating a std::string per meta.
+     *
+     * If the media has not yet been parsed the snapshot will be empty.
+     *
+     * \return a snapshot of the media's metas
+     */
+    MetaSnapshot metaSnapshot()
+    {
+        static_assert( MetaSnapshot::NbMetas <= 32, "Meta presence mask is too small" );
+        MetaSnapshot::Builder builder;
+        for ( auto i = 0u; i < MetaSnapshot::NbMetas; ++i )
+        {
+            auto meta = static_cast<libvlc_meta_t>( i );
+            auto str = wrapCStr( libvlc_media_get_meta( *this, meta ) );
+            if ( str != nullptr )
+                builder.set( meta, str.get(), strlen( str.get() ) );
+        }
+        return builder.build();
+    }
+
     /**
      * Set the meta of the media (this function will not save the meta, call
      * libvlc_media_save_meta in order to save the meta)
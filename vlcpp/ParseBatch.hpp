@@ -0,0 +1,304 @@
+/*****************************************************************************
+ * ParseBatch.hpp: Bounded batch submission of Parser requests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_PARSEBATCH_HPP
+#define LIBVLC_CXX_PARSEBATCH_HPP
+
+#include "Media.hpp"
+#include "Parser.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace VLC
+{
+
+///
+/// \brief The ParseBatch class parses a possibly huge sequence of media while
+/// keeping a bounded number of requests in flight.
+///
+/// The media are pulled from a generator, or an iterator range, only when a
+/// slot is available in the window, and a single Callbacks object is used for
+/// all requests, so memory usage doesn't depend on the batch size.
+///
+/// \code
+/// VLC::ParseBatch batch( parser, 16 );
+/// batch.run( [&]( VLC::Media& m ) { ... return hasMore; },
+///            []( VLC::Media& m, VLC::Parser::Status s ) { ... } );
+/// \endcode
+///
+class ParseBatch
+{
+public:
+    ///
+    /// \brief Snapshot of a batch progress
+    ///
+    struct Progress
+    {
+        /// Number of requests queued so far
+        size_t queued;
+        /// Number of finished requests, whatever their status
+        size_t completed;
+        /// Number of requests which didn't finish with Parser::Status::Done
+        size_t failed;
+        /// Number of requests currently in flight
+        size_t inFlight;
+        /// Time elapsed since the batch started
+        std::chrono::milliseconds elapsed;
+        /// Completed requests per second since the batch started
+        double throughput;
+    };
+
+    /**
+     * Generator prototype: fills the provided media and returns true, or
+     * returns false once there are no more media to parse.
+     */
+    using Generator = std::function<bool(Media&)>;
+
+    /**
+     * Completion prototype, called from a parser thread for each request.
+     */
+    using OnParsed = std::function<void(Media&, Parser::Status)>;
+
+    using OnProgress = std::function<void(const Progress&)>;
+
+    /**
+     * \param parser The parser to queue requests to. It must outlive the batch.
+     * \param window The maximum number of requests in flight
+     * \param flags The parse flags used for all requests
+     */
+    ParseBatch( Parser& parser, size_t window,
+                Parser::ParseFlags flags = Parser::ParseFlags::Parse )
+        : m_parser( parser )
+        , m_window( window )
+        , m_flags( flags )
+        , m_cbs( [this]( Parser::Task&& task, Parser::Status status ) {
+            onParsed( std::move( task ), status );
+        } )
+        , m_running( false )
+        , m_cancelled( false )
+    {
+        if ( window == 0 )
+            throw std::invalid_argument( "ParseBatch window can't be 0" );
+        m_inFlight.reserve( window );
+    }
+
+    ParseBatch( const ParseBatch& ) = delete;
+    ParseBatch& operator=( const ParseBatch& ) = delete;
+
+    ~ParseBatch()
+    {
+        // Only relevant if run() was interrupted by an exception: the
+        // remaining requests still refer to our callbacks.
+        cancelAll();
+        std::unique_lock<std::recursive_mutex> lock( m_mutex );
+        m_cond.wait( lock, [this] { return m_inFlight.empty(); } );
+    }
+
+    /**
+     * Register a progress callback, called from a parser thread after a
+     * request completes, at most once per interval. It is called with the
+     * batch lock held, and must not block.
+     *
+     * Must be called before run()
+     */
+    ParseBatch& onProgress( OnProgress cb,
+                            std::chrono::milliseconds interval = std::chrono::seconds( 1 ) )
+    {
+        m_onProgress = std::move( cb );
+        m_progressInterval = interval;
+        return *this;
+    }
+
+    /**
+     * Parse all the media provided by the generator, and block until they
+     * are all parsed, or the batch is cancelled.
+     *
+     * The generator is called from the calling thread, without any lock held.
+     *
+     * \param generator The media source, see \ref Generator
+     * \param onParsed Called when a request finishes, can be nullptr
+     * \return The final progress of the batch
+     */
+    Progress run( Generator generator, OnParsed onParsed )
+    {
+        {
+            std::lock_guard<std::recursive_mutex> lock( m_mutex );
+            if ( m_running == true )
+                throw std::logic_error( "ParseBatch is already running" );
+            m_running = true;
+            m_cancelled = false;
+            m_onParsed = std::move( onParsed );
+            m_queued = m_completed = m_failed = 0;
+            m_start = m_lastProgress = std::chrono::steady_clock::now();
+        }
+        while ( true )
+        {
+            {
+                std::unique_lock<std::recursive_mutex> lock( m_mutex );
+                m_cond.wait( lock, [this] {
+                    return m_inFlight.size() < m_window || m_cancelled == true;
+                } );
+                if ( m_cancelled == true )
+                    break;
+            }
+            Media media;
+            if ( generator( media ) == false )
+                break;
+            Parser::Request req( media );
+            req.setParseFlags( m_flags );
+            // Hold the lock across queue() so the completion can't happen
+            // before the task is recorded as in flight
+            std::lock_guard<std::recursive_mutex> lock( m_mutex );
+            if ( m_cancelled == true )
+                break;
+            m_inFlight.push_back( m_parser.queue( req, m_cbs ) );
+            ++m_queued;
+        }
+        std::unique_lock<std::recursive_mutex> lock( m_mutex );
+        m_cond.wait( lock, [this] { return m_inFlight.empty(); } );
+        m_running = false;
+        return progressLocked();
+    }
+
+    /**
+     * Parse all the media in the [first, last) range, see run( Generator, OnParsed )
+     *
+     * \param first, last The range of media. Their value type must be
+     * convertible to Media.
+     */
+    template <typename InputIt>
+    Progress run( InputIt first, InputIt last, OnParsed onParsed )
+    {
+        return run( [&first, last]( Media& media ) {
+            if ( first == last )
+                return false;
+            media = *first++;
+            return true;
+        }, std::move( onParsed ) );
+    }
+
+    /**
+     * Stop feeding the parser and cancel all the requests in flight.
+     * run() returns once the cancelled requests are finished.
+     *
+     * Can be called from any thread, including from the callbacks.
+     */
+    void cancelAll()
+    {
+        // libvlc reports the cancellation of queued requests synchronously,
+        // hence the recursive mutex: onParsed runs from this thread, and
+        // erases the task from m_inFlight.
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        m_cancelled = true;
+        auto inFlight = m_inFlight;
+        for ( auto& id : inFlight )
+        {
+            if ( std::find( begin( m_inFlight ), end( m_inFlight ), id ) != end( m_inFlight ) )
+                m_parser.cancelRequest( id );
+        }
+        m_cond.notify_all();
+    }
+
+    /**
+     * Returns the current progress of the batch
+     */
+    Progress progress() const
+    {
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        return progressLocked();
+    }
+
+private:
+    void onParsed( Parser::Task&& task, Parser::Status status )
+    {
+        if ( m_onParsed )
+        {
+            auto media = task.getMedia();
+            m_onParsed( media, status );
+        }
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        auto it = std::find_if( begin( m_inFlight ), end( m_inFlight ),
+                                [&task]( const Parser::TaskIdentifier& id ) {
+            return id == task;
+        } );
+        assert( it != end( m_inFlight ) );
+        *it = m_inFlight.back();
+        m_inFlight.pop_back();
+        ++m_completed;
+        if ( status != Parser::Status::Done )
+            ++m_failed;
+        auto now = std::chrono::steady_clock::now();
+        // Called with the lock held, so that run() can't return before the
+        // last report was delivered
+        if ( m_onProgress && ( now - m_lastProgress >= m_progressInterval ||
+                               m_inFlight.empty() == true ) )
+        {
+            m_lastProgress = now;
+            m_onProgress( progressLocked() );
+        }
+        m_cond.notify_all();
+    }
+
+    Progress progressLocked() const
+    {
+        Progress p;
+        p.queued = m_queued;
+        p.completed = m_completed;
+        p.failed = m_failed;
+        p.inFlight = m_inFlight.size();
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+        p.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>( elapsed );
+        auto seconds = std::chrono::duration<double>( elapsed ).count();
+        p.throughput = seconds > 0 ? m_completed / seconds : 0;
+        return p;
+    }
+
+private:
+    Parser& m_parser;
+    const size_t m_window;
+    const Parser::ParseFlags m_flags;
+    Parser::Callbacks m_cbs;
+
+    mutable std::recursive_mutex m_mutex;
+    std::condition_variable_any m_cond;
+    std::vector<Parser::TaskIdentifier> m_inFlight;
+    bool m_running;
+    bool m_cancelled;
+    OnParsed m_onParsed;
+    OnProgress m_onProgress;
+    std::chrono::milliseconds m_progressInterval{ std::chrono::seconds( 1 ) };
+
+    size_t m_queued = 0;
+    size_t m_completed = 0;
+    size_t m_failed = 0;
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_lastProgress;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_PARSEBATCH_HPP
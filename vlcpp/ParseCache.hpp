@@ -0,0 +1,643 @@
+/*****************************************************************************
+ * ParseCache.hpp: Persistent cache of parser results
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_PARSECACHE_HPP
+#define LIBVLC_CXX_PARSECACHE_HPP
+
+#include "Media.hpp"
+#include "structures.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+# ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
+namespace VLC
+{
+
+namespace detail
+{
+    ///
+    /// Read only memory mapping of a whole file
+    ///
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        MappedFile( const MappedFile& ) = delete;
+        MappedFile& operator=( const MappedFile& ) = delete;
+
+        ~MappedFile()
+        {
+            close();
+        }
+
+        bool open( const std::string& path )
+        {
+            close();
+#ifdef _WIN32
+            auto file = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                     OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+            if ( file == INVALID_HANDLE_VALUE )
+                return false;
+            LARGE_INTEGER size;
+            if ( GetFileSizeEx( file, &size ) == FALSE || size.QuadPart == 0 )
+            {
+                CloseHandle( file );
+                return false;
+            }
+            auto mapping = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+            CloseHandle( file );
+            if ( mapping == nullptr )
+                return false;
+            auto data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+            CloseHandle( mapping );
+            if ( data == nullptr )
+                return false;
+            m_size = static_cast<size_t>( size.QuadPart );
+#else
+            auto fd = ::open( path.c_str(), O_RDONLY );
+            if ( fd < 0 )
+                return false;
+            struct stat st;
+            if ( fstat( fd, &st ) != 0 || st.st_size == 0 )
+            {
+                ::close( fd );
+                return false;
+            }
+            auto data = mmap( nullptr, static_cast<size_t>( st.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+            ::close( fd );
+            if ( data == MAP_FAILED )
+                return false;
+            m_size = static_cast<size_t>( st.st_size );
+#endif
+            m_data = static_cast<const uint8_t*>( data );
+            return true;
+        }
+
+        void close()
+        {
+            if ( m_data == nullptr )
+                return;
+#ifdef _WIN32
+            UnmapViewOfFile( m_data );
+#else
+            munmap( const_cast<uint8_t*>( m_data ), m_size );
+#endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        const uint8_t* data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+    };
+
+    inline uint64_t fnv1a( const void* data, size_t size, uint64_t hash = 14695981039346656037ull )
+    {
+        auto p = static_cast<const uint8_t*>( data );
+        for ( auto i = 0u; i < size; ++i )
+        {
+            hash ^= p[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    /**
+     * Convert a file:// MRL to a local path. Returns an empty string for any
+     * other scheme.
+     */
+    inline std::string mrlToPath( const std::string& mrl )
+    {
+        static const char prefix[] = "file://";
+        if ( mrl.compare( 0, sizeof( prefix ) - 1, prefix ) != 0 )
+            return {};
+        std::string path;
+        path.reserve( mrl.size() );
+        for ( auto i = sizeof( prefix ) - 1; i < mrl.size(); ++i )
+        {
+            auto c = mrl[i];
+            if ( c == '%' && i + 2 < mrl.size() )
+            {
+                auto hex = mrl.substr( i + 1, 2 );
+                path.push_back( static_cast<char>( strtol( hex.c_str(), nullptr, 16 ) ) );
+                i += 2;
+            }
+            else
+                path.push_back( c );
+        }
+#ifdef _WIN32
+        // file:///C:/foo -> C:/foo
+        if ( path.size() > 2 && path[0] == '/' && path[2] == ':' )
+            path.erase( 0, 1 );
+#endif
+        return path;
+    }
+
+    /**
+     * Returns the modification time and size of a media file, from libvlc if
+     * it knows about them, or straight from the file system for local files.
+     */
+    inline bool fileStat( Media& media, const std::string& mrl, uint64_t& mtime, uint64_t& size )
+    {
+        auto m = media.fileStat( Media::FileStat::Mtime );
+        auto s = media.fileStat( Media::FileStat::Size );
+        if ( m.first == true && s.first == true )
+        {
+            mtime = m.second;
+            size = s.second;
+            return true;
+        }
+        // libvlc only knows about the file once it was opened, which defeats
+        // the purpose of a cache for local files: stat them directly
+        auto path = mrlToPath( mrl );
+        if ( path.empty() == true )
+            return false;
+#ifdef _WIN32
+        struct _stat64 st;
+        if ( _stat64( path.c_str(), &st ) != 0 )
+            return false;
+#else
+        struct stat st;
+        if ( ::stat( path.c_str(), &st ) != 0 )
+            return false;
+#endif
+        mtime = static_cast<uint64_t>( st.st_mtime );
+        size = static_cast<uint64_t>( st.st_size );
+        return true;
+    }
+}
+
+///
+/// \brief The ParseCache class is an on-disk cache of parsed media information.
+///
+/// Entries are keyed by MRL, and hold the duration, type, tracks summary and
+/// metas of the media. Each entry also records the file modification time and
+/// size: an entry whose file changed since it was stored is invalidated on
+/// lookup.
+///
+/// The cache file is a compact binary file, memory mapped when loaded; lookups
+/// read directly from the mapping.
+///
+/// Typical usage:
+/// \code
+/// VLC::ParseCache::Entry entry;
+/// if ( cache.lookup( media, entry ) == false )
+///     parser.queue( request, cbs ); // and call cache.store( media ) from onParsed
+/// \endcode
+///
+/// All methods are thread safe.
+///
+class ParseCache
+{
+public:
+    ///
+    /// \brief Summary of a media track
+    ///
+    struct Track
+    {
+        MediaTrack::Type type;
+        uint32_t codec;
+        uint32_t bitrate;
+        /// Video tracks only
+        uint32_t width;
+        uint32_t height;
+        uint32_t fpsNum;
+        uint32_t fpsDen;
+        /// Audio tracks only
+        uint32_t channels;
+        uint32_t rate;
+        std::string language;
+    };
+
+    struct Entry
+    {
+        std::chrono::microseconds duration;
+        Media::Type type;
+        std::vector<Track> tracks;
+        Media::MetaSnapshot meta;
+    };
+
+private:
+    static constexpr uint32_t Version = 2;
+    // Also acts as a byte order mark
+    static constexpr uint32_t Magic = 0x56435043; // "VCPC"
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t nbMetas;
+        uint32_t nbEntries;
+    };
+
+    struct FileStat
+    {
+        uint64_t mtime;
+        uint64_t size;
+    };
+
+    /* A record is stored either in the mapped file, or in a buffer owned by
+       the cache for entries stored since the file was loaded */
+    struct Record
+    {
+        const uint8_t* data;
+        size_t size;
+        std::shared_ptr<std::vector<uint8_t>> owned;
+    };
+
+    class Writer
+    {
+    public:
+        explicit Writer( std::vector<uint8_t>& buffer ) : m_buffer( buffer ) {}
+
+        template <typename T>
+        void write( T value )
+        {
+            static_assert( std::is_trivially_copyable<T>::value, "Can only write PODs" );
+            auto p = reinterpret_cast<const uint8_t*>( &value );
+            m_buffer.insert( end( m_buffer ), p, p + sizeof( value ) );
+        }
+
+        void write( const char* str, size_t size )
+        {
+            write<uint32_t>( static_cast<uint32_t>( size ) );
+            m_buffer.insert( end( m_buffer ), str, str + size );
+        }
+
+    private:
+        std::vector<uint8_t>& m_buffer;
+    };
+
+    class Reader
+    {
+    public:
+        Reader( const uint8_t* data, size_t size ) : m_data( data ), m_size( size ), m_pos( 0 ) {}
+
+        template <typename T>
+        bool read( T& value )
+        {
+            if ( m_size - m_pos < sizeof( value ) )
+                return false;
+            memcpy( &value, m_data + m_pos, sizeof( value ) );
+            m_pos += sizeof( value );
+            return true;
+        }
+
+        bool read( const char*& str, uint32_t& size )
+        {
+            if ( read( size ) == false || m_size - m_pos < size )
+                return false;
+            str = reinterpret_cast<const char*>( m_data + m_pos );
+            m_pos += size;
+            return true;
+        }
+
+        bool read( std::string& str )
+        {
+            const char* p;
+            uint32_t size;
+            if ( read( p, size ) == false )
+                return false;
+            str.assign( p, size );
+            return true;
+        }
+
+    private:
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_pos;
+    };
+
+public:
+    /**
+     * Create a cache backed by the provided file. If the file exists, it is
+     * mapped and its entries become available for lookups.
+     *
+     * \param path The cache file path
+     */
+    explicit ParseCache( std::string path )
+        : m_path( std::move( path ) )
+    {
+        load();
+    }
+
+    ParseCache( const ParseCache& ) = delete;
+    ParseCache& operator=( const ParseCache& ) = delete;
+
+    /**
+     * Lookup the cached information for a media.
+     *
+     * On a hit the media doesn't need to be parsed. An entry for a file whose
+     * modification time or size changed is removed.
+     *
+     * \param media The media to lookup
+     * \param entry The cached information [out]
+     * \return true on a hit, false otherwise
+     */
+    bool lookup( Media& media, Entry& entry )
+    {
+        auto mrl = media.mrl();
+        FileStat stat;
+        if ( fileStat( media, mrl, stat ) == false )
+            return false;
+        auto hash = detail::fnv1a( mrl.data(), mrl.size() );
+
+        std::lock_guard<std::mutex> lock( m_mutex );
+        auto it = m_records.find( hash );
+        if ( it == end( m_records ) )
+            return false;
+        FileStat cached;
+        Reader r( it->second.data, it->second.size );
+        const char* key;
+        uint32_t keySize;
+        if ( r.read( key, keySize ) == false || keySize != mrl.size() ||
+             memcmp( key, mrl.data(), keySize ) != 0 )
+            return false;
+        if ( r.read( cached ) == false || cached.mtime != stat.mtime ||
+             cached.size != stat.size || decode( r, entry ) == false )
+        {
+            m_records.erase( it );
+            m_dirty = true;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Store the information of a parsed media, replacing any previous entry.
+     *
+     * This is meant to be called once the media parsing is done, typically
+     * from the Parser onParsed callback.
+     *
+     * \param media A parsed media
+     * \return false if the file modification time and size aren't available,
+     * in which case nothing was stored
+     */
+    bool store( Media& media )
+    {
+        auto mrl = media.mrl();
+        FileStat stat;
+        if ( fileStat( media, mrl, stat ) == false )
+            return false;
+
+        auto buffer = std::make_shared<std::vector<uint8_t>>();
+        Writer w( *buffer );
+        w.write( mrl.data(), mrl.size() );
+        w.write( stat );
+        encode( w, media );
+
+        Record record{ buffer->data(), buffer->size(), buffer };
+        auto hash = detail::fnv1a( mrl.data(), mrl.size() );
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_records[hash] = std::move( record );
+        m_dirty = true;
+        return true;
+    }
+
+    /**
+     * Write the cache to its file, if it changed since it was loaded.
+     *
+     * The file is written to a temporary file first, then renamed over the
+     * previous one, so a crash never leaves a truncated cache behind.
+     *
+     * \return true on success
+     */
+    bool save()
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        if ( m_dirty == false )
+            return true;
+        auto tmpPath = m_path + ".tmp";
+        auto f = fopen( tmpPath.c_str(), "wb" );
+        if ( f == nullptr )
+            return false;
+        Header h{ Magic, Version, Media::MetaSnapshot::NbMetas,
+                  static_cast<uint32_t>( m_records.size() ) };
+        auto success = fwrite( &h, sizeof( h ), 1, f ) == 1;
+        for ( const auto& r : m_records )
+        {
+            if ( success == false )
+                break;
+            uint32_t size = static_cast<uint32_t>( r.second.size );
+            success = fwrite( &size, sizeof( size ), 1, f ) == 1 &&
+                      fwrite( r.second.data, r.second.size, 1, f ) == 1;
+        }
+        success = fclose( f ) == 0 && success;
+        if ( success == false )
+        {
+            std::remove( tmpPath.c_str() );
+            return false;
+        }
+        // Records point into the current mapping, or into buffers that are now
+        // on disk: drop them, and index the new file instead. The mapping must
+        // also be released before replacing the file on some platforms.
+        m_records.clear();
+        m_file.close();
+#ifdef _WIN32
+        auto renamed = MoveFileExA( tmpPath.c_str(), m_path.c_str(), MOVEFILE_REPLACE_EXISTING ) != FALSE;
+#else
+        auto renamed = std::rename( tmpPath.c_str(), m_path.c_str() ) == 0;
+#endif
+        if ( m_file.open( renamed ? m_path : tmpPath ) == true )
+            index();
+        if ( renamed == false )
+            return false;
+        m_dirty = false;
+        return true;
+    }
+
+    /**
+     * Drop all entries. The file is truncated on the next save()
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_records.clear();
+        m_dirty = true;
+    }
+
+    /**
+     * Returns the number of entries in the cache
+     */
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        return m_records.size();
+    }
+
+private:
+    void load()
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        if ( m_file.open( m_path ) == false )
+            return;
+        index();
+    }
+
+    void index()
+    {
+        Reader r( m_file.data(), m_file.size() );
+        Header h;
+        if ( r.read( h ) == false || h.magic != Magic || h.version != Version ||
+             h.nbMetas != Media::MetaSnapshot::NbMetas )
+        {
+            m_file.close();
+            return;
+        }
+        m_records.reserve( h.nbEntries );
+        for ( auto i = 0u; i < h.nbEntries; ++i )
+        {
+            const char* data;
+            uint32_t size;
+            if ( r.read( data, size ) == false )
+                break;
+            Reader record( reinterpret_cast<const uint8_t*>( data ), size );
+            const char* key;
+            uint32_t keySize;
+            if ( record.read( key, keySize ) == false )
+                break;
+            m_records[detail::fnv1a( key, keySize )] =
+                    Record{ reinterpret_cast<const uint8_t*>( data ), size, nullptr };
+        }
+    }
+
+    static bool fileStat( Media& media, const std::string& mrl, FileStat& stat )
+    {
+        return detail::fileStat( media, mrl, stat.mtime, stat.size );
+    }
+
+    static void encode( Writer& w, Media& media )
+    {
+        w.write<int64_t>( media.duration().count() );
+        w.write<int32_t>( static_cast<int32_t>( media.type() ) );
+
+        std::vector<MediaTrack> tracks;
+        for ( auto type : { MediaTrack::Audio, MediaTrack::Video, MediaTrack::Subtitle } )
+        {
+            auto t = media.tracks( type );
+            tracks.insert( end( tracks ), begin( t ), end( t ) );
+        }
+        w.write<uint32_t>( static_cast<uint32_t>( tracks.size() ) );
+        for ( const auto& t : tracks )
+        {
+            auto video = t.type() == MediaTrack::Video;
+            auto audio = t.type() == MediaTrack::Audio;
+            w.write<int32_t>( static_cast<int32_t>( t.type() ) );
+            w.write<uint32_t>( t.codec() );
+            w.write<uint32_t>( t.bitrate() );
+            w.write<uint32_t>( video ? t.width() : 0 );
+            w.write<uint32_t>( video ? t.height() : 0 );
+            w.write<uint32_t>( video ? t.fpsNum() : 0 );
+            w.write<uint32_t>( video ? t.fpsDen() : 0 );
+            w.write<uint32_t>( audio ? t.channels() : 0 );
+            w.write<uint32_t>( audio ? t.rate() : 0 );
+            auto language = t.language();
+            w.write( language.data(), language.size() );
+        }
+
+        auto meta = media.metaSnapshot();
+        w.write<uint32_t>( meta.presence() );
+        for ( auto i = 0u; i < Media::MetaSnapshot::NbMetas; ++i )
+        {
+            size_t length;
+            auto value = meta.data( static_cast<libvlc_meta_t>( i ), &length );
+            if ( value != nullptr )
+                w.write( value, length );
+        }
+    }
+
+    static bool decode( Reader& r, Entry& entry )
+    {
+        int64_t duration;
+        int32_t type;
+        uint32_t nbTracks;
+        if ( r.read( duration ) == false || r.read( type ) == false ||
+             r.read( nbTracks ) == false )
+            return false;
+        entry.duration = std::chrono::microseconds{ duration };
+        entry.type = static_cast<Media::Type>( type );
+        entry.tracks.clear();
+        entry.tracks.reserve( nbTracks );
+        for ( auto i = 0u; i < nbTracks; ++i )
+        {
+            Track t;
+            int32_t trackType;
+            if ( r.read( trackType ) == false || r.read( t.codec ) == false ||
+                 r.read( t.bitrate ) == false || r.read( t.width ) == false ||
+                 r.read( t.height ) == false || r.read( t.fpsNum ) == false ||
+                 r.read( t.fpsDen ) == false || r.read( t.channels ) == false ||
+                 r.read( t.rate ) == false || r.read( t.language ) == false )
+                return false;
+            t.type = static_cast<MediaTrack::Type>( trackType );
+            entry.tracks.push_back( std::move( t ) );
+        }
+
+        uint32_t presence;
+        // Reject the metas this version doesn't know about
+        if ( r.read( presence ) == false ||
+             ( presence >> ( Media::MetaSnapshot::NbMetas - 1 ) >> 1 ) != 0 )
+            return false;
+        Media::MetaSnapshot::Builder builder;
+        for ( auto i = 0u; i < Media::MetaSnapshot::NbMetas; ++i )
+        {
+            if ( ( presence & ( 1u << i ) ) == 0 )
+                continue;
+            const char* value;
+            uint32_t length;
+            if ( r.read( value, length ) == false )
+                return false;
+            builder.set( static_cast<libvlc_meta_t>( i ), value, length );
+        }
+        entry.meta = builder.build();
+        return true;
+    }
+
+private:
+    const std::string m_path;
+    mutable std::mutex m_mutex;
+    detail::MappedFile m_file;
+    std::unordered_map<uint64_t, Record> m_records;
+    bool m_dirty = false;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_PARSECACHE_HPP
@@ -0,0 +1,313 @@
+/*****************************************************************************
+ * ParsedMediaInfo.hpp: Immutable snapshot of a parsed media
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_PARSEDMEDIAINFO_HPP
+#define LIBVLC_CXX_PARSEDMEDIAINFO_HPP
+
+#include "Media.hpp"
+#include "structures.hpp"
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace VLC
+{
+
+///
+/// \brief The ParsedMediaInfo class is an immutable snapshot of everything
+/// parsing reports about a media: duration, type, tracks, slaves and metas.
+///
+/// It is meant to be built once, typically from the onParsed callback, and
+/// read any number of times afterward without calling into libvlc. All the
+/// strings are stored in a single buffer, tracks and slaves are plain
+/// structs stored contiguously, and copies share the same storage, so a
+/// snapshot is cheap to copy and safe to read from any thread.
+///
+/// The strings returned by the snapshot, including the ones in Track and
+/// Slave, remain valid as long as the snapshot, or any copy of it, is alive.
+///
+class ParsedMediaInfo
+{
+public:
+    struct Track
+    {
+        MediaTrack::Type type;
+        int32_t id;
+        /// \see MediaTrack::codec()
+        uint32_t codec;
+        uint32_t originalFourCC;
+        int32_t profile;
+        int32_t level;
+        uint32_t bitrate;
+        /// Nul terminated strings, never nullptr
+        const char* language;
+        const char* description;
+        const char* name;
+        const char* idStr;
+        bool idStable;
+        /// Audio tracks only
+        uint32_t channels;
+        uint32_t rate;
+        /// Video tracks only
+        uint32_t width;
+        uint32_t height;
+        uint32_t sarNum;
+        uint32_t sarDen;
+        uint32_t fpsNum;
+        uint32_t fpsDen;
+        MediaTrack::Orientation orientation;
+        MediaTrack::Projection projection;
+        /// Subtitle tracks only
+        const char* encoding;
+    };
+
+    struct Slave
+    {
+        MediaSlave::Type type;
+        unsigned int priority;
+        const char* uri;
+    };
+
+    ///
+    /// \brief A contiguous range of tracks
+    ///
+    class TrackRange
+    {
+    public:
+        const Track* begin() const { return m_begin; }
+        const Track* end() const { return m_end; }
+        size_t size() const { return static_cast<size_t>( m_end - m_begin ); }
+        bool empty() const { return m_begin == m_end; }
+        const Track& operator[]( size_t i ) const { return m_begin[i]; }
+
+    private:
+        TrackRange( const Track* b, const Track* e ) : m_begin( b ), m_end( e ) {}
+
+        const Track* m_begin;
+        const Track* m_end;
+
+        friend class ParsedMediaInfo;
+    };
+
+    /**
+     * Create an invalid snapshot
+     */
+    ParsedMediaInfo() = default;
+
+    /**
+     * Capture the current state of a media. This should be called once the
+     * media is parsed.
+     *
+     * \param media The media to capture
+     */
+    explicit ParsedMediaInfo( Media& media )
+    {
+        auto storage = std::make_shared<Storage>();
+        storage->duration = media.duration();
+        storage->type = media.type();
+        storage->meta = media.metaSnapshot();
+
+        /* Strings are first recorded as offsets, since the arena may be
+           reallocated while it is filled */
+        std::vector<std::vector<size_t>> trackStrings;
+        std::vector<MediaTrack::Type> types = { MediaTrack::Type::Audio, MediaTrack::Type::Video,
+                                                MediaTrack::Type::Subtitle };
+        auto mrl = addString( storage->arena, media.mrl() );
+        for ( auto i = 0u; i < types.size(); ++i )
+        {
+            storage->ranges[i] = storage->tracks.size();
+            for ( const auto& t : media.tracks( types[i] ) )
+            {
+                Track track = {};
+                track.type = t.type();
+                track.id = t.id();
+                track.codec = t.codec();
+                track.originalFourCC = t.originalFourCC();
+                track.profile = t.profile();
+                track.level = t.level();
+                track.bitrate = t.bitrate();
+                track.idStable = t.idStable();
+                std::vector<size_t> strings = {
+                    addString( storage->arena, t.language() ),
+                    addString( storage->arena, t.description() ),
+                    addString( storage->arena, t.name() ),
+                    addString( storage->arena, t.idStr() ),
+                };
+                switch ( track.type )
+                {
+                case MediaTrack::Type::Audio:
+                    track.channels = t.channels();
+                    track.rate = t.rate();
+                    strings.push_back( 0 );
+                    break;
+                case MediaTrack::Type::Video:
+                    track.width = t.width();
+                    track.height = t.height();
+                    track.sarNum = t.sarNum();
+                    track.sarDen = t.sarDen();
+                    track.fpsNum = t.fpsNum();
+                    track.fpsDen = t.fpsDen();
+                    track.orientation = t.orientation();
+                    track.projection = t.projection();
+                    strings.push_back( 0 );
+                    break;
+                case MediaTrack::Type::Subtitle:
+                    strings.push_back( addString( storage->arena, t.encoding() ) );
+                    break;
+                default:
+                    strings.push_back( 0 );
+                    break;
+                }
+                storage->tracks.push_back( track );
+                trackStrings.push_back( std::move( strings ) );
+            }
+        }
+        storage->ranges[types.size()] = storage->tracks.size();
+
+        std::vector<size_t> slaveUris;
+        for ( const auto& s : media.slaves() )
+        {
+            storage->slaves.push_back( Slave{ s.type(), s.priority(), nullptr } );
+            slaveUris.push_back( addString( storage->arena, s.uri() ) );
+        }
+
+        // The arena is complete, resolve the strings
+        auto base = storage->arena.c_str();
+        storage->mrl = base + mrl;
+        for ( auto i = 0u; i < storage->tracks.size(); ++i )
+        {
+            auto& t = storage->tracks[i];
+            const auto& s = trackStrings[i];
+            t.language = base + s[0];
+            t.description = base + s[1];
+            t.name = base + s[2];
+            t.idStr = base + s[3];
+            t.encoding = base + s[4];
+        }
+        for ( auto i = 0u; i < storage->slaves.size(); ++i )
+            storage->slaves[i].uri = base + slaveUris[i];
+        m_storage = std::move( storage );
+    }
+
+    bool isValid() const
+    {
+        return m_storage != nullptr;
+    }
+
+    const char* mrl() const
+    {
+        return m_storage->mrl;
+    }
+
+    std::chrono::microseconds duration() const
+    {
+        return m_storage->duration;
+    }
+
+    Media::Type type() const
+    {
+        return m_storage->type;
+    }
+
+    /**
+     * Returns all the tracks: audio tracks first, then video, then subtitles
+     */
+    TrackRange tracks() const
+    {
+        const auto& t = m_storage->tracks;
+        return TrackRange( t.data(), t.data() + t.size() );
+    }
+
+    /**
+     * Returns the tracks of the provided type
+     */
+    TrackRange tracks( MediaTrack::Type type ) const
+    {
+        size_t index;
+        switch ( type )
+        {
+        case MediaTrack::Type::Audio:
+            index = 0;
+            break;
+        case MediaTrack::Type::Video:
+            index = 1;
+            break;
+        case MediaTrack::Type::Subtitle:
+            index = 2;
+            break;
+        default:
+            return TrackRange( nullptr, nullptr );
+        }
+        auto data = m_storage->tracks.data();
+        return TrackRange( data + m_storage->ranges[index], data + m_storage->ranges[index + 1] );
+    }
+
+    const std::vector<Slave>& slaves() const
+    {
+        return m_storage->slaves;
+    }
+
+    const Media::MetaSnapshot& metas() const
+    {
+        return m_storage->meta;
+    }
+
+    /**
+     * Returns the value of a meta, or nullptr if it isn't present
+     */
+    const char* meta( libvlc_meta_t meta ) const
+    {
+        return m_storage->meta.data( meta );
+    }
+
+private:
+    struct Storage
+    {
+        std::chrono::microseconds duration;
+        Media::Type type;
+        const char* mrl;
+        /* Audio, video and subtitle tracks, contiguous. The tracks of type
+           n span from ranges[n] to ranges[n + 1] */
+        std::vector<Track> tracks;
+        std::array<size_t, 4> ranges;
+        std::vector<Slave> slaves;
+        Media::MetaSnapshot meta;
+        /* Nul terminated strings, the first one being the empty string */
+        std::string arena = std::string( 1, '\0' );
+    };
+
+    static size_t addString( std::string& arena, const std::string& str )
+    {
+        if ( str.empty() == true )
+            return 0;
+        auto offset = arena.size();
+        arena.append( str.c_str(), str.size() + 1 );
+        return offset;
+    }
+
+    std::shared_ptr<const Storage> m_storage;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_PARSEDMEDIAINFO_HPP
@@ -24,9 +24,17 @@
 #define LIBVLC_CXX_PARSER_HPP
 
 #include "common.hpp"
+#include "Future.hpp"
+
+#include <functional>
 
 namespace VLC
 {
+class AdaptiveParser;
+class ParserTaskTable;
+class RequestCoalescer;
+class ThumbnailCache;
+
 class Parser : public Internal<libvlc_parser_t>
 {
 public:
@@ -42,6 +50,22 @@ public:
         Done = libvlc_parser_status_done,
     };
 
+    /**
+     * Outcome of a request queued with parseAsync() or thumbnailAsync()
+     */
+    struct Result
+    {
+        /**
+         * Terminal status of the request. libvlc doesn't report why a
+         * thumbnailer request failed, so those only use Done and Failed.
+         */
+        Status status;
+        /// The media the request was queued for
+        Media media;
+        /// The thumbnail, for successful thumbnailer requests only
+        Picture picture;
+    };
+
     class Task : public Internal<libvlc_parser_task>
     {
     private:
@@ -76,6 +100,15 @@ public:
         }
 
     public:
+        /**
+         * Get the identifier of a task, typically from a callback, so it can
+         * be used as a key along with the identifiers returned by queue()
+         */
+        explicit TaskIdentifier( const Task& task )
+            : m_task( task.get() )
+        {
+        }
+
         friend bool operator==( const TaskIdentifier& id, const Task& task )
         {
             return id.m_task == task.get();
@@ -103,6 +136,7 @@ public:
         }
 
         friend class Parser;
+        friend struct std::hash<TaskIdentifier>;
         template <size_t, typename ...>
         friend struct CallbackWrapper;
     };
@@ -116,6 +150,12 @@ public:
      */
     using ExpectedOnParsedCb = void(Parser::Task&& task, Parser::Status status);
 
+    /**
+     * Alternative onParsed prototype, which also receives the user context
+     * of the request, as set by Request::setUserContext()
+     */
+    using ExpectedOnParsedWithContextCb = void(Parser::Task&& task, Parser::Status status, void* context);
+
     /**
      * Callback prototype that notify when the parser add new attachments to
      * the media.
@@ -129,6 +169,12 @@ public:
      */
     using ExpectedOnAttachmentsAddedCb = void(Parser::TaskIdentifier task, const Picture::List& list);
 
+    /**
+     * Alternative onAttachmentsAdded prototype, which also receives the user
+     * context of the request, as set by Request::setUserContext()
+     */
+    using ExpectedOnAttachmentsAddedWithContextCb = void(Parser::TaskIdentifier task, const Picture::List& list, void* context);
+
     /**
      * Callback prototype that notify when a thumbnailer request finishes
      *
@@ -141,6 +187,12 @@ public:
      */
     using ExpectedOnThumbnailerEndedCb = void(Parser::Task&& task, const Picture& picture);
 
+    /**
+     * Alternative onThumbnailerEnded prototype, which also receives the user
+     * context of the request, as set by ThumbnailerRequest::setUserContext()
+     */
+    using ExpectedOnThumbnailerEndedWithContextCb = void(Parser::Task&& task, const Picture& picture, void* context);
+
     enum class ParseFlags
     {
         /**
@@ -175,6 +227,22 @@ public:
         Fast = libvlc_media_thumbnail_seek_fast,
     };
 
+    enum class SeekType
+    {
+        /**
+         * No seek, the thumbnail is generated from the media start
+         */
+        None = libvlc_thumbnailer_seek_none,
+        /**
+         * Seek to a time, see ThumbnailerRequest::setSeekTime()
+         */
+        Time = libvlc_thumbnailer_seek_time,
+        /**
+         * Seek to a position, see ThumbnailerRequest::setSeekPosition()
+         */
+        Position = libvlc_thumbnailer_seek_pos,
+    };
+
     class Config
     {
     public:
@@ -223,6 +291,26 @@ public:
             return *this;
         }
 
+        /**
+         * Get the maximum number of parser threads, as set by setMaxParserThreads()
+         *
+         * \return the maximum number of threads, 0 for the default (1 thread)
+         */
+        uint32_t maxParserThreads() const
+        {
+            return m_cfg.max_parser_threads;
+        }
+
+        /**
+         * Get the maximum number of thumbnailer threads, as set by setMaxThumbnailerThreads()
+         *
+         * \return the maximum number of threads, 0 for the default (1 thread)
+         */
+        uint32_t maxThumbnailerThreads() const
+        {
+            return m_cfg.max_thumbnailer_threads;
+        }
+
     private:
         friend class Parser;
         libvlc_parser_cfg m_cfg;
@@ -242,6 +330,7 @@ public:
          * \warning The media object must remain valid until the parser request is queued.
          */
         Request( Media& media )
+            : m_userContext( nullptr )
         {
             m_req = {};
             m_req.version = 0;
@@ -260,9 +349,50 @@ public:
             return *this;
         }
 
+        /**
+         * Set a user context, handed back to the callbacks of this request
+         * which accept it, see \ref ExpectedOnParsedWithContextCb
+         *
+         * \param context an opaque pointer, owned by the application
+         * \return reference to this Request object for chaining
+         */
+        Request& setUserContext( void* context )
+        {
+            m_userContext = context;
+            return *this;
+        }
+
+        /**
+         * Get the media to parse
+         */
+        Media media() const
+        {
+            return Media( m_req.media, true );
+        }
+
+        Parser::ParseFlags parseFlags() const
+        {
+            return static_cast<Parser::ParseFlags>( m_req.parse_flags );
+        }
+
+        void* userContext() const
+        {
+            return m_userContext;
+        }
+
+        /**
+         * Returns the underlying libvlc request, for code queueing it with
+         * libvlc_parser_queue() directly
+         */
+        const libvlc_parser_request_t* get() const
+        {
+            return &m_req;
+        }
+
     private:
         friend class Parser;
         libvlc_parser_request_t m_req;
+        void* m_userContext;
     };
 
     class Callbacks : protected CallbackOwner<2>
@@ -280,6 +410,27 @@ public:
     public:
         Callbacks() = delete;
 
+        /**
+         * Returns the underlying libvlc callbacks, for code queueing requests
+         * with libvlc_parser_queue() directly. They must be handed an opaque
+         * created by makeOpaque().
+         */
+        const libvlc_parser_cbs* get() const
+        {
+            return &m_cbs;
+        }
+
+        /**
+         * Create the opaque of a request using these callbacks. Once the
+         * request is queued, its last callback releases the opaque.
+         *
+         * \param userContext the request user context
+         */
+        std::unique_ptr<parser::Opaque> makeOpaque( void* userContext ) const
+        {
+            return std::unique_ptr<parser::Opaque>( new parser::Opaque{ m_callbacks.get(), userContext } );
+        }
+
         /**
          * Constructor with the mandatory on_parsed callback.
          * 
@@ -289,11 +440,12 @@ public:
         template <typename OnParsedCb>
         Callbacks( OnParsedCb&& onParsedCb )
         {
-            static_assert( signature_match<OnParsedCb, ExpectedOnParsedCb>::value,
+            static_assert( signature_match<OnParsedCb, ExpectedOnParsedCb>::value ||
+                           signature_match<OnParsedCb, ExpectedOnParsedWithContextCb>::value,
                            "Mismatched on_parsed callback prototype" );
             m_cbs = {};
             m_cbs.version = 0;
-            m_cbs.on_parsed = CallbackWrapper<(unsigned int)CallbackIdx::OnParsed,
+            m_cbs.on_parsed = parser::CallbackWrapper<(unsigned int)CallbackIdx::OnParsed, true,
                               decltype(libvlc_parser_cbs::on_parsed)>::wrap<Parser::Task, Parser::Status>(
                               *m_callbacks, std::forward<OnParsedCb>( onParsedCb ) );
         }
@@ -308,9 +460,10 @@ public:
         template <typename OnAttachmentsAddedCb>
         Callbacks& onAttachmentsAdded( OnAttachmentsAddedCb&& cb )
         {
-            static_assert( signature_match<OnAttachmentsAddedCb, ExpectedOnAttachmentsAddedCb>::value,
+            static_assert( signature_match<OnAttachmentsAddedCb, ExpectedOnAttachmentsAddedCb>::value ||
+                           signature_match<OnAttachmentsAddedCb, ExpectedOnAttachmentsAddedWithContextCb>::value,
                            "Mismatched on_attachments_added callback prototype" );
-            m_cbs.on_attachments_added = CallbackWrapper<(unsigned int)CallbackIdx::OnAttachmentsAdded,
+            m_cbs.on_attachments_added = parser::CallbackWrapper<(unsigned int)CallbackIdx::OnAttachmentsAdded, false,
                                          decltype(libvlc_parser_cbs::on_attachments_added)>::wrap<
                                          Parser::TaskIdentifier, Picture::List>(
                                          *m_callbacks, std::forward<OnAttachmentsAddedCb>( cb ) );
@@ -332,6 +485,7 @@ public:
          * \warning The media object must remain valid until the thumnailer request is queued.
          */
         ThumbnailerRequest( Media& media )
+            : m_userContext( nullptr )
         {
             m_req = {};
             m_req.version = 0;
@@ -422,9 +576,97 @@ public:
             return *this;
         }
 
+        /**
+         * Set a user context, handed back to the callback of this request if
+         * it accepts it, see \ref ExpectedOnThumbnailerEndedWithContextCb
+         *
+         * \param context an opaque pointer, owned by the application
+         * \return reference to this ThumbnailerRequest object for chaining
+         */
+        ThumbnailerRequest& setUserContext( void* context )
+        {
+            m_userContext = context;
+            return *this;
+        }
+
+        /**
+         * Get the media for which to generate thumbnails
+         */
+        Media media() const
+        {
+            return Media( m_req.media, true );
+        }
+
+        unsigned int width() const
+        {
+            return m_req.width;
+        }
+
+        unsigned int height() const
+        {
+            return m_req.height;
+        }
+
+        bool crop() const
+        {
+            return m_req.crop;
+        }
+
+        Picture::Type pictureType() const
+        {
+            return static_cast<Picture::Type>( m_req.type );
+        }
+
+        SeekType seekType() const
+        {
+            return static_cast<SeekType>( m_req.seek.type );
+        }
+
+        /**
+         * Get the seek time, only meaningful if seekType() is SeekType::Time
+         */
+        std::chrono::microseconds seekTime() const
+        {
+            return std::chrono::microseconds{ m_req.seek.value.time };
+        }
+
+        /**
+         * Get the seek position, only meaningful if seekType() is
+         * SeekType::Position
+         */
+        double seekPosition() const
+        {
+            return m_req.seek.value.pos;
+        }
+
+        ThumbnailSeekSpeed seekSpeed() const
+        {
+            return static_cast<ThumbnailSeekSpeed>( m_req.seek.speed );
+        }
+
+        bool hwDec() const
+        {
+            return m_req.hw_dec;
+        }
+
+        void* userContext() const
+        {
+            return m_userContext;
+        }
+
+        /**
+         * Returns the underlying libvlc request, for code queueing it with
+         * libvlc_parser_queue_thumbnailing() directly
+         */
+        const libvlc_thumbnailer_request_t* get() const
+        {
+            return &m_req;
+        }
+
     private:
         friend class Parser;
         libvlc_thumbnailer_request_t m_req;
+        void* m_userContext;
     };
 
     class ThumbnailerCallbacks : protected CallbackOwner<1>
@@ -441,6 +683,27 @@ public:
     public:
         ThumbnailerCallbacks() = delete;
 
+        /**
+         * Returns the underlying libvlc callbacks, for code queueing requests
+         * with libvlc_parser_queue_thumbnailing() directly. They must be
+         * handed an opaque created by makeOpaque().
+         */
+        const libvlc_thumbnailer_cbs* get() const
+        {
+            return &m_cbs;
+        }
+
+        /**
+         * Create the opaque of a request using these callbacks. Once the
+         * request is queued, its callback releases the opaque.
+         *
+         * \param userContext the request user context
+         */
+        std::unique_ptr<parser::Opaque> makeOpaque( void* userContext ) const
+        {
+            return std::unique_ptr<parser::Opaque>( new parser::Opaque{ m_callbacks.get(), userContext } );
+        }
+
         /**
          * Constructor with the mandatory on_thumbnailer_ended callback.
          * 
@@ -450,11 +713,12 @@ public:
         template <typename OnThumbnailerEnded>
         ThumbnailerCallbacks( OnThumbnailerEnded&& onThumbnailerEnded )
         {
-            static_assert( signature_match<OnThumbnailerEnded, ExpectedOnThumbnailerEndedCb>::value,
+            static_assert( signature_match<OnThumbnailerEnded, ExpectedOnThumbnailerEndedCb>::value ||
+                           signature_match<OnThumbnailerEnded, ExpectedOnThumbnailerEndedWithContextCb>::value,
                            "Mismatched on_thumbnailer_ended callback prototype" );
             m_cbs = {};
             m_cbs.version = 0;
-            m_cbs.on_ended = CallbackWrapper<(unsigned int)CallbackIdx::OnThumbnailerEnded,
+            m_cbs.on_ended = parser::CallbackWrapper<(unsigned int)CallbackIdx::OnThumbnailerEnded, true,
                              decltype(libvlc_thumbnailer_cbs::on_ended)>::wrap<Parser::Task, Picture>(
                              *m_callbacks, std::forward<OnThumbnailerEnded>( onThumbnailerEnded ) );
         }
@@ -495,9 +759,13 @@ public:
      */
     TaskIdentifier queue( const Request& request, const Callbacks& cbs )
     {
-        auto task = libvlc_parser_queue( *this, &request.m_req, &cbs.m_cbs, cbs.m_callbacks.get() );
+        std::unique_ptr<parser::Opaque> opaque( new parser::Opaque{ cbs.m_callbacks.get(),
+                                                                    request.m_userContext } );
+        auto task = libvlc_parser_queue( *this, &request.m_req, &cbs.m_cbs, opaque.get() );
         if ( task == nullptr )
             throw std::runtime_error( "Failed to queue parser task" );
+        // Owned by the request from now on, and released by its last callback
+        opaque.release();
         return TaskIdentifier( task );
     }
 
@@ -520,12 +788,70 @@ public:
      */
     TaskIdentifier queueThumbnailing( const ThumbnailerRequest& request, const ThumbnailerCallbacks& cbs )
     {
-        auto task = libvlc_parser_queue_thumbnailing( *this, &request.m_req, &cbs.m_cbs, cbs.m_callbacks.get() );
+        std::unique_ptr<parser::Opaque> opaque( new parser::Opaque{ cbs.m_callbacks.get(),
+                                                                    request.m_userContext } );
+        auto task = libvlc_parser_queue_thumbnailing( *this, &request.m_req, &cbs.m_cbs, opaque.get() );
         if ( task == nullptr )
             throw std::runtime_error( "Failed to queue thumbnailer task" );
+        opaque.release();
         return TaskIdentifier( task );
     }
 
+    /**
+     * Queue a parsing request, and return a future resolving to its result.
+     *
+     * Unlike queue(), the request and callbacks lifetime is handled
+     * internally, and the media is held until the request finishes.
+     *
+     * \param media the media to parse
+     * \param flags the parse flags, \ref ParseFlags
+     * \return a future which becomes ready once the request finishes
+     *
+     * \see whenAll() whenAny() to wait for many requests at once
+     */
+    Future<Result> parseAsync( Media media, ParseFlags flags = ParseFlags::Parse )
+    {
+        auto state = std::make_shared<AsyncParse>( std::move( media ) );
+        Request req( state->media );
+        req.setParseFlags( flags );
+        // The request owns itself until its callback is called
+        state->self = state;
+        try
+        {
+            queue( req, state->cbs );
+        }
+        catch ( ... )
+        {
+            state->self.reset();
+            throw;
+        }
+        return state->promise.future();
+    }
+
+    /**
+     * Queue a thumbnail generation request, and return a future resolving to
+     * its result.
+     *
+     * \param request the thumbnail generation request
+     * \return a future which becomes ready once the request finishes
+     */
+    Future<Result> thumbnailAsync( const ThumbnailerRequest& request )
+    {
+        auto state = std::make_shared<AsyncThumbnail>(
+                    Media( request.m_req.media, true ) );
+        state->self = state;
+        try
+        {
+            queueThumbnailing( request, state->cbs );
+        }
+        catch ( ... )
+        {
+            state->self.reset();
+            throw;
+        }
+        return state->promise.future();
+    }
+
     /**
      * Cancel a parser request.
      *
@@ -549,6 +875,44 @@ public:
     {
         return libvlc_parser_cancel_request( *this, nullptr );
     }
+
+private:
+    /* Both async states drop their self reference as the very last thing
+       they do from their callback, since it owns the callback being run */
+    struct AsyncParse
+    {
+        explicit AsyncParse( Media m )
+            : media( std::move( m ) )
+            , cbs( [this]( Task&&, Status status ) {
+                auto self = std::move( this->self );
+                promise.setValue( Result{ status, std::move( media ), Picture() } );
+            } )
+        {
+        }
+
+        Media media;
+        Promise<Result> promise;
+        Callbacks cbs;
+        std::shared_ptr<AsyncParse> self;
+    };
+
+    struct AsyncThumbnail
+    {
+        explicit AsyncThumbnail( Media m )
+            : media( std::move( m ) )
+            , cbs( [this]( Task&&, const Picture& picture ) {
+                auto self = std::move( this->self );
+                auto status = picture.isValid() ? Status::Done : Status::Failed;
+                promise.setValue( Result{ status, std::move( media ), picture } );
+            } )
+        {
+        }
+
+        Media media;
+        Promise<Result> promise;
+        ThumbnailerCallbacks cbs;
+        std::shared_ptr<AsyncThumbnail> self;
+    };
 };
 
 inline Parser::ParseFlags operator|(Parser::ParseFlags l, Parser::ParseFlags r)
@@ -559,4 +923,16 @@ inline Parser::ParseFlags operator|(Parser::ParseFlags l, Parser::ParseFlags r)
 
 } // namespace VLC
 
+namespace std
+{
+template <>
+struct hash<VLC::Parser::TaskIdentifier>
+{
+    size_t operator()( const VLC::Parser::TaskIdentifier& id ) const
+    {
+        return hash<libvlc_parser_task*>()( id.m_task );
+    }
+};
+}
+
 #endif // LIBVLC_CXX_PARSER_HPP
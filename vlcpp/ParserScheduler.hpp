@@ -0,0 +1,407 @@
+/*****************************************************************************
+ * ParserScheduler.hpp: Priority scheduling of Parser requests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_PARSERSCHEDULER_HPP
+#define LIBVLC_CXX_PARSERSCHEDULER_HPP
+
+#include "Instance.hpp"
+#include "Media.hpp"
+#include "Parser.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace VLC
+{
+
+///
+/// \brief The ParserScheduler class queues parser requests by priority class.
+///
+/// libvlc runs parser requests in FIFO order. The scheduler keeps its own
+/// per class queues, and only hands libvlc as many requests as it has parser
+/// threads, so an interactive request never waits behind a bulk scan: it is
+/// queued to libvlc as soon as a parser thread is available.
+///
+/// The scheduler owns its Parser, so that no other user can fill the libvlc
+/// queue behind its back.
+///
+class ParserScheduler
+{
+public:
+    enum class Priority
+    {
+        /// A user is waiting for the result
+        Interactive,
+        /// Background work, such as a library scan
+        Bulk,
+    };
+
+    static constexpr size_t NbPriorities = 2;
+
+    ///
+    /// \brief Identifies a submitted request, to promote or cancel it
+    ///
+    class Ticket
+    {
+    public:
+        Ticket() : m_id( 0 ) {}
+
+        bool operator==( const Ticket& other ) const
+        {
+            return m_id == other.m_id;
+        }
+
+        bool isValid() const
+        {
+            return m_id != 0;
+        }
+
+    private:
+        explicit Ticket( uint64_t id ) : m_id( id ) {}
+
+        uint64_t m_id;
+
+        friend class ParserScheduler;
+    };
+
+    ///
+    /// \brief Per priority class statistics
+    ///
+    struct Stats
+    {
+        /// Requests waiting in the scheduler queue
+        size_t pending;
+        /// Requests handed to libvlc so far
+        size_t dispatched;
+        /// Average and maximum time spent in the scheduler queue by the
+        /// dispatched requests
+        std::chrono::microseconds averageWait;
+        std::chrono::microseconds maxWait;
+    };
+
+    /**
+     * Completion prototype, called from a parser thread.
+     * Requests cancelled before being dispatched are reported with
+     * Parser::Status::Cancelled, from the thread which cancelled them.
+     */
+    using OnParsed = std::function<void(Media&, Parser::Status)>;
+
+    /**
+     * \param instance The VLC instance
+     * \param config The parser configuration. Its max parser threads setting
+     * is the number of requests the scheduler keeps in flight.
+     */
+    ParserScheduler( const Instance& instance, const Parser::Config& config = Parser::Config() )
+        : m_parser( instance, config )
+        , m_maxInFlight( std::max<uint32_t>( config.maxParserThreads(), 1 ) )
+        , m_cbs( [this]( Parser::Task&& task, Parser::Status status ) {
+            onParsed( std::move( task ), status );
+        } )
+        , m_nextId( 1 )
+        , m_stopping( false )
+    {
+        for ( auto& s : m_stats )
+            s = ClassStats{};
+        m_thread = std::thread( &ParserScheduler::dispatch, this );
+    }
+
+    ParserScheduler( const ParserScheduler& ) = delete;
+    ParserScheduler& operator=( const ParserScheduler& ) = delete;
+
+    /**
+     * Cancels all pending and in flight requests, and waits for them.
+     */
+    ~ParserScheduler()
+    {
+        {
+            std::lock_guard<std::recursive_mutex> lock( m_mutex );
+            m_stopping = true;
+            m_cond.notify_all();
+        }
+        m_thread.join();
+        cancelAll();
+        std::unique_lock<std::recursive_mutex> lock( m_mutex );
+        m_cond.wait( lock, [this] { return m_inFlight.empty(); } );
+    }
+
+    /**
+     * Submit a parse request.
+     *
+     * \param media The media to parse
+     * \param priority The request priority class
+     * \param onParsed Called once the request finishes
+     * \param flags The parse flags
+     * \return A ticket identifying the request
+     */
+    Ticket submit( Media media, Priority priority, OnParsed onParsed,
+                   Parser::ParseFlags flags = Parser::ParseFlags::Parse )
+    {
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        auto id = m_nextId++;
+        auto& queue = m_pending[static_cast<size_t>( priority )];
+        queue.push_back( Pending{ id, std::move( media ), flags, std::move( onParsed ),
+                                  std::chrono::steady_clock::now() } );
+        m_index[id] = Location{ priority, std::prev( end( queue ) ) };
+        m_cond.notify_all();
+        return Ticket( id );
+    }
+
+    /**
+     * Move a request which wasn't dispatched yet to a higher priority class.
+     *
+     * The request keeps its submission time, so it is queued behind the
+     * requests of that class which were submitted earlier.
+     *
+     * \param ticket The request to promote
+     * \param priority The new priority class
+     * \return false if the request was already dispatched
+     */
+    bool promote( const Ticket& ticket, Priority priority = Priority::Interactive )
+    {
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        auto it = m_index.find( ticket.m_id );
+        if ( it == end( m_index ) )
+            return false;
+        if ( it->second.priority == priority )
+            return true;
+        auto& from = m_pending[static_cast<size_t>( it->second.priority )];
+        auto& to = m_pending[static_cast<size_t>( priority )];
+        auto pos = std::find_if( begin( to ), end( to ), [&it]( const Pending& p ) {
+            return p.submitted > it->second.it->submitted;
+        } );
+        to.splice( pos, from, it->second.it );
+        it->second.priority = priority;
+        return true;
+    }
+
+    /**
+     * Cancel a request, whether it was dispatched or not.
+     *
+     * \return false if the request already finished
+     */
+    bool cancel( const Ticket& ticket )
+    {
+        std::unique_lock<std::recursive_mutex> lock( m_mutex );
+        auto it = m_index.find( ticket.m_id );
+        if ( it != end( m_index ) )
+        {
+            auto& queue = m_pending[static_cast<size_t>( it->second.priority )];
+            auto pending = std::move( *it->second.it );
+            queue.erase( it->second.it );
+            m_index.erase( it );
+            lock.unlock();
+            if ( pending.onParsed )
+                pending.onParsed( pending.media, Parser::Status::Cancelled );
+            return true;
+        }
+        auto inFlight = std::find_if( begin( m_inFlight ), end( m_inFlight ),
+                                      [&ticket]( const InFlight& f ) {
+            return f.ticket == ticket.m_id;
+        } );
+        if ( inFlight == end( m_inFlight ) || inFlight->completing == true )
+            return false;
+        // libvlc may report the cancellation synchronously, hence the
+        // recursive mutex
+        m_parser.cancelRequest( inFlight->task );
+        return true;
+    }
+
+    /**
+     * Cancel all requests, pending or in flight.
+     */
+    void cancelAll()
+    {
+        std::array<std::list<Pending>, NbPriorities> pending;
+        {
+            std::lock_guard<std::recursive_mutex> lock( m_mutex );
+            pending.swap( m_pending );
+            m_index.clear();
+            m_parser.cancelAll();
+        }
+        for ( auto& queue : pending )
+        {
+            for ( auto& p : queue )
+            {
+                if ( p.onParsed )
+                    p.onParsed( p.media, Parser::Status::Cancelled );
+            }
+        }
+    }
+
+    /**
+     * Returns the statistics of a priority class
+     */
+    Stats stats( Priority priority ) const
+    {
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        const auto& s = m_stats[static_cast<size_t>( priority )];
+        Stats res;
+        res.pending = m_pending[static_cast<size_t>( priority )].size();
+        res.dispatched = s.dispatched;
+        res.averageWait = std::chrono::microseconds{ s.dispatched != 0 ?
+                    s.totalWait.count() / static_cast<int64_t>( s.dispatched ) : 0 };
+        res.maxWait = s.maxWait;
+        return res;
+    }
+
+    /**
+     * Returns the number of requests handed to libvlc, and not finished yet
+     */
+    size_t inFlight() const
+    {
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        return m_inFlight.size();
+    }
+
+private:
+    struct Pending
+    {
+        uint64_t id;
+        Media media;
+        Parser::ParseFlags flags;
+        OnParsed onParsed;
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    struct Location
+    {
+        Priority priority;
+        std::list<Pending>::iterator it;
+    };
+
+    struct InFlight
+    {
+        uint64_t ticket;
+        Parser::TaskIdentifier task;
+        OnParsed onParsed;
+        /* The request finished, and its callback is running */
+        bool completing;
+    };
+
+    struct ClassStats
+    {
+        size_t dispatched;
+        std::chrono::microseconds totalWait;
+        std::chrono::microseconds maxWait;
+    };
+
+    std::list<Pending>* nextQueue()
+    {
+        for ( auto& q : m_pending )
+        {
+            if ( q.empty() == false )
+                return &q;
+        }
+        return nullptr;
+    }
+
+    void dispatch()
+    {
+        std::unique_lock<std::recursive_mutex> lock( m_mutex );
+        while ( true )
+        {
+            m_cond.wait( lock, [this] {
+                return m_stopping == true ||
+                        ( m_inFlight.size() < m_maxInFlight && nextQueue() != nullptr );
+            } );
+            if ( m_stopping == true )
+                return;
+            auto queue = nextQueue();
+            auto priority = static_cast<size_t>( queue - m_pending.data() );
+            auto p = std::move( queue->front() );
+            queue->pop_front();
+            m_index.erase( p.id );
+
+            auto wait = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - p.submitted );
+            auto& s = m_stats[priority];
+            ++s.dispatched;
+            s.totalWait += wait;
+            s.maxWait = std::max( s.maxWait, wait );
+
+            Parser::Request req( p.media );
+            req.setParseFlags( p.flags );
+            // The lock is held across queue(), so the completion can't
+            // happen before the task is recorded as in flight
+            try
+            {
+                auto task = m_parser.queue( req, m_cbs );
+                m_inFlight.push_back( InFlight{ p.id, task, std::move( p.onParsed ), false } );
+            }
+            catch ( const std::runtime_error& )
+            {
+                lock.unlock();
+                if ( p.onParsed )
+                    p.onParsed( p.media, Parser::Status::Failed );
+                lock.lock();
+            }
+        }
+    }
+
+    void onParsed( Parser::Task&& task, Parser::Status status )
+    {
+        std::unique_lock<std::recursive_mutex> lock( m_mutex );
+        auto it = std::find_if( begin( m_inFlight ), end( m_inFlight ),
+                                [&task]( const InFlight& f ) {
+            return f.task == task;
+        } );
+        assert( it != end( m_inFlight ) );
+        it->completing = true;
+        // Entries of a std::list are stable, so the callback can be called
+        // unlocked, and the entry removed afterward: the destructor waits for
+        // m_inFlight to be empty, so it also waits for the user callback.
+        lock.unlock();
+        if ( it->onParsed )
+        {
+            auto media = task.getMedia();
+            it->onParsed( media, status );
+        }
+        lock.lock();
+        m_inFlight.erase( it );
+        m_cond.notify_all();
+    }
+
+private:
+    Parser m_parser;
+    const size_t m_maxInFlight;
+    Parser::Callbacks m_cbs;
+
+    mutable std::recursive_mutex m_mutex;
+    std::condition_variable_any m_cond;
+    std::array<std::list<Pending>, NbPriorities> m_pending;
+    std::unordered_map<uint64_t, Location> m_index;
+    std::list<InFlight> m_inFlight;
+    std::array<ClassStats, NbPriorities> m_stats;
+    uint64_t m_nextId;
+    bool m_stopping;
+    std::thread m_thread;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_PARSERSCHEDULER_HPP
@@ -0,0 +1,473 @@
+/*****************************************************************************
+ * ParserTaskTable.hpp: Generation counted handles to Parser tasks
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_PARSERTASKTABLE_HPP
+#define LIBVLC_CXX_PARSERTASKTABLE_HPP
+
+#include "Parser.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace VLC
+{
+
+///
+/// \brief The ParserTaskTable class queues Parser requests, and hands out
+/// stable identifiers which remain safe to use once the task finished.
+///
+/// A Parser::TaskIdentifier dangles as soon as its task finishes. The table
+/// instead identifies tasks with a slot index and a generation counter: a
+/// finished task retires its slot and bumps its generation, so cancelling an
+/// outdated Id is a cheap no-op instead of undefined behaviour.
+///
+/// All operations are lock free, except when the last task in flight
+/// finishes, as it wakes up the destructor. Tasks can be tagged with a group, to cancel
+/// a whole group at once.
+///
+/// The user callbacks are forwarded as is, and the same lifetime rules as
+/// Parser::queue apply to them.
+///
+class ParserTaskTable
+{
+public:
+    ///
+    /// \brief Identifies a task queued through the table
+    ///
+    class Id
+    {
+    public:
+        Id() : m_value( 0 ) {}
+
+        bool isValid() const
+        {
+            return m_value != 0;
+        }
+
+        bool operator==( const Id& other ) const
+        {
+            return m_value == other.m_value;
+        }
+
+        bool operator!=( const Id& other ) const
+        {
+            return m_value != other.m_value;
+        }
+
+        uint64_t value() const
+        {
+            return m_value;
+        }
+
+    private:
+        Id( uint32_t generation, uint32_t index )
+            : m_value( static_cast<uint64_t>( generation ) << 32 | index )
+        {
+        }
+
+        uint32_t generation() const { return static_cast<uint32_t>( m_value >> 32 ); }
+        uint32_t index() const { return static_cast<uint32_t>( m_value ); }
+
+        uint64_t m_value;
+
+        friend class ParserTaskTable;
+    };
+
+    /**
+     * \param parser The parser to queue requests to. It must outlive the table.
+     * \param capacity The maximum number of tasks in flight
+     * \throw std::invalid_argument if the capacity is 0 or UINT32_MAX
+     */
+    ParserTaskTable( Parser& parser, uint32_t capacity )
+        : m_parser( parser )
+        , m_slots( new Slot[checkCapacity( capacity )] )
+        , m_capacity( capacity )
+        , m_freeHead( 0 )
+        , m_size( 0 )
+    {
+        // Chain all the slots, index 0 first. Free list links are index + 1,
+        // so that 0 can mean "empty"
+        for ( auto i = 0u; i < capacity; ++i )
+        {
+            m_slots[i].table = this;
+            m_slots[i].index = i;
+            m_slots[i].state.store( static_cast<uint64_t>( 1 ) << GenerationShift,
+                                    std::memory_order_relaxed );
+            m_slots[i].nextFree.store( i + 1 < capacity ? i + 2 : 0, std::memory_order_relaxed );
+        }
+        m_freeHead.store( 1, std::memory_order_release );
+
+        m_parseCbs = {};
+        m_parseCbs.version = 0;
+        m_parseCbs.on_parsed = &ParserTaskTable::onParsed;
+        m_parseCbs.on_attachments_added = &ParserTaskTable::onAttachmentsAdded;
+        m_thumbnailerCbs = {};
+        m_thumbnailerCbs.version = 0;
+        m_thumbnailerCbs.on_ended = &ParserTaskTable::onThumbnailerEnded;
+    }
+
+    ParserTaskTable( const ParserTaskTable& ) = delete;
+    ParserTaskTable& operator=( const ParserTaskTable& ) = delete;
+
+    /**
+     * Cancel all tasks, and wait for them to finish
+     */
+    ~ParserTaskTable()
+    {
+        cancelAll();
+        std::unique_lock<std::mutex> lock( m_mutex );
+        m_cond.wait( lock, [this] {
+            return m_size.load( std::memory_order_acquire ) == 0;
+        } );
+    }
+
+    /**
+     * Queue a parsing request.
+     *
+     * \param request the parsing request
+     * \param cbs the callbacks, see Parser::queue() for their lifetime requirements
+     * \param group an optional group tag, see cancelGroup()
+     * \return the task Id
+     * \throw std::runtime_error if the table is full, or the request couldn't be queued
+     */
+    Id queue( const Parser::Request& request, const Parser::Callbacks& cbs, uint32_t group = 0 )
+    {
+        auto opaque = cbs.makeOpaque( request.userContext() );
+        auto& slot = reserve( group );
+        slot.parseCbs = cbs.get();
+        slot.thumbnailerCbs = nullptr;
+        slot.opaque = opaque.get();
+        auto id = publish( slot, libvlc_parser_queue( m_parser, request.get(),
+                                                      &m_parseCbs, &slot ) );
+        // Released by the forwarded callbacks, as for Parser::queue()
+        opaque.release();
+        return id;
+    }
+
+    /**
+     * Queue a thumbnail generation request.
+     *
+     * \see queue()
+     */
+    Id queueThumbnailing( const Parser::ThumbnailerRequest& request,
+                          const Parser::ThumbnailerCallbacks& cbs, uint32_t group = 0 )
+    {
+        auto opaque = cbs.makeOpaque( request.userContext() );
+        auto& slot = reserve( group );
+        slot.parseCbs = nullptr;
+        slot.thumbnailerCbs = cbs.get();
+        slot.opaque = opaque.get();
+        auto id = publish( slot, libvlc_parser_queue_thumbnailing( m_parser, request.get(),
+                                                                   &m_thumbnailerCbs, &slot ) );
+        opaque.release();
+        return id;
+    }
+
+    /**
+     * Cancel a task.
+     *
+     * \param id The task to cancel
+     * \return true if the task was still running and got cancelled. Cancelling
+     * a finished task returns false, and has no other effect.
+     */
+    bool cancel( Id id )
+    {
+        if ( id.isValid() == false || id.index() >= m_capacity )
+            return false;
+        return cancel( m_slots[id.index()], id.generation(), nullptr );
+    }
+
+    /**
+     * Cancel all the tasks queued with the provided group tag.
+     *
+     * \return the number of cancelled tasks
+     */
+    size_t cancelGroup( uint32_t group )
+    {
+        size_t res = 0;
+        for ( auto i = 0u; i < m_capacity; ++i )
+        {
+            if ( cancel( m_slots[i], 0, &group ) == true )
+                ++res;
+        }
+        return res;
+    }
+
+    /**
+     * Cancel all the tasks queued through the table.
+     *
+     * \return the number of cancelled tasks
+     */
+    size_t cancelAll()
+    {
+        size_t res = 0;
+        for ( auto i = 0u; i < m_capacity; ++i )
+        {
+            if ( cancel( m_slots[i], 0, nullptr ) == true )
+                ++res;
+        }
+        return res;
+    }
+
+    /**
+     * Returns true if the task is still running
+     */
+    bool isRunning( Id id ) const
+    {
+        if ( id.isValid() == false || id.index() >= m_capacity )
+            return false;
+        auto state = m_slots[id.index()].state.load( std::memory_order_acquire );
+        return generation( state ) == id.generation() && ( state & Live ) != 0 &&
+                ( state & Done ) == 0;
+    }
+
+    /**
+     * Returns the number of tasks in flight
+     */
+    size_t size() const
+    {
+        return m_size.load( std::memory_order_relaxed );
+    }
+
+    size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+private:
+    /* Slot state: generation in the 32 upper bits, then the Live and Done
+       flags, then the number of cancellers currently using the task */
+    static constexpr unsigned GenerationShift = 32;
+    static constexpr uint64_t Live = 1ull << 31;
+    static constexpr uint64_t Done = 1ull << 30;
+    static constexpr uint64_t PinMask = Done - 1;
+
+    static uint32_t checkCapacity( uint32_t capacity )
+    {
+        if ( capacity == 0 || capacity == std::numeric_limits<uint32_t>::max() )
+            throw std::invalid_argument( "Invalid task table capacity" );
+        return capacity;
+    }
+
+    static uint32_t generation( uint64_t state )
+    {
+        return static_cast<uint32_t>( state >> GenerationShift );
+    }
+
+    struct Slot
+    {
+        std::atomic<uint64_t> state;
+        std::atomic<uint32_t> nextFree;
+        std::atomic<uint32_t> group;
+        /* Written before the task is published through state */
+        libvlc_parser_task* task;
+        const libvlc_parser_cbs* parseCbs;
+        const libvlc_thumbnailer_cbs* thumbnailerCbs;
+        void* opaque;
+        ParserTaskTable* table;
+        uint32_t index;
+    };
+
+    /* The slot being cancelled by the current thread, if any, since libvlc
+       may report the cancellation synchronously. In that case, the canceller
+       retires the slot once it's done with it. */
+    struct Cancelling
+    {
+        Slot* slot;
+        bool retire;
+    };
+
+    static Cancelling& cancelling()
+    {
+        static thread_local Cancelling c = { nullptr, false };
+        return c;
+    }
+
+    Slot& reserve( uint32_t group )
+    {
+        auto head = m_freeHead.load( std::memory_order_acquire );
+        while ( true )
+        {
+            auto link = static_cast<uint32_t>( head );
+            if ( link == 0 )
+                throw std::runtime_error( "Parser task table is full" );
+            auto next = m_slots[link - 1].nextFree.load( std::memory_order_relaxed );
+            // The upper bits are a tag, bumped on each update to avoid ABA
+            auto newHead = ( ( head >> 32 ) + 1 ) << 32 | next;
+            if ( m_freeHead.compare_exchange_weak( head, newHead, std::memory_order_acquire ) )
+                break;
+        }
+        auto& slot = m_slots[static_cast<uint32_t>( head ) - 1];
+        slot.group.store( group, std::memory_order_relaxed );
+        m_size.fetch_add( 1, std::memory_order_relaxed );
+        return slot;
+    }
+
+    Id publish( Slot& slot, libvlc_parser_task* task )
+    {
+        if ( task == nullptr )
+        {
+            retire( slot );
+            throw std::runtime_error( "Failed to queue parser task" );
+        }
+        slot.task = task;
+        auto state = slot.state.fetch_or( Live, std::memory_order_acq_rel );
+        auto id = Id( generation( state ), slot.index );
+        // The task may already have finished: its callback left the slot
+        // for us to retire.
+        if ( ( state & Done ) != 0 )
+            retire( slot );
+        return id;
+    }
+
+    void retire( Slot& slot )
+    {
+        auto gen = generation( slot.state.load( std::memory_order_relaxed ) ) + 1;
+        if ( gen == 0 )
+            gen = 1;
+        slot.state.store( static_cast<uint64_t>( gen ) << GenerationShift,
+                          std::memory_order_release );
+        auto head = m_freeHead.load( std::memory_order_relaxed );
+        while ( true )
+        {
+            slot.nextFree.store( static_cast<uint32_t>( head ), std::memory_order_relaxed );
+            auto newHead = ( ( head >> 32 ) + 1 ) << 32 | ( slot.index + 1 );
+            if ( m_freeHead.compare_exchange_weak( head, newHead, std::memory_order_release,
+                                                   std::memory_order_relaxed ) )
+                break;
+        }
+        // The last task takes the lock before leaving, so the destructor
+        // can't miss the wakeup, nor return while the mutex is still in use
+        auto size = m_size.load( std::memory_order_relaxed );
+        while ( size > 1 )
+        {
+            if ( m_size.compare_exchange_weak( size, size - 1, std::memory_order_release,
+                                               std::memory_order_relaxed ) )
+                return;
+        }
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_size.fetch_sub( 1, std::memory_order_release );
+        m_cond.notify_all();
+    }
+
+    /* Cancel the slot task if it matches the generation (when non 0) and
+       the group (when provided) */
+    bool cancel( Slot& slot, uint32_t gen, const uint32_t* group )
+    {
+        auto state = slot.state.load( std::memory_order_acquire );
+        do
+        {
+            if ( ( gen != 0 && generation( state ) != gen ) ||
+                 ( state & Live ) == 0 || ( state & Done ) != 0 )
+                return false;
+        } while ( slot.state.compare_exchange_weak( state, state + 1,
+                                                    std::memory_order_acquire ) == false );
+        // The task can't complete while pinned, so it's safe to use
+        auto res = false;
+        auto retireSlot = false;
+        if ( group == nullptr || slot.group.load( std::memory_order_relaxed ) == *group )
+        {
+            auto& c = cancelling();
+            auto previous = c;
+            c = Cancelling{ &slot, false };
+            res = libvlc_parser_cancel_request( m_parser, slot.task ) != 0;
+            retireSlot = c.retire;
+            c = previous;
+        }
+        slot.state.fetch_sub( 1, std::memory_order_release );
+        if ( retireSlot == true )
+            retire( slot );
+        return res;
+    }
+
+    /* Called from the libvlc callbacks before forwarding them */
+    static void complete( Slot& slot )
+    {
+        auto state = slot.state.fetch_or( Done, std::memory_order_acq_rel );
+        if ( ( state & Live ) == 0 )
+            // queue() didn't return yet, it will retire the slot
+            return;
+        // Wait for the cancellers which are using the task, except for the
+        // current thread, when libvlc reports the cancellation synchronously.
+        // The task remains valid until this callback returns.
+        auto& c = cancelling();
+        uint64_t selfPins = c.slot == &slot ? 1 : 0;
+        while ( ( state & PinMask ) != selfPins )
+        {
+            std::this_thread::yield();
+            state = slot.state.load( std::memory_order_acquire );
+        }
+        if ( selfPins != 0 )
+            c.retire = true;
+        else
+            slot.table->retire( slot );
+    }
+
+    static void onParsed( void* opaque, libvlc_parser_task* task, libvlc_parser_status_t status )
+    {
+        auto& slot = *static_cast<Slot*>( opaque );
+        auto cbs = slot.parseCbs;
+        auto userOpaque = slot.opaque;
+        complete( slot );
+        if ( cbs->on_parsed != nullptr )
+            cbs->on_parsed( userOpaque, task, status );
+    }
+
+    static void onAttachmentsAdded( void* opaque, libvlc_parser_task* task,
+                                    libvlc_picture_list_t* list )
+    {
+        auto& slot = *static_cast<Slot*>( opaque );
+        if ( slot.parseCbs->on_attachments_added != nullptr )
+            slot.parseCbs->on_attachments_added( slot.opaque, task, list );
+    }
+
+    static void onThumbnailerEnded( void* opaque, libvlc_parser_task* task,
+                                    libvlc_picture_t* picture )
+    {
+        auto& slot = *static_cast<Slot*>( opaque );
+        auto cbs = slot.thumbnailerCbs;
+        auto userOpaque = slot.opaque;
+        complete( slot );
+        if ( cbs->on_ended != nullptr )
+            cbs->on_ended( userOpaque, task, picture );
+    }
+
+private:
+    Parser& m_parser;
+    std::unique_ptr<Slot[]> m_slots;
+    const uint32_t m_capacity;
+    /* Tag in the 32 upper bits, index + 1 of the first free slot below */
+    std::atomic<uint64_t> m_freeHead;
+    std::atomic<size_t> m_size;
+    /* Only used to wait for the last task in the destructor */
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    libvlc_parser_cbs m_parseCbs;
+    libvlc_thumbnailer_cbs m_thumbnailerCbs;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_PARSERTASKTABLE_HPP
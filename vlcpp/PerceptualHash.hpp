@@ -0,0 +1,336 @@
+/*****************************************************************************
+ * PerceptualHash.hpp: Perceptual hashing of thumbnails
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_PERCEPTUALHASH_HPP
+#define LIBVLC_CXX_PERCEPTUALHASH_HPP
+
+#include "Media.hpp"
+#include "Picture.hpp"
+#include "Parser.hpp"
+#include "Future.hpp"
+#include "ImageView.hpp"
+#include "PixelConvert.hpp"
+#include "HammingIndex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace VLC
+{
+
+///
+/// \brief The PerceptualHash class computes 64 bits perceptual hashes of
+/// pictures, which are close in terms of Hamming distance for pictures which
+/// look alike, even once rescaled or reencoded.
+///
+/// Two algorithms are provided: dHash, which compares the brightness of
+/// neighbouring blocks, and pHash, which compares the low frequencies of a
+/// DCT, and is more robust to contrast and gamma changes. The pictures are
+/// converted to grayscale and reduced using the PixelConvert kernels.
+///
+/// Single pictures can be ambiguous, eg. black frames or studio logos, so a
+/// media is better identified by a Fingerprint: the hashes of thumbnails
+/// taken at evenly spaced positions. The combined hash of a fingerprint can
+/// be stored in a HammingIndex to find candidate duplicates, which are then
+/// confirmed by comparing the full fingerprints.
+///
+class PerceptualHash
+{
+public:
+    enum class Algorithm
+    {
+        DHash,
+        PHash,
+    };
+
+    struct Fingerprint
+    {
+        /// The hash of each position, in timeline order
+        std::vector<uint64_t> hashes;
+        /// Whether each position could be thumbnailed and hashed
+        std::vector<uint8_t> valid;
+        /// Bitwise majority of the valid hashes
+        uint64_t combined;
+        /// Number of valid positions
+        unsigned int nbValid;
+    };
+
+    /**
+     * Compute the difference hash of a picture
+     *
+     * \throw std::invalid_argument if the view is empty
+     */
+    static uint64_t dHash( const ImageView& view )
+    {
+        auto gray = reduce( view, 9, 8 );
+        uint64_t hash = 0;
+        for ( auto y = 0u; y < 8; ++y )
+        {
+            for ( auto x = 0u; x < 8; ++x )
+            {
+                if ( gray[y * 9 + x] > gray[y * 9 + x + 1] )
+                    hash |= uint64_t{ 1 } << ( y * 8 + x );
+            }
+        }
+        return hash;
+    }
+
+    /**
+     * Compute the DCT based hash of a picture
+     *
+     * \throw std::invalid_argument if the view is empty
+     */
+    static uint64_t pHash( const ImageView& view )
+    {
+        auto gray = reduce( view, DctSize, DctSize );
+        const auto& cosines = dctCosines();
+        // Only the 8x8 lowest frequencies are needed, so the separable DCT
+        // is computed for those only
+        float rows[DctSize * 8];
+        for ( auto y = 0u; y < DctSize; ++y )
+        {
+            for ( auto u = 0u; u < 8; ++u )
+            {
+                auto sum = 0.f;
+                for ( auto x = 0u; x < DctSize; ++x )
+                    sum += gray[y * DctSize + x] * cosines[u * DctSize + x];
+                rows[y * 8 + u] = sum;
+            }
+        }
+        std::array<float, 64> coefs;
+        for ( auto v = 0u; v < 8; ++v )
+        {
+            for ( auto u = 0u; u < 8; ++u )
+            {
+                auto sum = 0.f;
+                for ( auto y = 0u; y < DctSize; ++y )
+                    sum += rows[y * 8 + u] * cosines[v * DctSize + y];
+                coefs[v * 8 + u] = sum;
+            }
+        }
+        auto sorted = coefs;
+        std::nth_element( begin( sorted ), begin( sorted ) + 32, end( sorted ) );
+        auto upper = sorted[32];
+        auto lower = *std::max_element( begin( sorted ), begin( sorted ) + 32 );
+        auto median = ( lower + upper ) / 2;
+        uint64_t hash = 0;
+        for ( auto i = 0u; i < 64; ++i )
+        {
+            if ( coefs[i] > median )
+                hash |= uint64_t{ 1 } << i;
+        }
+        return hash;
+    }
+
+    static uint64_t hash( Algorithm algorithm, const ImageView& view )
+    {
+        return algorithm == Algorithm::DHash ? dHash( view ) : pHash( view );
+    }
+
+    /**
+     * Returns the number of differing bits between two hashes
+     */
+    static uint32_t distance( uint64_t a, uint64_t b )
+    {
+        return HammingIndex::distance( a, b );
+    }
+
+    /**
+     * Returns the average distance between the hashes of the positions valid
+     * in both fingerprints, or 64 if there are none
+     */
+    static uint32_t distance( const Fingerprint& a, const Fingerprint& b )
+    {
+        auto n = std::min( a.hashes.size(), b.hashes.size() );
+        uint32_t total = 0;
+        uint32_t count = 0;
+        for ( auto i = 0u; i < n; ++i )
+        {
+            if ( a.valid[i] == 0 || b.valid[i] == 0 )
+                continue;
+            total += distance( a.hashes[i], b.hashes[i] );
+            ++count;
+        }
+        if ( count == 0 )
+            return 64;
+        return ( total + count / 2 ) / count;
+    }
+
+    /**
+     * Combine hashes in a single one, by majority vote of each bit
+     */
+    static uint64_t combine( const std::vector<uint64_t>& hashes )
+    {
+        uint64_t res = 0;
+        for ( auto bit = 0u; bit < 64; ++bit )
+        {
+            size_t count = 0;
+            for ( auto h : hashes )
+                count += ( h >> bit ) & 1;
+            if ( count * 2 > hashes.size() )
+                res |= uint64_t{ 1 } << bit;
+        }
+        return res;
+    }
+
+    /**
+     * Fingerprint a media, by hashing thumbnails taken at evenly spaced
+     * positions. The thumbnail requests are all queued at once, and each
+     * thumbnail is hashed from the thumbnailer thread which provides it.
+     *
+     * \param parser The parser used to generate the thumbnails
+     * \param media The media to fingerprint
+     * \param positions The number of thumbnails
+     * \param algorithm The hash algorithm
+     * \param size The thumbnails bounding box size. Hashing works on tiny
+     *             images, so there is no point in generating large ones.
+     * \return A future which becomes ready once all the positions are hashed
+     * \throw std::invalid_argument if positions is 0
+     */
+    static Future<Fingerprint> fingerprint( Parser& parser, Media& media, unsigned int positions,
+                                            Algorithm algorithm = Algorithm::PHash,
+                                            unsigned int size = 64 )
+    {
+        if ( positions == 0 )
+            throw std::invalid_argument( "A fingerprint needs at least one position" );
+        struct State
+        {
+            Promise<Fingerprint> promise;
+            Fingerprint fingerprint;
+            std::atomic<size_t> remaining;
+        };
+        auto state = std::make_shared<State>();
+        state->fingerprint.hashes.resize( positions );
+        state->fingerprint.valid.resize( positions );
+        state->remaining = positions + 1;
+        auto res = state->promise.future();
+        auto done = [state]() {
+            if ( --state->remaining != 0 )
+                return;
+            auto& fp = state->fingerprint;
+            std::vector<uint64_t> valid;
+            for ( auto i = 0u; i < fp.hashes.size(); ++i )
+            {
+                if ( fp.valid[i] != 0 )
+                    valid.push_back( fp.hashes[i] );
+            }
+            fp.combined = combine( valid );
+            fp.nbValid = static_cast<unsigned int>( valid.size() );
+            state->promise.setValue( std::move( fp ) );
+        };
+        for ( auto i = 0u; i < positions; ++i )
+        {
+            Parser::ThumbnailerRequest req( media );
+            req.setSize( size, size )
+               .setPictureType( Picture::Type::Argb )
+               .setSeekPosition( ( i + .5 ) / positions, Parser::ThumbnailSeekSpeed::Fast );
+            // Positions are disjoint, so they can be filled concurrently
+            parser.thumbnailAsync( req ).then( [state, done, i, algorithm]( const Parser::Result& r ) {
+                if ( r.status == Parser::Status::Done && r.picture.isValid() == true )
+                {
+                    try
+                    {
+                        state->fingerprint.hashes[i] = hash( algorithm, ImageView( r.picture ) );
+                        state->fingerprint.valid[i] = 1;
+                    }
+                    catch ( const std::invalid_argument& )
+                    {
+                    }
+                }
+                done();
+            } );
+        }
+        // Account for the registration, see whenAll()
+        done();
+        return res;
+    }
+
+private:
+    static constexpr uint32_t DctSize = 32;
+
+    /* cos((2x + 1) * u * pi / 64), for the 8 lowest frequencies u */
+    static const std::array<float, 8 * DctSize>& dctCosines()
+    {
+        static const std::array<float, 8 * DctSize> table = []() -> std::array<float, 8 * DctSize> {
+            std::array<float, 8 * DctSize> t;
+            const auto pi = std::acos( -1. );
+            for ( auto u = 0u; u < 8; ++u )
+            {
+                for ( auto x = 0u; x < DctSize; ++x )
+                    t[u * DctSize + x] = static_cast<float>(
+                                std::cos( ( 2 * x + 1 ) * u * pi / ( 2 * DctSize ) ) );
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    /* Returns the luma of a view, reduced to width x height. The picture is
+       halved with the box filter kernels as long as it is at least twice as
+       large as the target, and the remaining reduction is an area average */
+    static std::vector<uint8_t> reduce( const ImageView& view, uint32_t width, uint32_t height )
+    {
+        auto w = view.width();
+        auto h = view.height();
+        if ( w == 0 || h == 0 )
+            throw std::invalid_argument( "Can't hash an empty picture" );
+        std::vector<uint8_t> gray( static_cast<size_t>( w ) * h );
+        PixelConvert::toGray( PixelConvert::layout( view.format() ), view.data(), view.stride(),
+                              gray.data(), w, w, h );
+        std::vector<uint8_t> half;
+        while ( w / 2 >= width && h / 2 >= height )
+        {
+            half.resize( static_cast<size_t>( w / 2 ) * ( h / 2 ) );
+            PixelConvert::downscale( gray.data(), w, half.data(), w / 2, w, h, 1 );
+            gray.swap( half );
+            w /= 2;
+            h /= 2;
+        }
+        std::vector<uint8_t> res( static_cast<size_t>( width ) * height );
+        for ( auto y = 0u; y < height; ++y )
+        {
+            auto y0 = y * h / height;
+            auto y1 = std::max( y0 + 1, ( y + 1 ) * h / height );
+            for ( auto x = 0u; x < width; ++x )
+            {
+                auto x0 = x * w / width;
+                auto x1 = std::max( x0 + 1, ( x + 1 ) * w / width );
+                uint32_t sum = 0;
+                for ( auto sy = y0; sy < y1; ++sy )
+                {
+                    for ( auto sx = x0; sx < x1; ++sx )
+                        sum += gray[static_cast<size_t>( sy ) * w + sx];
+                }
+                auto n = ( y1 - y0 ) * ( x1 - x0 );
+                res[y * width + x] = static_cast<uint8_t>( ( sum + n / 2 ) / n );
+            }
+        }
+        return res;
+    }
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_PERCEPTUALHASH_HPP
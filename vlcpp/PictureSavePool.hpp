@@ -0,0 +1,323 @@
+/*****************************************************************************
+ * PictureSavePool.hpp: Asynchronous Picture encoding and saving
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_PICTURESAVEPOOL_HPP
+#define LIBVLC_CXX_PICTURESAVEPOOL_HPP
+
+#include "Internal.hpp"
+#include "Picture.hpp"
+#include "ImageView.hpp"
+#include "Future.hpp"
+#include "PngWriter.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace VLC
+{
+
+///
+/// \brief The PictureSavePool class saves pictures to disk from worker
+/// threads.
+///
+/// It is meant to be fed from the thumbnailer callbacks: queueing a picture
+/// only takes a reference on it, so the libvlc thumbnailer threads don't wait
+/// for the disk. Requesting Picture::Type::Argb thumbnails and saving them
+/// with Format::Png also moves the image encoding to the pool.
+///
+/// The memory held by the queued pictures is bounded: save() blocks until
+/// enough pictures are written, while trySave() never blocks and rejects the
+/// picture instead, which is what the thumbnailer callbacks should use.
+///
+class PictureSavePool
+{
+public:
+    enum class Format
+    {
+        /// Write the picture in its own format, see Picture::save()
+        Native,
+        /// Encode raw pictures as PNG. Encoded pictures are written as is.
+        Png,
+    };
+
+    struct Stats
+    {
+        uint64_t saved;
+        uint64_t failed;
+        /// Pictures refused by trySave() because the queue was full
+        uint64_t rejected;
+        /// Pictures queued, or being written
+        size_t pending;
+        /// Bytes held by the pending pictures
+        size_t pendingBytes;
+    };
+
+    /**
+     * Completion callback prototype. It is called from a worker thread, once
+     * the picture is written, or failed to be.
+     */
+    using OnSaved = std::function<void(const std::string& path, bool success)>;
+
+    /**
+     * \param maxPendingBytes The maximum size of the pictures waiting to be
+     *                        written. A single picture larger than this is
+     *                        accepted when nothing else is pending.
+     * \param nbWorkers The number of worker threads
+     * \throw std::invalid_argument if nbWorkers is 0
+     */
+    explicit PictureSavePool( size_t maxPendingBytes, unsigned int nbWorkers = 1 )
+        : m_maxPendingBytes( maxPendingBytes )
+        , m_pendingBytes( 0 )
+        , m_active( 0 )
+        , m_stopping( false )
+        , m_stats()
+    {
+        if ( nbWorkers == 0 )
+            throw std::invalid_argument( "PictureSavePool needs at least one worker" );
+        for ( auto i = 0u; i < nbWorkers; ++i )
+            m_workers.emplace_back( &PictureSavePool::work, this );
+    }
+
+    PictureSavePool( const PictureSavePool& ) = delete;
+    PictureSavePool& operator=( const PictureSavePool& ) = delete;
+
+    /**
+     * Writes all the pending pictures, then stops the workers.
+     */
+    ~PictureSavePool()
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            m_stopping = true;
+        }
+        m_workCond.notify_all();
+        for ( auto& w : m_workers )
+            w.join();
+    }
+
+    /**
+     * Queue a picture, blocking while the pending pictures use too much
+     * memory.
+     *
+     * \param picture The picture to save
+     * \param path The destination file
+     * \param format The output format
+     * \return A future holding true if the picture was saved successfully
+     */
+    Future<bool> save( Picture picture, std::string path, Format format = Format::Native )
+    {
+        Promise<bool> promise;
+        push( std::move( picture ), std::move( path ), format, completion( promise ), true );
+        return promise.future();
+    }
+
+    /**
+     * Queue a picture, blocking while the pending pictures use too much
+     * memory.
+     *
+     * \param picture The picture to save
+     * \param path The destination file
+     * \param onSaved The completion callback, can be nullptr
+     * \param format The output format
+     */
+    void save( Picture picture, std::string path, OnSaved onSaved, Format format = Format::Native )
+    {
+        push( std::move( picture ), std::move( path ), format, std::move( onSaved ), true );
+    }
+
+    /**
+     * Queue a picture, unless the pending pictures use too much memory.
+     * This never blocks.
+     *
+     * \param picture The picture to save
+     * \param path The destination file
+     * \param format The output format
+     * \return A future holding true if the picture was saved successfully,
+     *         or an invalid future if the picture was rejected
+     */
+    Future<bool> trySave( Picture picture, std::string path, Format format = Format::Native )
+    {
+        Promise<bool> promise;
+        if ( push( std::move( picture ), std::move( path ), format, completion( promise ), false ) == false )
+            return Future<bool>();
+        return promise.future();
+    }
+
+    /**
+     * Queue a picture, unless the pending pictures use too much memory.
+     * This never blocks.
+     *
+     * \param picture The picture to save
+     * \param path The destination file
+     * \param onSaved The completion callback, can be nullptr. It isn't called
+     *                if the picture is rejected.
+     * \param format The output format
+     * \return false if the picture was rejected
+     */
+    bool trySave( Picture picture, std::string path, OnSaved onSaved, Format format = Format::Native )
+    {
+        return push( std::move( picture ), std::move( path ), format, std::move( onSaved ), false );
+    }
+
+    /**
+     * Blocks until all the pending pictures are written
+     */
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+        m_idleCond.wait( lock, [this] { return m_jobs.empty() && m_active == 0; } );
+    }
+
+    Stats stats() const
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        auto s = m_stats;
+        s.pending = m_jobs.size() + m_active;
+        s.pendingBytes = m_pendingBytes;
+        return s;
+    }
+
+private:
+    struct Job
+    {
+        Picture picture;
+        std::string path;
+        Format format;
+        size_t bytes;
+        OnSaved onSaved;
+    };
+
+    static OnSaved completion( const Promise<bool>& promise )
+    {
+        return [promise]( const std::string&, bool success ) {
+            promise.setValue( success );
+        };
+    }
+
+    bool push( Picture picture, std::string path, Format format, OnSaved onSaved, bool wait )
+    {
+        if ( picture.isValid() == false )
+            throw std::invalid_argument( "Can't save an invalid picture" );
+        size_t bytes;
+        picture.buffer( &bytes );
+        {
+            std::unique_lock<std::mutex> lock( m_mutex );
+            auto fits = [this, bytes] {
+                return m_pendingBytes == 0 || m_pendingBytes + bytes <= m_maxPendingBytes;
+            };
+            if ( wait == true )
+                m_roomCond.wait( lock, fits );
+            else if ( fits() == false )
+            {
+                ++m_stats.rejected;
+                return false;
+            }
+            m_pendingBytes += bytes;
+            m_jobs.push_back( Job{ std::move( picture ), std::move( path ), format, bytes,
+                                   std::move( onSaved ) } );
+        }
+        m_workCond.notify_one();
+        return true;
+    }
+
+    static bool write( const Job& job )
+    {
+        auto type = job.picture.type();
+        if ( job.format == Format::Png &&
+             ( type == Picture::Type::Argb || type == Picture::Type::Rgba ) )
+        {
+            try
+            {
+                ImageView view( job.picture );
+                return detail::writeRawAsPng( job.path, view.data(), view.width(), view.height(),
+                                              view.stride(), type == Picture::Type::Argb );
+            }
+            catch ( const std::invalid_argument& )
+            {
+                return false;
+            }
+        }
+        return job.picture.save( job.path );
+    }
+
+    void work()
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+        while ( true )
+        {
+            m_workCond.wait( lock, [this] { return m_stopping == true || m_jobs.empty() == false; } );
+            if ( m_jobs.empty() == true )
+                return;
+            auto job = std::move( m_jobs.front() );
+            m_jobs.pop_front();
+            ++m_active;
+            lock.unlock();
+
+            auto success = write( job );
+            auto bytes = job.bytes;
+            auto onSaved = std::move( job.onSaved );
+            auto path = std::move( job.path );
+            // Release the picture before making room for another one
+            job.picture = Picture();
+
+            lock.lock();
+            m_pendingBytes -= bytes;
+            if ( success == true )
+                ++m_stats.saved;
+            else
+                ++m_stats.failed;
+            lock.unlock();
+            m_roomCond.notify_all();
+
+            if ( onSaved )
+                onSaved( path, success );
+
+            lock.lock();
+            if ( --m_active == 0 && m_jobs.empty() == true )
+                m_idleCond.notify_all();
+        }
+    }
+
+private:
+    const size_t m_maxPendingBytes;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_workCond;
+    std::condition_variable m_roomCond;
+    std::condition_variable m_idleCond;
+    std::deque<Job> m_jobs;
+    size_t m_pendingBytes;
+    unsigned int m_active;
+    bool m_stopping;
+    Stats m_stats;
+
+    std::vector<std::thread> m_workers;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_PICTURESAVEPOOL_HPP
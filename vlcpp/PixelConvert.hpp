@@ -0,0 +1,824 @@
+/*****************************************************************************
+ * PixelConvert.hpp: Pixel format conversion and downscaling kernels
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_PIXELCONVERT_HPP
+#define LIBVLC_CXX_PIXELCONVERT_HPP
+
+#include "Internal.hpp"
+#include "Picture.hpp"
+#include "ImageView.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+# define VLCPP_PIXEL_X86
+# include <emmintrin.h>
+# include <immintrin.h>
+# if defined(__GNUC__) || defined(__clang__)
+#  define VLCPP_TARGET_SSE2 __attribute__((target("sse2")))
+#  define VLCPP_TARGET_AVX2 __attribute__((target("avx2")))
+# else
+#  include <intrin.h>
+#  define VLCPP_TARGET_SSE2
+#  define VLCPP_TARGET_AVX2
+# endif
+#endif
+
+namespace VLC
+{
+
+///
+/// \brief The PixelConvert class gathers the pixel format conversion and
+/// downscaling kernels used to post process thumbnails and video frames.
+///
+/// Every kernel has a scalar implementation, and SSE2 and AVX2 ones on x86.
+/// The best implementation supported by the CPU is picked at runtime, unless
+/// a specific one is requested. All the implementations produce the exact
+/// same output.
+///
+/// The kernels work on raw buffers, such as the planes returned from the
+/// MediaPlayer::setVideoCallbacks() lock callback, or on ImageView. Source and
+/// destination buffers must not overlap.
+///
+class PixelConvert
+{
+public:
+    enum class Isa
+    {
+        /// The best implementation supported by the CPU
+        Auto,
+        Scalar,
+        Sse2,
+        Avx2,
+    };
+
+    ///
+    /// \brief The memory order of the components of 4 bytes per pixel formats
+    ///
+    enum class Layout
+    {
+        /// Picture::Type::Argb
+        Argb,
+        /// Picture::Type::Rgba
+        Rgba,
+        /// The "RV32" video chroma, whose first byte is ignored
+        Xrgb,
+        /// The "BGRA" video chroma
+        Bgra,
+    };
+
+    /**
+     * Returns the best implementation supported by the CPU
+     */
+    static Isa supportedIsa()
+    {
+        static const Isa isa = detectIsa();
+        return isa;
+    }
+
+    /**
+     * Returns the implementation which will be used for the provided request:
+     * the requested one, or the best supported one if it isn't supported.
+     */
+    static Isa resolve( Isa isa )
+    {
+        auto supported = supportedIsa();
+        if ( isa == Isa::Auto || isa > supported )
+            return supported;
+        return isa;
+    }
+
+    /**
+     * Returns the layout of a raw picture
+     *
+     * \throw std::invalid_argument if the picture type is an encoded format
+     */
+    static Layout layout( Picture::Type type )
+    {
+        switch ( type )
+        {
+        case Picture::Type::Argb:
+            return Layout::Argb;
+        case Picture::Type::Rgba:
+            return Layout::Rgba;
+        default:
+            throw std::invalid_argument( "Encoded pictures have no pixel layout" );
+        }
+    }
+
+    /**
+     * Convert 4 bytes per pixel images to BGRA. The alpha of Layout::Xrgb
+     * images is set to 0xff.
+     *
+     * \param layout The source layout
+     * \param src, srcPitch The source pixels, and the byte distance between two rows
+     * \param dst, dstPitch The destination, which must hold width * 4 bytes per row
+     * \param width, height The image dimensions, in pixels
+     * \param isa The implementation to use
+     */
+    static void toBgra( Layout layout, const uint8_t* src, uint32_t srcPitch,
+                        uint8_t* dst, uint32_t dstPitch, uint32_t width, uint32_t height,
+                        Isa isa = Isa::Auto )
+    {
+        isa = resolve( isa );
+        for ( auto y = 0u; y < height; ++y )
+        {
+            auto s = src + static_cast<size_t>( y ) * srcPitch;
+            auto d = dst + static_cast<size_t>( y ) * dstPitch;
+            size_t done = 0;
+#ifdef VLCPP_PIXEL_X86
+            if ( isa == Isa::Avx2 )
+                done = toBgraAvx2( layout, s, d, width );
+            else if ( isa == Isa::Sse2 )
+                done = toBgraSse2( layout, s, d, width );
+#endif
+            toBgraScalar( layout, s + done * 4, d + done * 4, width - done );
+        }
+    }
+
+    /**
+     * Convert 4 bytes per pixel images to 8 bits grayscale, using the BT.601
+     * luma weights. The alpha component is ignored.
+     *
+     * \param layout The source layout
+     * \param src, srcPitch The source pixels, and the byte distance between two rows
+     * \param dst, dstPitch The destination, which must hold width bytes per row
+     * \param width, height The image dimensions, in pixels
+     * \param isa The implementation to use
+     */
+    static void toGray( Layout layout, const uint8_t* src, uint32_t srcPitch,
+                        uint8_t* dst, uint32_t dstPitch, uint32_t width, uint32_t height,
+                        Isa isa = Isa::Auto )
+    {
+        isa = resolve( isa );
+        auto o = offsets( layout );
+        for ( auto y = 0u; y < height; ++y )
+        {
+            auto s = src + static_cast<size_t>( y ) * srcPitch;
+            auto d = dst + static_cast<size_t>( y ) * dstPitch;
+            size_t done = 0;
+#ifdef VLCPP_PIXEL_X86
+            if ( isa == Isa::Avx2 )
+                done = toGrayAvx2( o, s, d, width );
+            else if ( isa == Isa::Sse2 )
+                done = toGraySse2( o, s, d, width );
+#endif
+            toGrayScalar( o, s + done * 4, d + done, width - done );
+        }
+    }
+
+    /**
+     * Convert an I420 frame, as delivered to the video callbacks for the
+     * "I420" chroma, to BGRA. Limited range BT.601 is assumed.
+     *
+     * \param y, yPitch The luma plane
+     * \param u, uPitch The Cb plane, subsampled by 2 in both directions
+     * \param v, vPitch The Cr plane, subsampled by 2 in both directions
+     * \param dst, dstPitch The destination, which must hold width * 4 bytes per row
+     * \param width, height The frame dimensions, in pixels
+     * \param isa The implementation to use
+     */
+    static void i420ToBgra( const uint8_t* y, uint32_t yPitch,
+                            const uint8_t* u, uint32_t uPitch,
+                            const uint8_t* v, uint32_t vPitch,
+                            uint8_t* dst, uint32_t dstPitch, uint32_t width, uint32_t height,
+                            Isa isa = Isa::Auto )
+    {
+        isa = resolve( isa );
+        for ( auto row = 0u; row < height; ++row )
+        {
+            auto ys = y + static_cast<size_t>( row ) * yPitch;
+            auto us = u + static_cast<size_t>( row / 2 ) * uPitch;
+            auto vs = v + static_cast<size_t>( row / 2 ) * vPitch;
+            auto d = dst + static_cast<size_t>( row ) * dstPitch;
+            // The vector kernels always process an even number of pixels
+            size_t done = 0;
+#ifdef VLCPP_PIXEL_X86
+            if ( isa == Isa::Avx2 )
+                done = i420ToBgraAvx2( ys, us, vs, d, width );
+            else if ( isa == Isa::Sse2 )
+                done = i420ToBgraSse2( ys, us, vs, d, width );
+#endif
+            i420ToBgraScalar( ys + done, us + done / 2, vs + done / 2, d + done * 4, width - done );
+        }
+    }
+
+    /**
+     * Halve the dimensions of an image by averaging each 2x2 block of pixels.
+     * The last column, or row, of images with odd dimensions is dropped.
+     *
+     * \param src, srcPitch The source pixels, and the byte distance between two rows
+     * \param dst, dstPitch The destination, which must hold width / 2 pixels per row
+     * \param width, height The source dimensions, in pixels
+     * \param bytesPerPixel 4 for the 4 bytes per pixel formats, whatever
+     *                      their layout, or 1 for grayscale images and planes
+     * \param isa The implementation to use
+     * \throw std::invalid_argument if bytesPerPixel is neither 1 nor 4
+     */
+    static void downscale( const uint8_t* src, uint32_t srcPitch, uint8_t* dst, uint32_t dstPitch,
+                           uint32_t width, uint32_t height, uint32_t bytesPerPixel,
+                           Isa isa = Isa::Auto )
+    {
+        if ( bytesPerPixel != 1 && bytesPerPixel != 4 )
+            throw std::invalid_argument( "Unsupported pixel size" );
+        isa = resolve( isa );
+        auto outWidth = width / 2;
+        for ( auto y = 0u; y < height / 2; ++y )
+        {
+            auto s0 = src + static_cast<size_t>( y ) * 2 * srcPitch;
+            auto s1 = s0 + srcPitch;
+            auto d = dst + static_cast<size_t>( y ) * dstPitch;
+            size_t done = 0;
+#ifdef VLCPP_PIXEL_X86
+            if ( isa == Isa::Avx2 )
+                done = bytesPerPixel == 4 ? downscale4Avx2( s0, s1, d, outWidth ) :
+                                            downscale1Avx2( s0, s1, d, outWidth );
+            else if ( isa == Isa::Sse2 )
+                done = bytesPerPixel == 4 ? downscale4Sse2( s0, s1, d, outWidth ) :
+                                            downscale1Sse2( s0, s1, d, outWidth );
+#endif
+            auto offset = done * bytesPerPixel;
+            downscaleScalar( s0 + offset * 2, s1 + offset * 2, d + offset,
+                             outWidth - done, bytesPerPixel );
+        }
+    }
+
+    /**
+     * Convert a view to BGRA
+     *
+     * \return The converted pixels, with a stride of width * 4 bytes
+     */
+    static std::vector<uint8_t> toBgra( const ImageView& view, Isa isa = Isa::Auto )
+    {
+        std::vector<uint8_t> res( static_cast<size_t>( view.width() ) * view.height() * 4 );
+        toBgra( layout( view.format() ), view.data(), view.stride(), res.data(),
+                view.width() * 4, view.width(), view.height(), isa );
+        return res;
+    }
+
+    /**
+     * Convert a view to grayscale
+     *
+     * \return The converted pixels, with a stride of width bytes
+     */
+    static std::vector<uint8_t> toGray( const ImageView& view, Isa isa = Isa::Auto )
+    {
+        std::vector<uint8_t> res( static_cast<size_t>( view.width() ) * view.height() );
+        toGray( layout( view.format() ), view.data(), view.stride(), res.data(),
+                view.width(), view.width(), view.height(), isa );
+        return res;
+    }
+
+    /**
+     * Downscale a view to a quarter of its size, keeping its layout
+     *
+     * \return The downscaled pixels, width / 2 by height / 2, with a stride
+     *         of width / 2 * 4 bytes
+     */
+    static std::vector<uint8_t> downscale( const ImageView& view, Isa isa = Isa::Auto )
+    {
+        auto outWidth = view.width() / 2;
+        std::vector<uint8_t> res( static_cast<size_t>( outWidth ) * ( view.height() / 2 ) * 4 );
+        downscale( view.data(), view.stride(), res.data(), outWidth * 4,
+                   view.width(), view.height(), 4, isa );
+        return res;
+    }
+
+private:
+    /* The byte offsets of the components in a pixel */
+    struct Offsets
+    {
+        uint32_t r;
+        uint32_t g;
+        uint32_t b;
+    };
+
+    static Offsets offsets( Layout layout )
+    {
+        switch ( layout )
+        {
+        case Layout::Argb:
+        case Layout::Xrgb:
+            return Offsets{ 1, 2, 3 };
+        case Layout::Rgba:
+            return Offsets{ 0, 1, 2 };
+        case Layout::Bgra:
+        default:
+            return Offsets{ 2, 1, 0 };
+        }
+    }
+
+    static Isa detectIsa()
+    {
+#ifdef VLCPP_PIXEL_X86
+# if defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init();
+        if ( __builtin_cpu_supports( "avx2" ) )
+            return Isa::Avx2;
+        if ( __builtin_cpu_supports( "sse2" ) )
+            return Isa::Sse2;
+# else
+        int info[4];
+        __cpuid( info, 0 );
+        auto maxLeaf = info[0];
+        __cpuid( info, 1 );
+        auto sse2 = ( info[3] & ( 1 << 26 ) ) != 0;
+        // AVX2 also requires the OS to save the YMM registers
+        auto osAvx = ( info[2] & ( 1 << 27 ) ) != 0 && ( info[2] & ( 1 << 28 ) ) != 0 &&
+                     ( _xgetbv( 0 ) & 6 ) == 6;
+        if ( maxLeaf >= 7 && osAvx == true )
+        {
+            __cpuidex( info, 7, 0 );
+            if ( ( info[1] & ( 1 << 5 ) ) != 0 )
+                return Isa::Avx2;
+        }
+        if ( sse2 == true )
+            return Isa::Sse2;
+# endif
+#endif
+        return Isa::Scalar;
+    }
+
+    /*
+     * Scalar kernels. They process whole rows, or the tail of the rows
+     * processed by the vector kernels, which return the number of pixels
+     * they handled.
+     */
+
+    static uint8_t luma( uint32_t r, uint32_t g, uint32_t b )
+    {
+        return static_cast<uint8_t>( ( 77 * r + 150 * g + 29 * b + 128 ) >> 8 );
+    }
+
+    static uint8_t clamp( int32_t v )
+    {
+        return static_cast<uint8_t>( v < 0 ? 0 : ( v > 255 ? 255 : v ) );
+    }
+
+    static void toBgraScalar( Layout layout, const uint8_t* s, uint8_t* d, size_t n )
+    {
+        auto o = offsets( layout );
+        for ( size_t i = 0; i < n; ++i, s += 4, d += 4 )
+        {
+            uint8_t a;
+            if ( layout == Layout::Argb )
+                a = s[0];
+            else if ( layout == Layout::Xrgb )
+                a = 0xff;
+            else
+                a = s[3];
+            d[0] = s[o.b];
+            d[1] = s[o.g];
+            d[2] = s[o.r];
+            d[3] = a;
+        }
+    }
+
+    static void toGrayScalar( const Offsets& o, const uint8_t* s, uint8_t* d, size_t n )
+    {
+        for ( size_t i = 0; i < n; ++i, s += 4 )
+            d[i] = luma( s[o.r], s[o.g], s[o.b] );
+    }
+
+    static void i420ToBgraScalar( const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                                  uint8_t* d, size_t n )
+    {
+        for ( size_t i = 0; i < n; ++i, d += 4 )
+        {
+            int32_t c = y[i] - 16;
+            int32_t cb = u[i / 2] - 128;
+            int32_t cr = v[i / 2] - 128;
+            d[0] = clamp( ( 298 * c + 516 * cb + 128 ) >> 8 );
+            d[1] = clamp( ( 298 * c - 100 * cb - 208 * cr + 128 ) >> 8 );
+            d[2] = clamp( ( 298 * c + 409 * cr + 128 ) >> 8 );
+            d[3] = 0xff;
+        }
+    }
+
+    static void downscaleScalar( const uint8_t* s0, const uint8_t* s1, uint8_t* d,
+                                 size_t n, uint32_t bpp )
+    {
+        for ( size_t i = 0; i < n * bpp; ++i )
+        {
+            auto k = ( i / bpp ) * 2 * bpp + i % bpp;
+            d[i] = static_cast<uint8_t>( ( s0[k] + s0[k + bpp] + s1[k] + s1[k + bpp] + 2 ) >> 2 );
+        }
+    }
+
+#ifdef VLCPP_PIXEL_X86
+    /*
+     * SSE2 kernels
+     */
+
+    VLCPP_TARGET_SSE2
+    static size_t toBgraSse2( Layout layout, const uint8_t* s, uint8_t* d, size_t n )
+    {
+        size_t i = 0;
+        if ( layout == Layout::Bgra )
+        {
+            memcpy( d, s, n * 4 );
+            return n;
+        }
+        if ( layout == Layout::Rgba )
+        {
+            // Swap the R & B bytes of each little endian 32 bits word
+            const auto ga = _mm_set1_epi32( static_cast<int>( 0xff00ff00 ) );
+            const auto low = _mm_set1_epi32( 0xff );
+            for ( ; i + 4 <= n; i += 4 )
+            {
+                auto x = _mm_loadu_si128( reinterpret_cast<const __m128i*>( s + i * 4 ) );
+                auto r = _mm_or_si128( _mm_and_si128( x, ga ),
+                                       _mm_or_si128( _mm_and_si128( _mm_srli_epi32( x, 16 ), low ),
+                                                     _mm_slli_epi32( _mm_and_si128( x, low ), 16 ) ) );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( d + i * 4 ), r );
+            }
+            return i;
+        }
+        // Argb & Xrgb: reverse the bytes of each word
+        const auto mid = _mm_set1_epi32( 0xff00 );
+        const auto alpha = _mm_set1_epi32( layout == Layout::Xrgb ? static_cast<int>( 0xff000000 ) : 0 );
+        for ( ; i + 4 <= n; i += 4 )
+        {
+            auto x = _mm_loadu_si128( reinterpret_cast<const __m128i*>( s + i * 4 ) );
+            auto r = _mm_or_si128( _mm_or_si128( _mm_slli_epi32( x, 24 ), _mm_srli_epi32( x, 24 ) ),
+                                   _mm_or_si128( _mm_slli_epi32( _mm_and_si128( x, mid ), 8 ),
+                                                 _mm_and_si128( _mm_srli_epi32( x, 8 ), mid ) ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( d + i * 4 ), _mm_or_si128( r, alpha ) );
+        }
+        return i;
+    }
+
+    /* Returns the luma of 4 pixels, in the low byte of each 32 bits lane.
+       The products and their sum fit in the low 16 bits of the lanes. */
+    VLCPP_TARGET_SSE2
+    static __m128i lumaSse2( const __m128i& x, const __m128i& rs, const __m128i& gs, const __m128i& bs )
+    {
+        const auto mask = _mm_set1_epi32( 0xff );
+        auto r = _mm_and_si128( _mm_srl_epi32( x, rs ), mask );
+        auto g = _mm_and_si128( _mm_srl_epi32( x, gs ), mask );
+        auto b = _mm_and_si128( _mm_srl_epi32( x, bs ), mask );
+        auto y = _mm_add_epi16( _mm_add_epi16( _mm_mullo_epi16( r, _mm_set1_epi32( 77 ) ),
+                                               _mm_mullo_epi16( g, _mm_set1_epi32( 150 ) ) ),
+                                _mm_add_epi16( _mm_mullo_epi16( b, _mm_set1_epi32( 29 ) ),
+                                               _mm_set1_epi32( 128 ) ) );
+        return _mm_srli_epi32( y, 8 );
+    }
+
+    VLCPP_TARGET_SSE2
+    static size_t toGraySse2( const Offsets& o, const uint8_t* s, uint8_t* d, size_t n )
+    {
+        const auto rs = _mm_cvtsi32_si128( static_cast<int>( o.r * 8 ) );
+        const auto gs = _mm_cvtsi32_si128( static_cast<int>( o.g * 8 ) );
+        const auto bs = _mm_cvtsi32_si128( static_cast<int>( o.b * 8 ) );
+        size_t i = 0;
+        for ( ; i + 16 <= n; i += 16 )
+        {
+            auto p = reinterpret_cast<const __m128i*>( s + i * 4 );
+            auto y0 = lumaSse2( _mm_loadu_si128( p ), rs, gs, bs );
+            auto y1 = lumaSse2( _mm_loadu_si128( p + 1 ), rs, gs, bs );
+            auto y2 = lumaSse2( _mm_loadu_si128( p + 2 ), rs, gs, bs );
+            auto y3 = lumaSse2( _mm_loadu_si128( p + 3 ), rs, gs, bs );
+            auto y = _mm_packus_epi16( _mm_packs_epi32( y0, y1 ), _mm_packs_epi32( y2, y3 ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( d + i ), y );
+        }
+        return i;
+    }
+
+    /* Packs two signed 16 bits coefficients, for _mm_madd_epi16 */
+    static int coefficients( int16_t lo, int16_t hi )
+    {
+        return static_cast<int>( static_cast<uint16_t>( lo ) |
+                                 ( static_cast<uint32_t>( static_cast<uint16_t>( hi ) ) << 16 ) );
+    }
+
+    /* Converts 8 pixels, provided as 16 bits lanes. The 32 bits intermediate
+       results are exact, and the final saturation matches clamp() */
+    VLCPP_TARGET_SSE2
+    static void yuvToBgraSse2( const __m128i& y, const __m128i& u, const __m128i& v, uint8_t* d )
+    {
+        auto c = _mm_sub_epi16( y, _mm_set1_epi16( 16 ) );
+        auto cb = _mm_sub_epi16( u, _mm_set1_epi16( 128 ) );
+        auto cr = _mm_sub_epi16( v, _mm_set1_epi16( 128 ) );
+        const auto round = _mm_set1_epi32( 128 );
+        const auto kr = _mm_set1_epi32( coefficients( 298, 409 ) );
+        const auto kg = _mm_set1_epi32( coefficients( 298, -100 ) );
+        const auto kgr = _mm_set1_epi32( coefficients( -208, 128 ) );
+        const auto kb = _mm_set1_epi32( coefficients( 298, 516 ) );
+        const auto one = _mm_set1_epi16( 1 );
+
+        auto ccrLo = _mm_unpacklo_epi16( c, cr );
+        auto ccrHi = _mm_unpackhi_epi16( c, cr );
+        auto ccbLo = _mm_unpacklo_epi16( c, cb );
+        auto ccbHi = _mm_unpackhi_epi16( c, cb );
+        auto crLo = _mm_unpacklo_epi16( cr, one );
+        auto crHi = _mm_unpackhi_epi16( cr, one );
+
+        auto r = _mm_packs_epi32(
+                    _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( ccrLo, kr ), round ), 8 ),
+                    _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( ccrHi, kr ), round ), 8 ) );
+        auto g = _mm_packs_epi32(
+                    _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( ccbLo, kg ), _mm_madd_epi16( crLo, kgr ) ), 8 ),
+                    _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( ccbHi, kg ), _mm_madd_epi16( crHi, kgr ) ), 8 ) );
+        auto b = _mm_packs_epi32(
+                    _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( ccbLo, kb ), round ), 8 ),
+                    _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( ccbHi, kb ), round ), 8 ) );
+
+        const auto zero = _mm_setzero_si128();
+        const auto max = _mm_set1_epi16( 255 );
+        r = _mm_min_epi16( _mm_max_epi16( r, zero ), max );
+        g = _mm_min_epi16( _mm_max_epi16( g, zero ), max );
+        b = _mm_min_epi16( _mm_max_epi16( b, zero ), max );
+        auto bg = _mm_or_si128( b, _mm_slli_epi16( g, 8 ) );
+        auto ra = _mm_or_si128( r, _mm_set1_epi16( static_cast<int16_t>( 0xff00 ) ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( d ), _mm_unpacklo_epi16( bg, ra ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( d + 16 ), _mm_unpackhi_epi16( bg, ra ) );
+    }
+
+    VLCPP_TARGET_SSE2
+    static size_t i420ToBgraSse2( const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                                  uint8_t* d, size_t n )
+    {
+        const auto zero = _mm_setzero_si128();
+        size_t i = 0;
+        for ( ; i + 16 <= n; i += 16 )
+        {
+            auto ys = _mm_loadu_si128( reinterpret_cast<const __m128i*>( y + i ) );
+            auto us = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( u + i / 2 ) );
+            auto vs = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( v + i / 2 ) );
+            // Duplicate the chroma samples horizontally
+            us = _mm_unpacklo_epi8( us, us );
+            vs = _mm_unpacklo_epi8( vs, vs );
+            yuvToBgraSse2( _mm_unpacklo_epi8( ys, zero ), _mm_unpacklo_epi8( us, zero ),
+                           _mm_unpacklo_epi8( vs, zero ), d + i * 4 );
+            yuvToBgraSse2( _mm_unpackhi_epi8( ys, zero ), _mm_unpackhi_epi8( us, zero ),
+                           _mm_unpackhi_epi8( vs, zero ), d + i * 4 + 32 );
+        }
+        return i;
+    }
+
+    /* Sums the 16 bits lanes of 4 vectors, and divides them by 4, rounding */
+    VLCPP_TARGET_SSE2
+    static __m128i average4Sse2( const __m128i& a, const __m128i& b, const __m128i& c, const __m128i& d )
+    {
+        auto sum = _mm_add_epi16( _mm_add_epi16( a, b ), _mm_add_epi16( c, d ) );
+        return _mm_srli_epi16( _mm_add_epi16( sum, _mm_set1_epi16( 2 ) ), 2 );
+    }
+
+    VLCPP_TARGET_SSE2
+    static size_t downscale4Sse2( const uint8_t* s0, const uint8_t* s1, uint8_t* d, size_t n )
+    {
+        const auto zero = _mm_setzero_si128();
+        size_t i = 0;
+        for ( ; i + 4 <= n; i += 4 )
+        {
+            auto p0 = reinterpret_cast<const __m128i*>( s0 + i * 8 );
+            auto p1 = reinterpret_cast<const __m128i*>( s1 + i * 8 );
+            auto a0 = _mm_castsi128_ps( _mm_loadu_si128( p0 ) );
+            auto b0 = _mm_castsi128_ps( _mm_loadu_si128( p0 + 1 ) );
+            auto a1 = _mm_castsi128_ps( _mm_loadu_si128( p1 ) );
+            auto b1 = _mm_castsi128_ps( _mm_loadu_si128( p1 + 1 ) );
+            // Split the even and odd pixels
+            auto e0 = _mm_castps_si128( _mm_shuffle_ps( a0, b0, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+            auto o0 = _mm_castps_si128( _mm_shuffle_ps( a0, b0, _MM_SHUFFLE( 3, 1, 3, 1 ) ) );
+            auto e1 = _mm_castps_si128( _mm_shuffle_ps( a1, b1, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+            auto o1 = _mm_castps_si128( _mm_shuffle_ps( a1, b1, _MM_SHUFFLE( 3, 1, 3, 1 ) ) );
+            auto lo = average4Sse2( _mm_unpacklo_epi8( e0, zero ), _mm_unpacklo_epi8( o0, zero ),
+                                    _mm_unpacklo_epi8( e1, zero ), _mm_unpacklo_epi8( o1, zero ) );
+            auto hi = average4Sse2( _mm_unpackhi_epi8( e0, zero ), _mm_unpackhi_epi8( o0, zero ),
+                                    _mm_unpackhi_epi8( e1, zero ), _mm_unpackhi_epi8( o1, zero ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( d + i * 4 ), _mm_packus_epi16( lo, hi ) );
+        }
+        return i;
+    }
+
+    VLCPP_TARGET_SSE2
+    static size_t downscale1Sse2( const uint8_t* s0, const uint8_t* s1, uint8_t* d, size_t n )
+    {
+        const auto mask = _mm_set1_epi16( 0xff );
+        size_t i = 0;
+        for ( ; i + 16 <= n; i += 16 )
+        {
+            auto p0 = reinterpret_cast<const __m128i*>( s0 + i * 2 );
+            auto p1 = reinterpret_cast<const __m128i*>( s1 + i * 2 );
+            __m128i res[2];
+            for ( auto k = 0; k < 2; ++k )
+            {
+                auto a = _mm_loadu_si128( p0 + k );
+                auto b = _mm_loadu_si128( p1 + k );
+                res[k] = average4Sse2( _mm_and_si128( a, mask ), _mm_srli_epi16( a, 8 ),
+                                       _mm_and_si128( b, mask ), _mm_srli_epi16( b, 8 ) );
+            }
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( d + i ), _mm_packus_epi16( res[0], res[1] ) );
+        }
+        return i;
+    }
+
+    /*
+     * AVX2 kernels. They fall back to the SSE2 ones for the end of the rows.
+     * Since the 256 bits pack and unpack instructions operate on each 128
+     * bits lane independently, the results are permuted back in order
+     * before being stored.
+     */
+
+    VLCPP_TARGET_AVX2
+    static size_t toBgraAvx2( Layout layout, const uint8_t* s, uint8_t* d, size_t n )
+    {
+        if ( layout == Layout::Bgra )
+            return toBgraSse2( layout, s, d, n );
+        __m256i shuffle;
+        if ( layout == Layout::Rgba )
+            shuffle = _mm256_setr_epi8( 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15 );
+        else
+            shuffle = _mm256_setr_epi8( 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 );
+        const auto alpha = _mm256_set1_epi32( layout == Layout::Xrgb ? static_cast<int>( 0xff000000 ) : 0 );
+        size_t i = 0;
+        for ( ; i + 8 <= n; i += 8 )
+        {
+            auto x = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( s + i * 4 ) );
+            x = _mm256_or_si256( _mm256_shuffle_epi8( x, shuffle ), alpha );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d + i * 4 ), x );
+        }
+        return i + toBgraSse2( layout, s + i * 4, d + i * 4, n - i );
+    }
+
+    VLCPP_TARGET_AVX2
+    static __m256i lumaAvx2( const __m256i& x, const __m128i& rs, const __m128i& gs, const __m128i& bs )
+    {
+        const auto mask = _mm256_set1_epi32( 0xff );
+        auto r = _mm256_and_si256( _mm256_srl_epi32( x, rs ), mask );
+        auto g = _mm256_and_si256( _mm256_srl_epi32( x, gs ), mask );
+        auto b = _mm256_and_si256( _mm256_srl_epi32( x, bs ), mask );
+        auto y = _mm256_add_epi16( _mm256_add_epi16( _mm256_mullo_epi16( r, _mm256_set1_epi32( 77 ) ),
+                                                     _mm256_mullo_epi16( g, _mm256_set1_epi32( 150 ) ) ),
+                                   _mm256_add_epi16( _mm256_mullo_epi16( b, _mm256_set1_epi32( 29 ) ),
+                                                     _mm256_set1_epi32( 128 ) ) );
+        return _mm256_srli_epi32( y, 8 );
+    }
+
+    VLCPP_TARGET_AVX2
+    static size_t toGrayAvx2( const Offsets& o, const uint8_t* s, uint8_t* d, size_t n )
+    {
+        const auto rs = _mm_cvtsi32_si128( static_cast<int>( o.r * 8 ) );
+        const auto gs = _mm_cvtsi32_si128( static_cast<int>( o.g * 8 ) );
+        const auto bs = _mm_cvtsi32_si128( static_cast<int>( o.b * 8 ) );
+        const auto order = _mm256_setr_epi32( 0, 4, 1, 5, 2, 6, 3, 7 );
+        size_t i = 0;
+        for ( ; i + 32 <= n; i += 32 )
+        {
+            auto p = reinterpret_cast<const __m256i*>( s + i * 4 );
+            auto y0 = lumaAvx2( _mm256_loadu_si256( p ), rs, gs, bs );
+            auto y1 = lumaAvx2( _mm256_loadu_si256( p + 1 ), rs, gs, bs );
+            auto y2 = lumaAvx2( _mm256_loadu_si256( p + 2 ), rs, gs, bs );
+            auto y3 = lumaAvx2( _mm256_loadu_si256( p + 3 ), rs, gs, bs );
+            auto y = _mm256_packus_epi16( _mm256_packs_epi32( y0, y1 ), _mm256_packs_epi32( y2, y3 ) );
+            y = _mm256_permutevar8x32_epi32( y, order );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d + i ), y );
+        }
+        return i + toGraySse2( o, s + i * 4, d + i, n - i );
+    }
+
+    VLCPP_TARGET_AVX2
+    static size_t i420ToBgraAvx2( const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                                  uint8_t* d, size_t n )
+    {
+        const auto round = _mm256_set1_epi32( 128 );
+        const auto kr = _mm256_set1_epi32( coefficients( 298, 409 ) );
+        const auto kg = _mm256_set1_epi32( coefficients( 298, -100 ) );
+        const auto kgr = _mm256_set1_epi32( coefficients( -208, 128 ) );
+        const auto kb = _mm256_set1_epi32( coefficients( 298, 516 ) );
+        const auto one = _mm256_set1_epi16( 1 );
+        const auto zero = _mm256_setzero_si256();
+        const auto max = _mm256_set1_epi16( 255 );
+        size_t i = 0;
+        for ( ; i + 16 <= n; i += 16 )
+        {
+            auto us = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( u + i / 2 ) );
+            auto vs = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( v + i / 2 ) );
+            auto c = _mm256_sub_epi16( _mm256_cvtepu8_epi16(
+                                           _mm_loadu_si128( reinterpret_cast<const __m128i*>( y + i ) ) ),
+                                       _mm256_set1_epi16( 16 ) );
+            auto cb = _mm256_sub_epi16( _mm256_cvtepu8_epi16( _mm_unpacklo_epi8( us, us ) ),
+                                        _mm256_set1_epi16( 128 ) );
+            auto cr = _mm256_sub_epi16( _mm256_cvtepu8_epi16( _mm_unpacklo_epi8( vs, vs ) ),
+                                        _mm256_set1_epi16( 128 ) );
+
+            auto ccrLo = _mm256_unpacklo_epi16( c, cr );
+            auto ccrHi = _mm256_unpackhi_epi16( c, cr );
+            auto ccbLo = _mm256_unpacklo_epi16( c, cb );
+            auto ccbHi = _mm256_unpackhi_epi16( c, cb );
+            auto crLo = _mm256_unpacklo_epi16( cr, one );
+            auto crHi = _mm256_unpackhi_epi16( cr, one );
+
+            auto r = _mm256_packs_epi32(
+                        _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( ccrLo, kr ), round ), 8 ),
+                        _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( ccrHi, kr ), round ), 8 ) );
+            auto g = _mm256_packs_epi32(
+                        _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( ccbLo, kg ),
+                                                             _mm256_madd_epi16( crLo, kgr ) ), 8 ),
+                        _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( ccbHi, kg ),
+                                                             _mm256_madd_epi16( crHi, kgr ) ), 8 ) );
+            auto b = _mm256_packs_epi32(
+                        _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( ccbLo, kb ), round ), 8 ),
+                        _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( ccbHi, kb ), round ), 8 ) );
+
+            r = _mm256_min_epi16( _mm256_max_epi16( r, zero ), max );
+            g = _mm256_min_epi16( _mm256_max_epi16( g, zero ), max );
+            b = _mm256_min_epi16( _mm256_max_epi16( b, zero ), max );
+            auto bg = _mm256_or_si256( b, _mm256_slli_epi16( g, 8 ) );
+            auto ra = _mm256_or_si256( r, _mm256_set1_epi16( static_cast<int16_t>( 0xff00 ) ) );
+            auto lo = _mm256_unpacklo_epi16( bg, ra );
+            auto hi = _mm256_unpackhi_epi16( bg, ra );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d + i * 4 ),
+                                 _mm256_permute2x128_si256( lo, hi, 0x20 ) );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d + i * 4 + 32 ),
+                                 _mm256_permute2x128_si256( lo, hi, 0x31 ) );
+        }
+        return i + i420ToBgraSse2( y + i, u + i / 2, v + i / 2, d + i * 4, n - i );
+    }
+
+    VLCPP_TARGET_AVX2
+    static __m256i average4Avx2( const __m256i& a, const __m256i& b, const __m256i& c, const __m256i& d )
+    {
+        auto sum = _mm256_add_epi16( _mm256_add_epi16( a, b ), _mm256_add_epi16( c, d ) );
+        return _mm256_srli_epi16( _mm256_add_epi16( sum, _mm256_set1_epi16( 2 ) ), 2 );
+    }
+
+    VLCPP_TARGET_AVX2
+    static size_t downscale4Avx2( const uint8_t* s0, const uint8_t* s1, uint8_t* d, size_t n )
+    {
+        const auto zero = _mm256_setzero_si256();
+        size_t i = 0;
+        for ( ; i + 8 <= n; i += 8 )
+        {
+            auto p0 = reinterpret_cast<const __m256i*>( s0 + i * 8 );
+            auto p1 = reinterpret_cast<const __m256i*>( s1 + i * 8 );
+            auto a0 = _mm256_castsi256_ps( _mm256_loadu_si256( p0 ) );
+            auto b0 = _mm256_castsi256_ps( _mm256_loadu_si256( p0 + 1 ) );
+            auto a1 = _mm256_castsi256_ps( _mm256_loadu_si256( p1 ) );
+            auto b1 = _mm256_castsi256_ps( _mm256_loadu_si256( p1 + 1 ) );
+            auto e0 = _mm256_castps_si256( _mm256_shuffle_ps( a0, b0, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+            auto o0 = _mm256_castps_si256( _mm256_shuffle_ps( a0, b0, _MM_SHUFFLE( 3, 1, 3, 1 ) ) );
+            auto e1 = _mm256_castps_si256( _mm256_shuffle_ps( a1, b1, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+            auto o1 = _mm256_castps_si256( _mm256_shuffle_ps( a1, b1, _MM_SHUFFLE( 3, 1, 3, 1 ) ) );
+            auto lo = average4Avx2( _mm256_unpacklo_epi8( e0, zero ), _mm256_unpacklo_epi8( o0, zero ),
+                                    _mm256_unpacklo_epi8( e1, zero ), _mm256_unpacklo_epi8( o1, zero ) );
+            auto hi = average4Avx2( _mm256_unpackhi_epi8( e0, zero ), _mm256_unpackhi_epi8( o0, zero ),
+                                    _mm256_unpackhi_epi8( e1, zero ), _mm256_unpackhi_epi8( o1, zero ) );
+            auto res = _mm256_permute4x64_epi64( _mm256_packus_epi16( lo, hi ), _MM_SHUFFLE( 3, 1, 2, 0 ) );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d + i * 4 ), res );
+        }
+        return i + downscale4Sse2( s0 + i * 8, s1 + i * 8, d + i * 4, n - i );
+    }
+
+    VLCPP_TARGET_AVX2
+    static size_t downscale1Avx2( const uint8_t* s0, const uint8_t* s1, uint8_t* d, size_t n )
+    {
+        const auto mask = _mm256_set1_epi16( 0xff );
+        size_t i = 0;
+        for ( ; i + 32 <= n; i += 32 )
+        {
+            auto p0 = reinterpret_cast<const __m256i*>( s0 + i * 2 );
+            auto p1 = reinterpret_cast<const __m256i*>( s1 + i * 2 );
+            __m256i res[2];
+            for ( auto k = 0; k < 2; ++k )
+            {
+                auto a = _mm256_loadu_si256( p0 + k );
+                auto b = _mm256_loadu_si256( p1 + k );
+                res[k] = average4Avx2( _mm256_and_si256( a, mask ), _mm256_srli_epi16( a, 8 ),
+                                       _mm256_and_si256( b, mask ), _mm256_srli_epi16( b, 8 ) );
+            }
+            auto out = _mm256_permute4x64_epi64( _mm256_packus_epi16( res[0], res[1] ),
+                                                 _MM_SHUFFLE( 3, 1, 2, 0 ) );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d + i ), out );
+        }
+        return i + downscale1Sse2( s0 + i * 2, s1 + i * 2, d + i, n - i );
+    }
+#endif
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_PIXELCONVERT_HPP
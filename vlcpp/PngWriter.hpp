@@ -0,0 +1,158 @@
+/*****************************************************************************
+ * PngWriter.hpp: Minimal PNG writer for raw pictures
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_PNGWRITER_HPP
+#define LIBVLC_CXX_PNGWRITER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace VLC
+{
+
+namespace detail
+{
+    inline uint32_t crc32( const uint8_t* data, size_t size, uint32_t crc = 0 )
+    {
+        static uint32_t table[256];
+        static bool init = [] {
+            for ( uint32_t i = 0; i < 256; ++i )
+            {
+                auto c = i;
+                for ( auto k = 0; k < 8; ++k )
+                    c = c & 1 ? 0xEDB88320u ^ ( c >> 1 ) : c >> 1;
+                table[i] = c;
+            }
+            return true;
+        }();
+        (void)init;
+        crc = ~crc;
+        for ( size_t i = 0; i < size; ++i )
+            crc = table[( crc ^ data[i] ) & 0xFF] ^ ( crc >> 8 );
+        return ~crc;
+    }
+
+    inline void putBE32( std::vector<uint8_t>& out, uint32_t v )
+    {
+        out.push_back( static_cast<uint8_t>( v >> 24 ) );
+        out.push_back( static_cast<uint8_t>( v >> 16 ) );
+        out.push_back( static_cast<uint8_t>( v >> 8 ) );
+        out.push_back( static_cast<uint8_t>( v ) );
+    }
+
+    inline bool writePngChunk( FILE* f, const char* type, const std::vector<uint8_t>& data )
+    {
+        std::vector<uint8_t> chunk;
+        chunk.reserve( data.size() + 12 );
+        putBE32( chunk, static_cast<uint32_t>( data.size() ) );
+        chunk.insert( end( chunk ), type, type + 4 );
+        chunk.insert( end( chunk ), begin( data ), end( data ) );
+        putBE32( chunk, crc32( chunk.data() + 4, chunk.size() - 4 ) );
+        return fwrite( chunk.data(), chunk.size(), 1, f ) == 1;
+    }
+
+    /**
+     * Write an Argb or Rgba image as a PNG file.
+     *
+     * This doesn't compress the image: the pixels are stored in uncompressed
+     * deflate blocks, which any PNG decoder supports. Re-encode the file if its
+     * size matters.
+     *
+     * \param argb true if the pixels are stored as A, R, G, B bytes, false if
+     *             they are stored as R, G, B, A bytes
+     */
+    inline bool writeRawAsPng( const std::string& path, const uint8_t* pixels,
+                               uint32_t width, uint32_t height, size_t stride, bool argb )
+    {
+        // Filter type byte + RGBA pixels for each line
+        std::vector<uint8_t> raw;
+        raw.reserve( ( width * 4 + 1 ) * height );
+        for ( auto y = 0u; y < height; ++y )
+        {
+            raw.push_back( 0 );
+            auto line = pixels + y * stride;
+            if ( argb == false )
+            {
+                raw.insert( end( raw ), line, line + width * 4 );
+                continue;
+            }
+            for ( auto x = 0u; x < width; ++x )
+            {
+                raw.push_back( line[x * 4 + 1] );
+                raw.push_back( line[x * 4 + 2] );
+                raw.push_back( line[x * 4 + 3] );
+                raw.push_back( line[x * 4] );
+            }
+        }
+
+        std::vector<uint8_t> zlib;
+        zlib.reserve( raw.size() + raw.size() / 65535 * 5 + 11 );
+        zlib.push_back( 0x78 );
+        zlib.push_back( 0x01 );
+        size_t pos = 0;
+        do
+        {
+            auto len = static_cast<uint16_t>( std::min<size_t>( raw.size() - pos, 65535 ) );
+            zlib.push_back( pos + len == raw.size() ? 1 : 0 );
+            zlib.push_back( static_cast<uint8_t>( len ) );
+            zlib.push_back( static_cast<uint8_t>( len >> 8 ) );
+            zlib.push_back( static_cast<uint8_t>( ~len ) );
+            zlib.push_back( static_cast<uint8_t>( ~len >> 8 ) );
+            zlib.insert( end( zlib ), raw.data() + pos, raw.data() + pos + len );
+            pos += len;
+        } while ( pos < raw.size() );
+        uint32_t a = 1, b = 0;
+        for ( auto c : raw )
+        {
+            a = ( a + c ) % 65521;
+            b = ( b + a ) % 65521;
+        }
+        putBE32( zlib, b << 16 | a );
+
+        std::vector<uint8_t> header;
+        putBE32( header, width );
+        putBE32( header, height );
+        // 8 bits per channel, RGBA, deflate, adaptive filtering, no interlace
+        header.insert( end( header ), { 8, 6, 0, 0, 0 } );
+
+        auto f = fopen( path.c_str(), "wb" );
+        if ( f == nullptr )
+            return false;
+        static const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        auto success = fwrite( signature, sizeof( signature ), 1, f ) == 1 &&
+                writePngChunk( f, "IHDR", header ) &&
+                writePngChunk( f, "IDAT", zlib ) &&
+                writePngChunk( f, "IEND", {} );
+        return fclose( f ) == 0 && success;
+    }
+
+    inline bool writeArgbAsPng( const std::string& path, const uint8_t* pixels,
+                                uint32_t width, uint32_t height, size_t stride )
+    {
+        return writeRawAsPng( path, pixels, width, height, stride, true );
+    }
+}
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_PNGWRITER_HPP
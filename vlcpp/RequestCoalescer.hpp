@@ -0,0 +1,210 @@
+/*****************************************************************************
+ * RequestCoalescer.hpp: Deduplication of identical in flight Parser requests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_REQUESTCOALESCER_HPP
+#define LIBVLC_CXX_REQUESTCOALESCER_HPP
+
+#include "Media.hpp"
+#include "Parser.hpp"
+#include "Future.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace VLC
+{
+
+///
+/// \brief The RequestCoalescer class merges identical Parser requests which
+/// are in flight at the same time.
+///
+/// Requests are identified by their parameters: the media instance and parse
+/// flags for parse requests, the media MRL, seek request, size, crop flag,
+/// picture type and hardware decoding flag for thumbnailer requests. A
+/// request identical to one still in flight doesn't reach libvlc: the caller
+/// gets another handle on the pending result instead, and the single result
+/// is fanned out to all of them.
+///
+/// Parsing stores its results in the media instance, so only parse requests
+/// for the same Media instance are merged. Thumbnailer requests for distinct
+/// instances with the same MRL are merged, in which case Parser::Result::media
+/// is the media of the request which reached libvlc. The media options
+/// aren't part of the thumbnailer request identity, as libvlc doesn't expose
+/// them: requests for medias which only differ by their options must not be
+/// queued to the same coalescer.
+///
+/// Finished requests are forgotten, see ThumbnailCache or ParseCache to
+/// reuse results afterward.
+///
+class RequestCoalescer
+{
+public:
+    struct Stats
+    {
+        /// Requests handed to libvlc
+        uint64_t queued;
+        /// Requests attached to an identical request in flight
+        uint64_t coalesced;
+        /// Distinct requests currently in flight
+        size_t inFlight;
+    };
+
+    /**
+     * \param parser The parser to queue requests to. It must outlive the
+     * coalescer.
+     */
+    explicit RequestCoalescer( Parser& parser )
+        : m_parser( parser )
+        , m_nextId( 0 )
+        , m_stats()
+    {
+    }
+
+    RequestCoalescer( const RequestCoalescer& ) = delete;
+    RequestCoalescer& operator=( const RequestCoalescer& ) = delete;
+
+    /**
+     * Waits for the requests in flight to finish.
+     */
+    ~RequestCoalescer()
+    {
+        std::unique_lock<std::recursive_mutex> lock( m_mutex );
+        m_cond.wait( lock, [this] { return m_inFlight.empty(); } );
+    }
+
+    /**
+     * Parse a media, or join the parse request in flight for the same media
+     * instance and flags.
+     *
+     * \param media the media to parse
+     * \param flags the parse flags, \ref Parser::ParseFlags
+     * \return a future which becomes ready once the request finishes
+     *
+     * \see Parser::parseAsync()
+     */
+    Future<Parser::Result> parse( Media media, Parser::ParseFlags flags = Parser::ParseFlags::Parse )
+    {
+        // The request in flight holds a reference on its media, so the
+        // address can't be reused by another media meanwhile
+        std::string key( 1, 'p' );
+        append( key, media.get() );
+        append( key, static_cast<int32_t>( flags ) );
+        return coalesce( key, [this, &media, flags] {
+            return m_parser.parseAsync( std::move( media ), flags );
+        } );
+    }
+
+    /**
+     * Generate a thumbnail, or join the identical thumbnailer request in
+     * flight.
+     *
+     * The request user context and the media options aren't part of the
+     * request identity, and are ignored.
+     *
+     * \param request the thumbnail generation request
+     * \return a future which becomes ready once the request finishes
+     *
+     * \see Parser::thumbnailAsync()
+     */
+    Future<Parser::Result> thumbnail( const Parser::ThumbnailerRequest& request )
+    {
+        std::string key( 1, 't' );
+        key += request.media().mrl();
+        key.push_back( '\0' );
+        append( key, static_cast<int32_t>( request.seekType() ) );
+        if ( request.seekType() == Parser::SeekType::Time )
+            append( key, static_cast<int64_t>( request.seekTime().count() ) );
+        else if ( request.seekType() == Parser::SeekType::Position )
+            append( key, request.seekPosition() );
+        append( key, static_cast<int32_t>( request.seekSpeed() ) );
+        append( key, static_cast<uint32_t>( request.width() ) );
+        append( key, static_cast<uint32_t>( request.height() ) );
+        append( key, static_cast<uint8_t>( request.crop() ) );
+        append( key, static_cast<int32_t>( request.pictureType() ) );
+        append( key, static_cast<uint8_t>( request.hwDec() ) );
+        return coalesce( key, [this, &request] {
+            return m_parser.thumbnailAsync( request );
+        } );
+    }
+
+    Stats stats() const
+    {
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        auto s = m_stats;
+        s.inFlight = m_inFlight.size();
+        return s;
+    }
+
+private:
+    struct InFlight
+    {
+        uint64_t id;
+        Future<Parser::Result> future;
+    };
+
+    template <typename T>
+    static void append( std::string& key, T value )
+    {
+        key.append( reinterpret_cast<const char*>( &value ), sizeof( value ) );
+    }
+
+    template <typename Queue>
+    Future<Parser::Result> coalesce( const std::string& key, Queue&& queue )
+    {
+        // The mutex is recursive, since the continuation runs from this
+        // thread if the request already finished when it is registered
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        auto it = m_inFlight.find( key );
+        if ( it != end( m_inFlight ) )
+        {
+            ++m_stats.coalesced;
+            return it->second.future;
+        }
+        auto future = queue();
+        auto id = m_nextId++;
+        m_inFlight.emplace( key, InFlight{ id, future } );
+        ++m_stats.queued;
+        // Registered before any waiter continuation, so the request is
+        // forgotten before its result is delivered
+        future.then( [this, key, id]( const Parser::Result& ) {
+            std::lock_guard<std::recursive_mutex> inFlightLock( m_mutex );
+            auto entry = m_inFlight.find( key );
+            if ( entry != end( m_inFlight ) && entry->second.id == id )
+                m_inFlight.erase( entry );
+            m_cond.notify_all();
+        } );
+        return future;
+    }
+
+private:
+    Parser& m_parser;
+
+    mutable std::recursive_mutex m_mutex;
+    std::condition_variable_any m_cond;
+    std::unordered_map<std::string, InFlight> m_inFlight;
+    uint64_t m_nextId;
+    Stats m_stats;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_REQUESTCOALESCER_HPP
@@ -0,0 +1,826 @@
+/*****************************************************************************
+ * SharedFrameRing.hpp: Video frames exported through shared memory
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_SHAREDFRAMERING_HPP
+#define LIBVLC_CXX_SHAREDFRAMERING_HPP
+
+#if defined(__linux__)
+
+// Not part of the vlc.hpp umbrella header, which this header depends on
+#include "vlc.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* Older C libraries, such as glibc before 2.27 or bionic before API 30, don't
+   expose memfd_create(), so it is called through syscall() */
+#ifndef MFD_CLOEXEC
+# define MFD_CLOEXEC 0x0001U
+#endif
+#ifndef MFD_ALLOW_SEALING
+# define MFD_ALLOW_SEALING 0x0002U
+#endif
+#ifndef F_ADD_SEALS
+# define F_ADD_SEALS ( 1024 + 9 )
+# define F_SEAL_SEAL 0x0001
+# define F_SEAL_SHRINK 0x0002
+# define F_SEAL_GROW 0x0004
+#endif
+
+namespace VLC
+{
+
+namespace detail
+{
+
+/* The layout of the shared memory, which is mapped by processes built
+   separately: it only holds fixed size types, and address free atomics */
+namespace ring
+{
+
+static constexpr uint32_t Magic = 0x564c4352; // "VLCR"
+static constexpr uint32_t Version = 1;
+
+static_assert( ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+               "The shared ring needs lock free atomics" );
+
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t nbSlots;
+    uint32_t nbDescriptors;
+    uint64_t slotSize;
+    uint64_t slotHeadersOffset;
+    uint64_t descriptorsOffset;
+    uint64_t slotsOffset;
+    uint64_t size;
+    char chroma[8];
+    uint32_t width;
+    uint32_t height;
+    uint32_t nbPlanes;
+    uint32_t pitches[VideoFormat::MaxPlanes];
+    uint32_t lines[VideoFormat::MaxPlanes];
+    uint32_t planeOffsets[VideoFormat::MaxPlanes];
+    /* Sequence of the last published frame, 0 before the first one */
+    alignas( 64 ) std::atomic<uint64_t> head;
+    /* The low bits of head, which consumers wait on */
+    std::atomic<uint32_t> futex;
+    std::atomic<uint32_t> waiters;
+    std::atomic<uint32_t> closed;
+};
+
+struct SlotHeader
+{
+    /* Sequence of the frame in the slot, 0 while it's being written */
+    std::atomic<uint64_t> sequence;
+    /* Number of consumers reading the slot */
+    std::atomic<uint32_t> readers;
+};
+
+/* Published frames, indexed by sequence. The sequence is cleared while the
+   descriptor is rewritten, so readers can detect it */
+struct Descriptor
+{
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint32_t> slot;
+    std::atomic<int64_t> pts;
+};
+
+inline uint64_t align( uint64_t v, uint64_t alignment )
+{
+    return ( v + alignment - 1 ) / alignment * alignment;
+}
+
+inline int futex( std::atomic<uint32_t>* word, int op, uint32_t value, const timespec* timeout )
+{
+    static_assert( sizeof( *word ) == sizeof( uint32_t ), "Unexpected atomic size" );
+    return static_cast<int>( syscall( SYS_futex, reinterpret_cast<uint32_t*>( word ), op, value,
+                                      timeout, nullptr, 0 ) );
+}
+
+inline int memfdCreate( const char* name, unsigned int flags )
+{
+    return static_cast<int>( syscall( SYS_memfd_create, name, flags ) );
+}
+
+inline int64_t monotonicTime()
+{
+    timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return static_cast<int64_t>( ts.tv_sec ) * 1000000 + ts.tv_nsec / 1000;
+}
+
+}
+
+}
+
+///
+/// \brief The SharedFrameSink class implements the video callbacks of a
+/// MediaPlayer on top of a ring of frames in shared memory, so that other
+/// processes can read the frames as they are decoded, without any copy.
+///
+/// The ring is a memfd, whose file descriptor is passed to the consumer
+/// processes, for instance by fork() or over a unix socket. Consumers map it
+/// with SharedFrameConsumer.
+///
+/// This header is only available on Linux, and isn't included by vlc.hpp:
+/// include vlcpp/SharedFrameRing.hpp explicitly to use it.
+///
+/// The frame format is fixed when the sink is created, libvlc scaling the
+/// video as needed, so that consumers can map the ring at any time. Each
+/// displayed frame is published as a descriptor holding its slot and date,
+/// and consumers waiting for frames are woken up through a futex.
+///
+/// The video output never waits for the consumers: it decodes to the oldest
+/// slot which no consumer is reading, and drops the frame if there is none.
+/// A consumer process which dies while reading a frame leaks its slot until
+/// the sink is destroyed.
+///
+class SharedFrameSink
+{
+public:
+    struct Stats
+    {
+        uint64_t published;
+        /// Frames dropped because consumers were reading all the slots
+        uint64_t dropped;
+    };
+
+    /**
+     * \param chroma The fourcc of the frames
+     * \param width The frames width
+     * \param height The frames height
+     * \param nbSlots The number of frames in the ring
+     * \throw std::invalid_argument if the format or the number of slots is
+     *        invalid
+     * \throw std::runtime_error if the shared memory can't be allocated
+     */
+    SharedFrameSink( const std::string& chroma, uint32_t width, uint32_t height,
+                     unsigned int nbSlots = 4 )
+        : SharedFrameSink( VideoFormat( chroma ), width, height, nbSlots )
+    {
+    }
+
+    /**
+     * \param format The format negotiation of the frames
+     * \param width The source width the format is negotiated for
+     * \param height The source height the format is negotiated for
+     * \param nbSlots The number of frames in the ring
+     * \throw std::invalid_argument if the size or the number of slots is
+     *        invalid
+     * \throw std::runtime_error if the shared memory can't be allocated
+     */
+    SharedFrameSink( const VideoFormat& format, uint32_t width, uint32_t height,
+                     unsigned int nbSlots = 4 )
+        : m_fd( -1 )
+        , m_size( 0 )
+        , m_base( nullptr )
+        , m_next( 0 )
+        , m_current( NoSlot )
+        , m_sequence( 0 )
+        , m_published( 0 )
+        , m_dropped( 0 )
+    {
+        if ( format.negotiate( width, height, m_format ) == false )
+            throw std::invalid_argument( "Invalid frame size" );
+        if ( nbSlots < 2 )
+            throw std::invalid_argument( "The ring needs at least 2 slots" );
+
+        uint64_t frameSize = 0;
+        uint32_t planeOffsets[VideoFormat::MaxPlanes] = {};
+        for ( auto i = 0u; i < m_format.nbPlanes; ++i )
+        {
+            planeOffsets[i] = static_cast<uint32_t>( frameSize );
+            frameSize += m_format.planeSize( i );
+        }
+        auto nbDescriptors = nbSlots * 2;
+        auto slotSize = detail::ring::align( frameSize, VideoFrameSink::Alignment );
+        auto slotHeadersOffset = detail::ring::align( sizeof( detail::ring::Header ), 64 );
+        auto descriptorsOffset = detail::ring::align( slotHeadersOffset +
+                                    nbSlots * sizeof( detail::ring::SlotHeader ), 64 );
+        auto slotsOffset = detail::ring::align( descriptorsOffset +
+                                    nbDescriptors * sizeof( detail::ring::Descriptor ), 4096 );
+        m_size = static_cast<size_t>( slotsOffset + slotSize * nbSlots );
+
+        // Allocate before acquiring the shared memory, which the destructor
+        // won't release if the constructor throws
+        m_scratch.resize( static_cast<size_t>( slotSize + VideoFrameSink::Alignment ) );
+
+        m_fd = detail::ring::memfdCreate( "vlcpp-frames", MFD_CLOEXEC | MFD_ALLOW_SEALING );
+        if ( m_fd < 0 )
+            throw std::runtime_error( "Failed to create the frame ring" );
+        if ( ftruncate( m_fd, static_cast<off_t>( m_size ) ) != 0 ||
+             fcntl( m_fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL ) != 0 )
+        {
+            close( m_fd );
+            throw std::runtime_error( "Failed to size the frame ring" );
+        }
+        auto base = mmap( nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0 );
+        if ( base == MAP_FAILED )
+        {
+            close( m_fd );
+            throw std::runtime_error( "Failed to map the frame ring" );
+        }
+        m_base = static_cast<uint8_t*>( base );
+
+        // The memfd is zero filled, which is a valid initial state for the
+        // atomics
+        auto& h = header();
+        h.magic = detail::ring::Magic;
+        h.version = detail::ring::Version;
+        h.nbSlots = nbSlots;
+        h.nbDescriptors = nbDescriptors;
+        h.slotSize = slotSize;
+        h.slotHeadersOffset = slotHeadersOffset;
+        h.descriptorsOffset = descriptorsOffset;
+        h.slotsOffset = slotsOffset;
+        h.size = m_size;
+        memcpy( h.chroma, m_format.chroma, 4 );
+        h.width = m_format.width;
+        h.height = m_format.height;
+        h.nbPlanes = m_format.nbPlanes;
+        for ( auto i = 0u; i < m_format.nbPlanes; ++i )
+        {
+            h.pitches[i] = m_format.pitches[i];
+            h.lines[i] = m_format.lines[i];
+            h.planeOffsets[i] = planeOffsets[i];
+        }
+    }
+
+    /**
+     * Wakes up the consumers, which see the ring as closed once they have
+     * read the last frames.
+     */
+    ~SharedFrameSink()
+    {
+        auto& h = header();
+        h.closed.store( 1, std::memory_order_seq_cst );
+        h.futex.fetch_add( 1, std::memory_order_seq_cst );
+        detail::ring::futex( &h.futex, FUTEX_WAKE, INT_MAX, nullptr );
+        munmap( m_base, m_size );
+        close( m_fd );
+    }
+
+    SharedFrameSink( const SharedFrameSink& ) = delete;
+    SharedFrameSink& operator=( const SharedFrameSink& ) = delete;
+
+    /**
+     * Returns the file descriptor of the ring, to be passed to the consumer
+     * processes. It is closed on exec, and when the sink is destroyed.
+     */
+    int fd() const
+    {
+        return m_fd;
+    }
+
+    const VideoFormat::Layout& format() const
+    {
+        return m_format;
+    }
+
+    /**
+     * Install the video callbacks on a media player. This must be called
+     * before playback starts, and the sink must outlive the playback.
+     */
+    void attach( MediaPlayer& mp )
+    {
+        mp.setVideoFormatCallbacks(
+            [this]( char* chroma, uint32_t* width, uint32_t* height,
+                    uint32_t* pitches, uint32_t* lines ) -> uint32_t {
+                return setup( chroma, width, height, pitches, lines );
+            },
+            nullptr );
+        mp.setVideoCallbacks(
+            [this]( void** planes ) -> void* {
+                return lock( planes );
+            },
+            nullptr,
+            [this]( void* ) {
+                display();
+            } );
+    }
+
+    Stats stats() const
+    {
+        return Stats{ m_published.load( std::memory_order_relaxed ),
+                      m_dropped.load( std::memory_order_relaxed ) };
+    }
+
+private:
+    static constexpr uint32_t NoSlot = 0xffffffff;
+
+    detail::ring::Header& header() const
+    {
+        return *reinterpret_cast<detail::ring::Header*>( m_base );
+    }
+
+    detail::ring::SlotHeader& slotHeader( uint32_t slot ) const
+    {
+        return reinterpret_cast<detail::ring::SlotHeader*>(
+                    m_base + header().slotHeadersOffset )[slot];
+    }
+
+    uint32_t setup( char* chroma, uint32_t* width, uint32_t* height,
+                    uint32_t* pitches, uint32_t* lines )
+    {
+        // Have libvlc scale the video to the format of the ring
+        m_format.fill( chroma, width, height, pitches, lines );
+        return header().nbSlots;
+    }
+
+    /* Claim a slot no consumer is reading. Clearing the slot sequence before
+       checking its readers, while consumers do the opposite, guarantees that
+       either the consumer sees the slot being rewritten, or this sees the
+       consumer */
+    bool claim( uint32_t slot )
+    {
+        auto& s = slotHeader( slot );
+        if ( s.readers.load( std::memory_order_seq_cst ) != 0 )
+            return false;
+        s.sequence.store( 0, std::memory_order_seq_cst );
+        return s.readers.load( std::memory_order_seq_cst ) == 0;
+    }
+
+    void* lock( void** planes )
+    {
+        const auto& h = header();
+        // A picture which wasn't displayed is simply decoded over
+        if ( m_current == NoSlot )
+        {
+            for ( auto i = 0u; i < h.nbSlots && m_current == NoSlot; ++i )
+            {
+                auto slot = ( m_next + i ) % h.nbSlots;
+                if ( claim( slot ) == true )
+                {
+                    m_current = slot;
+                    m_next = ( slot + 1 ) % h.nbSlots;
+                }
+            }
+        }
+        uint8_t* data;
+        if ( m_current != NoSlot )
+            data = m_base + h.slotsOffset + h.slotSize * m_current;
+        else
+        {
+            auto base = reinterpret_cast<uintptr_t>( m_scratch.data() );
+            data = m_scratch.data() + ( ( VideoFrameSink::Alignment - base % VideoFrameSink::Alignment ) %
+                                        VideoFrameSink::Alignment );
+        }
+        for ( auto i = 0u; i < h.nbPlanes; ++i )
+            planes[i] = data + h.planeOffsets[i];
+        return nullptr;
+    }
+
+    void display()
+    {
+        if ( m_current == NoSlot )
+        {
+            m_dropped.fetch_add( 1, std::memory_order_relaxed );
+            return;
+        }
+        auto& h = header();
+        auto sequence = ++m_sequence;
+        auto& d = reinterpret_cast<detail::ring::Descriptor*>(
+                    m_base + h.descriptorsOffset )[sequence % h.nbDescriptors];
+        d.sequence.store( 0, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+        d.slot.store( m_current, std::memory_order_relaxed );
+        d.pts.store( detail::ring::monotonicTime(), std::memory_order_relaxed );
+        d.sequence.store( sequence, std::memory_order_release );
+        slotHeader( m_current ).sequence.store( sequence, std::memory_order_release );
+        m_current = NoSlot;
+
+        h.head.store( sequence, std::memory_order_release );
+        h.futex.store( static_cast<uint32_t>( sequence ), std::memory_order_seq_cst );
+        if ( h.waiters.load( std::memory_order_seq_cst ) != 0 )
+            detail::ring::futex( &h.futex, FUTEX_WAKE, INT_MAX, nullptr );
+        m_published.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+private:
+    VideoFormat::Layout m_format;
+    int m_fd;
+    size_t m_size;
+    uint8_t* m_base;
+
+    /* Only used from the video output thread */
+    uint32_t m_next;
+    uint32_t m_current;
+    uint64_t m_sequence;
+    std::vector<uint8_t> m_scratch;
+
+    std::atomic<uint64_t> m_published;
+    std::atomic<uint64_t> m_dropped;
+};
+
+///
+/// \brief The SharedFrameConsumer class reads the frames a SharedFrameSink
+/// publishes, usually from another process.
+///
+/// A consumer is meant to be used from a single thread. Frames are read in
+/// place, the slot of a frame being protected from the video output as long
+/// as the frame is held, so frames should be released promptly.
+///
+class SharedFrameConsumer
+{
+private:
+    struct Mapping;
+
+public:
+    ///
+    /// \brief A frame read from the ring. The slot is released when the
+    /// frame is destroyed or reset.
+    ///
+    class Frame
+    {
+    public:
+        Frame()
+            : m_slot( 0 )
+            , m_sequence( 0 )
+            , m_pts( 0 )
+        {
+        }
+
+        Frame( Frame&& other )
+            : m_mapping( std::move( other.m_mapping ) )
+            , m_slot( other.m_slot )
+            , m_sequence( other.m_sequence )
+            , m_pts( other.m_pts )
+        {
+        }
+
+        Frame& operator=( Frame&& other )
+        {
+            if ( this != &other )
+            {
+                reset();
+                m_mapping = std::move( other.m_mapping );
+                m_slot = other.m_slot;
+                m_sequence = other.m_sequence;
+                m_pts = other.m_pts;
+            }
+            return *this;
+        }
+
+        Frame( const Frame& ) = delete;
+        Frame& operator=( const Frame& ) = delete;
+
+        ~Frame()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            if ( m_mapping != nullptr )
+                m_mapping->slotHeader( m_slot ).readers.fetch_sub( 1, std::memory_order_release );
+            m_mapping.reset();
+        }
+
+        bool isValid() const
+        {
+            return m_mapping != nullptr;
+        }
+
+        const VideoFormat::Layout& format() const
+        {
+            return m_mapping->format;
+        }
+
+        uint32_t width() const
+        {
+            return m_mapping->format.width;
+        }
+
+        uint32_t height() const
+        {
+            return m_mapping->format.height;
+        }
+
+        /**
+         * Returns a pointer to the first line of a plane. No bound checking
+         * is performed.
+         */
+        const uint8_t* plane( unsigned int index ) const
+        {
+            const auto& m = *m_mapping;
+            return m.base + m.slotsOffset + m.slotSize * m_slot + m.planeOffsets[index];
+        }
+
+        uint32_t pitch( unsigned int index ) const
+        {
+            return m_mapping->format.pitches[index];
+        }
+
+        /**
+         * Returns the publication order of the frame, starting from 1
+         */
+        uint64_t sequence() const
+        {
+            return m_sequence;
+        }
+
+        /**
+         * Returns the display date of the frame, in microseconds of the
+         * CLOCK_MONOTONIC clock, which is shared by all processes
+         */
+        int64_t pts() const
+        {
+            return m_pts;
+        }
+
+    private:
+        std::shared_ptr<Mapping> m_mapping;
+        uint32_t m_slot;
+        uint64_t m_sequence;
+        int64_t m_pts;
+
+        friend class SharedFrameConsumer;
+    };
+
+    enum class Status
+    {
+        /// A frame was read
+        Ready,
+        /// No frame was published before the timeout
+        Timeout,
+        /// The sink was destroyed, and all its frames were read
+        Closed,
+    };
+
+    /**
+     * Map a ring. The mapping doesn't use the file descriptor afterward, so
+     * it can be closed once the consumer is created.
+     *
+     * \param fd The file descriptor returned by SharedFrameSink::fd()
+     * \throw std::runtime_error if the ring can't be mapped, or is invalid
+     */
+    explicit SharedFrameConsumer( int fd )
+        : m_mapping( std::make_shared<Mapping>( fd ) )
+        , m_last( 0 )
+        , m_skipped( 0 )
+    {
+        // Start with the frames published from now on
+        m_last = m_mapping->header().head.load( std::memory_order_acquire );
+    }
+
+    const VideoFormat::Layout& format() const
+    {
+        return m_mapping->format;
+    }
+
+    /**
+     * Read the frame following the last one read. If the consumer lags
+     * behind, the frames which were overwritten meanwhile are skipped.
+     *
+     * \param frame The frame to fill
+     * \param timeout How long to wait for a frame to be published
+     */
+    Status next( Frame& frame, std::chrono::milliseconds timeout )
+    {
+        return read( frame, timeout, false );
+    }
+
+    /**
+     * Read the most recently published frame, skipping the older ones.
+     *
+     * \param frame The frame to fill
+     * \param timeout How long to wait for a frame to be published
+     */
+    Status latest( Frame& frame, std::chrono::milliseconds timeout )
+    {
+        return read( frame, timeout, true );
+    }
+
+    /**
+     * Returns the number of published frames which weren't read, because
+     * latest() skipped them, or because they were overwritten before next()
+     * got to them
+     */
+    uint64_t skipped() const
+    {
+        return m_skipped;
+    }
+
+private:
+    struct Mapping
+    {
+        explicit Mapping( int fd )
+            : base( nullptr )
+            , size( 0 )
+        {
+            struct stat st;
+            if ( fstat( fd, &st ) != 0 || static_cast<size_t>( st.st_size ) < sizeof( detail::ring::Header ) )
+                throw std::runtime_error( "Invalid frame ring" );
+            size = static_cast<size_t>( st.st_size );
+            auto p = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+            if ( p == MAP_FAILED )
+                throw std::runtime_error( "Failed to map the frame ring" );
+            base = static_cast<uint8_t*>( p );
+            // The layout is copied once validated, so that a producer
+            // rewriting the header can't make later accesses out of bounds
+            const auto& h = header();
+            nbSlots = h.nbSlots;
+            nbDescriptors = h.nbDescriptors;
+            slotSize = h.slotSize;
+            slotHeadersOffset = h.slotHeadersOffset;
+            descriptorsOffset = h.descriptorsOffset;
+            slotsOffset = h.slotsOffset;
+            auto nbPlanes = h.nbPlanes;
+            auto valid = h.magic == detail::ring::Magic && h.version == detail::ring::Version &&
+                    h.size == size && nbSlots != 0 && nbDescriptors != 0 &&
+                    nbPlanes != 0 && nbPlanes <= VideoFormat::MaxPlanes &&
+                    slotHeadersOffset >= sizeof( detail::ring::Header ) &&
+                    slotHeadersOffset % alignof( detail::ring::SlotHeader ) == 0 &&
+                    fits( slotHeadersOffset, nbSlots, sizeof( detail::ring::SlotHeader ) ) &&
+                    descriptorsOffset >= sizeof( detail::ring::Header ) &&
+                    descriptorsOffset % alignof( detail::ring::Descriptor ) == 0 &&
+                    fits( descriptorsOffset, nbDescriptors, sizeof( detail::ring::Descriptor ) ) &&
+                    fits( slotsOffset, nbSlots, slotSize );
+            for ( auto i = 0u; i < VideoFormat::MaxPlanes; ++i )
+            {
+                planeOffsets[i] = h.planeOffsets[i];
+                format.pitches[i] = h.pitches[i];
+                format.lines[i] = h.lines[i];
+                if ( i < nbPlanes && static_cast<uint64_t>( format.pitches[i] ) * format.lines[i] >
+                                     slotSize - std::min<uint64_t>( planeOffsets[i], slotSize ) )
+                    valid = false;
+            }
+            if ( valid == false )
+            {
+                munmap( base, size );
+                throw std::runtime_error( "Invalid frame ring" );
+            }
+            memcpy( format.chroma, h.chroma, 4 );
+            format.chroma[4] = 0;
+            format.width = h.width;
+            format.height = h.height;
+            format.nbPlanes = nbPlanes;
+        }
+
+        ~Mapping()
+        {
+            munmap( base, size );
+        }
+
+        detail::ring::Header& header() const
+        {
+            return *reinterpret_cast<detail::ring::Header*>( base );
+        }
+
+        detail::ring::SlotHeader& slotHeader( uint32_t slot ) const
+        {
+            return reinterpret_cast<detail::ring::SlotHeader*>( base + slotHeadersOffset )[slot];
+        }
+
+        detail::ring::Descriptor& descriptor( uint64_t sequence ) const
+        {
+            return reinterpret_cast<detail::ring::Descriptor*>(
+                        base + descriptorsOffset )[sequence % nbDescriptors];
+        }
+
+        /* Returns true if count elements starting at offset fit in the
+           mapping, without overflowing */
+        bool fits( uint64_t offset, uint64_t count, uint64_t elementSize ) const
+        {
+            return offset <= size && ( elementSize == 0 || count <= ( size - offset ) / elementSize );
+        }
+
+        uint8_t* base;
+        size_t size;
+        VideoFormat::Layout format;
+        uint32_t nbSlots;
+        uint32_t nbDescriptors;
+        uint64_t slotSize;
+        uint64_t slotHeadersOffset;
+        uint64_t descriptorsOffset;
+        uint64_t slotsOffset;
+        uint32_t planeOffsets[VideoFormat::MaxPlanes];
+    };
+
+    /* Wait until the head reaches the given sequence, returns the head */
+    uint64_t wait( uint64_t sequence, std::chrono::steady_clock::time_point deadline )
+    {
+        auto& h = m_mapping->header();
+        while ( true )
+        {
+            auto head = h.head.load( std::memory_order_acquire );
+            if ( head >= sequence || h.closed.load( std::memory_order_acquire ) != 0 )
+                return head;
+            auto now = std::chrono::steady_clock::now();
+            if ( now >= deadline )
+                return head;
+            auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>( deadline - now );
+            timespec ts;
+            ts.tv_sec = static_cast<time_t>( remaining.count() / 1000000000 );
+            ts.tv_nsec = static_cast<long>( remaining.count() % 1000000000 );
+            h.waiters.fetch_add( 1, std::memory_order_seq_cst );
+            auto word = h.futex.load( std::memory_order_seq_cst );
+            if ( h.head.load( std::memory_order_seq_cst ) < sequence &&
+                 h.closed.load( std::memory_order_seq_cst ) == 0 )
+                detail::ring::futex( &h.futex, FUTEX_WAIT, word, &ts );
+            h.waiters.fetch_sub( 1, std::memory_order_seq_cst );
+        }
+    }
+
+    /* Pin the slot of a published frame, returns false if it was
+       overwritten */
+    bool pin( uint64_t sequence, Frame& frame )
+    {
+        auto& d = m_mapping->descriptor( sequence );
+        if ( d.sequence.load( std::memory_order_acquire ) != sequence )
+            return false;
+        auto slot = d.slot.load( std::memory_order_relaxed );
+        auto pts = d.pts.load( std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_acquire );
+        if ( d.sequence.load( std::memory_order_relaxed ) != sequence ||
+             slot >= m_mapping->nbSlots )
+            return false;
+        auto& s = m_mapping->slotHeader( slot );
+        s.readers.fetch_add( 1, std::memory_order_seq_cst );
+        if ( s.sequence.load( std::memory_order_seq_cst ) != sequence )
+        {
+            s.readers.fetch_sub( 1, std::memory_order_release );
+            return false;
+        }
+        frame.reset();
+        frame.m_mapping = m_mapping;
+        frame.m_slot = slot;
+        frame.m_sequence = sequence;
+        frame.m_pts = pts;
+        return true;
+    }
+
+    Status read( Frame& frame, std::chrono::milliseconds timeout, bool latest )
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        const auto nbDescriptors = m_mapping->nbDescriptors;
+        while ( true )
+        {
+            auto head = wait( m_last + 1, deadline );
+            if ( head <= m_last )
+            {
+                if ( m_mapping->header().closed.load( std::memory_order_acquire ) != 0 )
+                    return Status::Closed;
+                return Status::Timeout;
+            }
+            auto first = m_last + 1;
+            if ( latest == true )
+                first = head;
+            else if ( head - m_last > nbDescriptors )
+                first = head - nbDescriptors + 1;
+            m_skipped += first - m_last - 1;
+            for ( auto s = first; s <= head; ++s )
+            {
+                m_last = s;
+                if ( pin( s, frame ) == true )
+                    return Status::Ready;
+                ++m_skipped;
+            }
+        }
+    }
+
+private:
+    std::shared_ptr<Mapping> m_mapping;
+    uint64_t m_last;
+    uint64_t m_skipped;
+};
+
+} // namespace VLC
+
+#endif // __linux__
+
+#endif // LIBVLC_CXX_SHAREDFRAMERING_HPP
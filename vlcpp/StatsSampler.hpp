@@ -0,0 +1,432 @@
+/*****************************************************************************
+ * StatsSampler.hpp: Periodic, delta-aware Media statistics sampling
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_STATSSAMPLER_HPP
+#define LIBVLC_CXX_STATSSAMPLER_HPP
+
+#include "Media.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace VLC
+{
+
+namespace detail
+{
+    ///
+    /// Single writer, multiple readers sequence lock.
+    ///
+    /// The value is stored as an array of relaxed atomic words, so readers never
+    /// observe a torn value: they retry until they copied a consistent version.
+    /// Readers never block the writer.
+    ///
+    template <typename T>
+    class SeqLock
+    {
+        static_assert( std::is_trivially_copyable<T>::value,
+                       "SeqLock can only hold trivially copyable types" );
+        static constexpr size_t NbWords = ( sizeof( T ) + sizeof( uint64_t ) - 1 ) / sizeof( uint64_t );
+
+    public:
+        SeqLock()
+            : m_seq( 0 )
+        {
+            for ( auto& w : m_words )
+                w.store( 0, std::memory_order_relaxed );
+        }
+
+        SeqLock( const SeqLock& ) = delete;
+        SeqLock& operator=( const SeqLock& ) = delete;
+
+        /**
+         * Publish a new value. Must only be called from a single thread.
+         */
+        void store( const T& value )
+        {
+            uint64_t buffer[NbWords] = {};
+            memcpy( buffer, &value, sizeof( T ) );
+            auto seq = m_seq.load( std::memory_order_relaxed );
+            m_seq.store( seq + 1, std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_release );
+            for ( auto i = 0u; i < NbWords; ++i )
+                m_words[i].store( buffer[i], std::memory_order_relaxed );
+            m_seq.store( seq + 2, std::memory_order_release );
+        }
+
+        /**
+         * Copy the last published value. Wait-free for the writer, lock-free
+         * for the readers.
+         */
+        T load() const
+        {
+            uint64_t buffer[NbWords];
+            for ( ;; )
+            {
+                auto before = m_seq.load( std::memory_order_acquire );
+                if ( ( before & 1 ) != 0 )
+                    continue;
+                for ( auto i = 0u; i < NbWords; ++i )
+                    buffer[i] = m_words[i].load( std::memory_order_relaxed );
+                std::atomic_thread_fence( std::memory_order_acquire );
+                if ( m_seq.load( std::memory_order_relaxed ) == before )
+                    break;
+            }
+            T value;
+            memcpy( &value, buffer, sizeof( T ) );
+            return value;
+        }
+
+    private:
+        std::atomic<uint32_t> m_seq;
+        std::atomic<uint64_t> m_words[NbWords];
+    };
+}
+
+///
+/// \brief The StatsSampler class polls the statistics of a set of Media from a
+/// single timer thread, and turns libvlc's cumulative counters into per
+/// interval rates.
+///
+/// Each sampled media keeps a fixed size ring of the most recent samples. The
+/// latest sample and the history can be read from any thread without taking a
+/// lock, through the Handle returned by StatsSampler::add()
+///
+class StatsSampler
+{
+public:
+    ///
+    /// \brief Cumulative counters, as reported by libvlc_media_get_stats
+    ///
+    struct Counters
+    {
+        uint64_t readBytes;
+        uint64_t demuxReadBytes;
+        uint64_t demuxCorrupted;
+        uint64_t demuxDiscontinuity;
+        uint64_t decodedVideo;
+        uint64_t decodedAudio;
+        uint64_t displayedPictures;
+        uint64_t latePictures;
+        uint64_t lostPictures;
+        uint64_t playedAudioBuffers;
+        uint64_t lostAudioBuffers;
+    };
+
+    ///
+    /// \brief Per second rates, computed over the last sampling interval
+    ///
+    struct Rates
+    {
+        /// Input bitrate, in bytes per second
+        double inputBitrate;
+        /// Demux bitrate, in bytes per second
+        double demuxBitrate;
+        /// Corrupted demuxed blocks per second
+        double demuxCorrupted;
+        /// Demux discontinuities per second
+        double demuxDiscontinuity;
+        /// Decoded video frames per second
+        double decodedVideo;
+        /// Decoded audio blocks per second
+        double decodedAudio;
+        /// Displayed pictures per second
+        double displayedPictures;
+        /// Pictures displayed late per second
+        double latePictures;
+        /// Lost pictures per second
+        double lostPictures;
+        /// Lost audio buffers per second
+        double lostAudioBuffers;
+    };
+
+    struct Sample
+    {
+        /// Monotonic sample number for this media, starting at 0
+        uint64_t index;
+        /// Time of the sample, relative to the sampler creation
+        std::chrono::microseconds time;
+        /// Actual duration covered by the rates. 0 for the first sample
+        std::chrono::microseconds interval;
+        Counters counters;
+        Rates rates;
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry
+    {
+        Entry( Media m, size_t historySize )
+            : media( std::move( m ) )
+            , ring( historySize )
+            , count( 0 )
+            , hasPrevious( false )
+        {
+        }
+
+        // Never reassigned, Media::stats() is merely not const
+        Media media;
+
+        // Only accessed by the sampling thread
+        Counters previous;
+        Clock::time_point previousTime;
+
+        // Shared with the readers
+        std::vector<detail::SeqLock<Sample>> ring;
+        std::atomic<uint64_t> count;
+
+        bool hasPrevious;
+    };
+
+public:
+    ///
+    /// \brief The Handle class gives lock-free read access to the samples of
+    /// a media. It remains valid after the media is removed, or after the
+    /// sampler is destroyed, in which case it keeps returning the last samples.
+    ///
+    class Handle
+    {
+    public:
+        Handle() = default;
+
+        bool isValid() const { return (bool)m_entry; }
+
+        /**
+         * Fetch the most recent sample
+         *
+         * \param sample The sample to fill [out]
+         * \return false if no sample was taken yet
+         */
+        bool latest( Sample& sample ) const
+        {
+            for ( ;; )
+            {
+                auto count = m_entry->count.load( std::memory_order_acquire );
+                if ( count == 0 )
+                    return false;
+                auto idx = count - 1;
+                sample = m_entry->ring[idx % m_entry->ring.size()].load();
+                if ( sample.index == idx )
+                    return true;
+                // The slot was overwritten while we were reading it; retry
+                // with the new most recent sample.
+            }
+        }
+
+        /**
+         * Returns the samples currently held in the ring, oldest first.
+         *
+         * Samples overwritten while the history is being copied are dropped.
+         */
+        std::vector<Sample> history() const
+        {
+            std::vector<Sample> res;
+            auto count = m_entry->count.load( std::memory_order_acquire );
+            auto size = m_entry->ring.size();
+            auto first = count > size ? count - size : 0;
+            res.reserve( count - first );
+            for ( auto i = first; i < count; ++i )
+            {
+                auto s = m_entry->ring[i % size].load();
+                if ( s.index == i )
+                    res.push_back( s );
+            }
+            return res;
+        }
+
+        /**
+         * Returns the sampled media
+         */
+        const Media& media() const
+        {
+            return m_entry->media;
+        }
+
+    private:
+        explicit Handle( std::shared_ptr<Entry> entry )
+            : m_entry( std::move( entry ) )
+        {
+        }
+
+        std::shared_ptr<Entry> m_entry;
+
+        friend class StatsSampler;
+    };
+
+    /**
+     * Create a sampler and start its timer thread.
+     *
+     * \param interval The sampling interval
+     * \param historySize The number of samples kept for each media (at least 1)
+     */
+    explicit StatsSampler( std::chrono::milliseconds interval, size_t historySize = 60 )
+        : m_interval( interval )
+        , m_historySize( std::max<size_t>( historySize, 1 ) )
+        , m_start( Clock::now() )
+        , m_stop( false )
+    {
+        if ( interval.count() <= 0 )
+            throw std::invalid_argument( "Invalid sampling interval" );
+        m_thread = std::thread( &StatsSampler::run, this );
+    }
+
+    ~StatsSampler()
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            m_stop = true;
+        }
+        m_cond.notify_all();
+        m_thread.join();
+    }
+
+    StatsSampler( const StatsSampler& ) = delete;
+    StatsSampler& operator=( const StatsSampler& ) = delete;
+
+    /**
+     * Start sampling a media. The first sample is taken on the next tick.
+     *
+     * \param media The media to sample
+     * \return A handle used to read the samples
+     */
+    Handle add( const Media& media )
+    {
+        auto entry = std::make_shared<Entry>( media, m_historySize );
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_entries.push_back( entry );
+        return Handle( std::move( entry ) );
+    }
+
+    /**
+     * Stop sampling the media associated with the provided handle.
+     * The handle remains readable.
+     */
+    void remove( const Handle& handle )
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        auto it = std::find( begin( m_entries ), end( m_entries ), handle.m_entry );
+        if ( it != end( m_entries ) )
+            m_entries.erase( it );
+    }
+
+    std::chrono::milliseconds interval() const
+    {
+        return m_interval;
+    }
+
+private:
+    void run()
+    {
+        auto next = Clock::now() + m_interval;
+        std::vector<std::shared_ptr<Entry>> entries;
+        std::unique_lock<std::mutex> lock( m_mutex );
+        while ( m_cond.wait_until( lock, next, [this]() { return m_stop; } ) == false )
+        {
+            entries = m_entries;
+            lock.unlock();
+            auto now = Clock::now();
+            for ( const auto& e : entries )
+                sample( *e, now );
+            entries.clear();
+            // Don't try to catch up on missed ticks, just skip them
+            next += m_interval;
+            if ( next < now )
+                next = now + m_interval;
+            lock.lock();
+        }
+    }
+
+    static double rate( uint64_t current, uint64_t previous, double seconds )
+    {
+        if ( current < previous || seconds <= 0 )
+            return 0;
+        return static_cast<double>( current - previous ) / seconds;
+    }
+
+    void sample( Entry& e, Clock::time_point now )
+    {
+        libvlc_media_stats_t stats;
+        if ( e.media.stats( &stats ) == false )
+            return;
+
+        Sample s = {};
+        s.counters.readBytes = static_cast<uint64_t>( stats.i_read_bytes );
+        s.counters.demuxReadBytes = static_cast<uint64_t>( stats.i_demux_read_bytes );
+        s.counters.demuxCorrupted = static_cast<uint64_t>( stats.i_demux_corrupted );
+        s.counters.demuxDiscontinuity = static_cast<uint64_t>( stats.i_demux_discontinuity );
+        s.counters.decodedVideo = static_cast<uint64_t>( stats.i_decoded_video );
+        s.counters.decodedAudio = static_cast<uint64_t>( stats.i_decoded_audio );
+        s.counters.displayedPictures = static_cast<uint64_t>( stats.i_displayed_pictures );
+        s.counters.latePictures = static_cast<uint64_t>( stats.i_late_pictures );
+        s.counters.lostPictures = static_cast<uint64_t>( stats.i_lost_pictures );
+        s.counters.playedAudioBuffers = static_cast<uint64_t>( stats.i_played_abuffers );
+        s.counters.lostAudioBuffers = static_cast<uint64_t>( stats.i_lost_abuffers );
+        s.time = std::chrono::duration_cast<std::chrono::microseconds>( now - m_start );
+
+        if ( e.hasPrevious == true )
+        {
+            s.interval = std::chrono::duration_cast<std::chrono::microseconds>( now - e.previousTime );
+            auto seconds = std::chrono::duration<double>( now - e.previousTime ).count();
+            const auto& c = s.counters;
+            const auto& p = e.previous;
+            s.rates.inputBitrate = rate( c.readBytes, p.readBytes, seconds );
+            s.rates.demuxBitrate = rate( c.demuxReadBytes, p.demuxReadBytes, seconds );
+            s.rates.demuxCorrupted = rate( c.demuxCorrupted, p.demuxCorrupted, seconds );
+            s.rates.demuxDiscontinuity = rate( c.demuxDiscontinuity, p.demuxDiscontinuity, seconds );
+            s.rates.decodedVideo = rate( c.decodedVideo, p.decodedVideo, seconds );
+            s.rates.decodedAudio = rate( c.decodedAudio, p.decodedAudio, seconds );
+            s.rates.displayedPictures = rate( c.displayedPictures, p.displayedPictures, seconds );
+            s.rates.latePictures = rate( c.latePictures, p.latePictures, seconds );
+            s.rates.lostPictures = rate( c.lostPictures, p.lostPictures, seconds );
+            s.rates.lostAudioBuffers = rate( c.lostAudioBuffers, p.lostAudioBuffers, seconds );
+        }
+        e.previous = s.counters;
+        e.previousTime = now;
+        e.hasPrevious = true;
+
+        auto idx = e.count.load( std::memory_order_relaxed );
+        s.index = idx;
+        e.ring[idx % e.ring.size()].store( s );
+        e.count.store( idx + 1, std::memory_order_release );
+    }
+
+private:
+    const std::chrono::milliseconds m_interval;
+    const size_t m_historySize;
+    const Clock::time_point m_start;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::vector<std::shared_ptr<Entry>> m_entries;
+    bool m_stop;
+    std::thread m_thread;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_STATSSAMPLER_HPP
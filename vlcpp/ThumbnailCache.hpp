@@ -0,0 +1,728 @@
+/*****************************************************************************
+ * ThumbnailCache.hpp: Persistent cache of generated thumbnails
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_THUMBNAILCACHE_HPP
+#define LIBVLC_CXX_THUMBNAILCACHE_HPP
+
+#include "Media.hpp"
+#include "Picture.hpp"
+#include "Parser.hpp"
+#include "ParseCache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+# include <direct.h>
+# include <sys/utime.h>
+#else
+# include <dirent.h>
+# include <utime.h>
+#endif
+
+namespace VLC
+{
+
+///
+/// \brief The ThumbnailCache class caches generated thumbnails on disk, so
+/// they survive application restarts.
+///
+/// Thumbnails are content addressed: the key covers the media MRL, its file
+/// modification time and size, the seek request, the thumbnail size, the
+/// crop flag and the picture type, so a modified file, or a different
+/// request, never hits a stale thumbnail. The entries are spread across 256
+/// sub directories, and the least recently used ones are removed once the
+/// cache grows over its size cap.
+///
+/// Cache hits are served without involving the thumbnailer at all. The disk
+/// accesses happen outside of the cache lock, so a slow disk doesn't stall
+/// the other lookups, nor the thumbnailer threads.
+///
+class ThumbnailCache
+{
+public:
+    ///
+    /// \brief A thumbnail, as returned by the cache. Unlike Picture, it
+    /// doesn't depend on libvlc, and can be copied cheaply.
+    ///
+    class Image
+    {
+    public:
+        Image()
+            : m_type( Picture::Type::Argb )
+            , m_width( 0 )
+            , m_height( 0 )
+            , m_stride( 0 )
+            , m_time( 0 )
+        {
+        }
+
+        bool isValid() const
+        {
+            return m_data != nullptr;
+        }
+
+        /**
+         * Returns the image buffer, including potential padding.
+         *
+         * \param size A pointer to a size_t that will hold the size of the buffer [out] [required]
+         */
+        const uint8_t* buffer( size_t* size ) const
+        {
+            *size = m_data->size();
+            return m_data->data();
+        }
+
+        Picture::Type type() const
+        {
+            return m_type;
+        }
+
+        /**
+         * Returns the image stride. Only meaningful for Picture::Type::Argb
+         */
+        uint32_t stride() const
+        {
+            return m_stride;
+        }
+
+        uint32_t width() const
+        {
+            return m_width;
+        }
+
+        uint32_t height() const
+        {
+            return m_height;
+        }
+
+        std::chrono::microseconds time() const
+        {
+            return m_time;
+        }
+
+        /**
+         * Saves the encoded image to a file. Raw Argb & Rgba images can't be
+         * saved.
+         *
+         * \return true in case of success, false otherwise
+         */
+        bool save( const std::string& path ) const
+        {
+            if ( isValid() == false || m_type == Picture::Type::Argb ||
+                 m_type == Picture::Type::Rgba )
+                return false;
+            auto f = fopen( path.c_str(), "wb" );
+            if ( f == nullptr )
+                return false;
+            auto success = fwrite( m_data->data(), m_data->size(), 1, f ) == 1;
+            return fclose( f ) == 0 && success;
+        }
+
+    private:
+        Picture::Type m_type;
+        uint32_t m_width;
+        uint32_t m_height;
+        uint32_t m_stride;
+        std::chrono::microseconds m_time;
+        std::shared_ptr<const std::vector<uint8_t>> m_data;
+
+        friend class ThumbnailCache;
+    };
+
+    struct Stats
+    {
+        uint64_t hits;
+        uint64_t misses;
+        /// Number of thumbnails written to the cache
+        uint64_t stores;
+        /// Number of thumbnails removed to honor the size cap
+        uint64_t evictions;
+        /// Size of the thumbnails served from the cache, which didn't have
+        /// to be generated again
+        uint64_t bytesSaved;
+        /// Current cache size, in bytes
+        uint64_t bytes;
+        /// Current number of cached thumbnails
+        size_t entries;
+
+        double hitRatio() const
+        {
+            return hits + misses != 0 ? static_cast<double>( hits ) / ( hits + misses ) : 0;
+        }
+    };
+
+    /**
+     * Completion prototype. The image is invalid if the thumbnail couldn't
+     * be generated.
+     */
+    using OnThumbnail = std::function<void(Media&, const Image&)>;
+
+    /**
+     * \param parser The parser used to generate missing thumbnails. It must
+     * outlive the cache.
+     * \param directory The cache directory, created if needed
+     * \param maxBytes The cache size cap
+     */
+    ThumbnailCache( Parser& parser, std::string directory, uint64_t maxBytes )
+        : m_parser( parser )
+        , m_directory( std::move( directory ) )
+        , m_maxBytes( maxBytes )
+        , m_cbs( [this]( Parser::Task&& task, const Picture& picture ) {
+            onThumbnailed( std::move( task ), picture );
+        } )
+        , m_bytes( 0 )
+        , m_generation( 0 )
+        , m_inCallbacks( 0 )
+        , m_nextTmp( 0 )
+        , m_stats()
+    {
+        if ( makeDirectory( m_directory ) == false )
+            throw std::runtime_error( "Failed to create the thumbnail cache directory" );
+        load();
+    }
+
+    ThumbnailCache( const ThumbnailCache& ) = delete;
+    ThumbnailCache& operator=( const ThumbnailCache& ) = delete;
+
+    /**
+     * Cancels the requests in flight, and waits for their completion.
+     */
+    ~ThumbnailCache()
+    {
+        std::unique_lock<std::recursive_mutex> lock( m_mutex );
+        std::vector<Parser::TaskIdentifier> tasks;
+        for ( const auto& p : m_pending )
+            tasks.push_back( p.first );
+        for ( auto& t : tasks )
+        {
+            // A synchronous cancellation removes the task from the map
+            if ( m_pending.count( t ) != 0 )
+                m_parser.cancelRequest( t );
+        }
+        m_cond.wait( lock, [this] {
+            return m_pending.empty() == true && m_inCallbacks == 0;
+        } );
+    }
+
+    /**
+     * Lookup a thumbnail in the cache, without generating it on a miss.
+     *
+     * \param request The thumbnailer request
+     * \param image The cached thumbnail [out]
+     * \return true on a hit, false otherwise
+     */
+    bool lookup( const Parser::ThumbnailerRequest& request, Image& image )
+    {
+        auto media = request.media();
+        std::string key;
+        if ( makeKey( media, request, key ) == false )
+        {
+            std::lock_guard<std::recursive_mutex> lock( m_mutex );
+            ++m_stats.misses;
+            return false;
+        }
+        return find( key, image );
+    }
+
+    /**
+     * Returns a thumbnail from the cache, or generates it and stores it.
+     *
+     * On a hit, onThumbnail is called from the calling thread before this
+     * function returns. On a miss it is called from a thumbnailer thread.
+     *
+     * \param request The thumbnailer request
+     * \param onThumbnail The completion callback
+     * \return true if the thumbnail was served from the cache
+     */
+    bool queueThumbnailing( const Parser::ThumbnailerRequest& request, OnThumbnail onThumbnail )
+    {
+        auto media = request.media();
+        std::string key;
+        auto cacheable = makeKey( media, request, key );
+        Image image;
+        auto hit = cacheable == true && find( key, image ) == true;
+        {
+            std::lock_guard<std::recursive_mutex> lock( m_mutex );
+            if ( cacheable == false )
+                ++m_stats.misses;
+            if ( hit == false )
+            {
+                // The lock is held across queueThumbnailing(), so the
+                // completion can't happen before the request is registered
+                auto task = m_parser.queueThumbnailing( request, m_cbs );
+                Pending pending;
+                pending.key = std::move( key );
+                pending.cacheable = cacheable;
+                pending.onThumbnail = std::move( onThumbnail );
+                m_pending.emplace( task, std::move( pending ) );
+                return false;
+            }
+        }
+        if ( onThumbnail )
+            onThumbnail( media, image );
+        return true;
+    }
+
+    /**
+     * Remove all the cached thumbnails
+     */
+    void clear()
+    {
+        std::vector<uint64_t> removed;
+        {
+            std::lock_guard<std::recursive_mutex> lock( m_mutex );
+            removed.assign( begin( m_lru ), end( m_lru ) );
+            m_lru.clear();
+            m_entries.clear();
+            m_bytes = 0;
+        }
+        removeFiles( removed );
+    }
+
+    Stats stats() const
+    {
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        auto s = m_stats;
+        s.bytes = m_bytes;
+        s.entries = m_entries.size();
+        return s;
+    }
+
+private:
+    static constexpr uint32_t Magic = 0x31435456; // "VTC1"
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t type;
+        uint32_t width;
+        uint32_t height;
+        uint32_t stride;
+        uint32_t keySize;
+        int64_t time;
+        uint64_t dataSize;
+    };
+
+    struct Entry
+    {
+        std::list<uint64_t>::iterator lru;
+        uint64_t bytes;
+        /* Tells a stored entry from the one it replaced */
+        uint64_t generation;
+    };
+
+    struct Pending
+    {
+        std::string key;
+        bool cacheable;
+        OnThumbnail onThumbnail;
+    };
+
+    template <typename T>
+    static void append( std::string& key, T value )
+    {
+        key.append( reinterpret_cast<const char*>( &value ), sizeof( value ) );
+    }
+
+    /* Builds the key material of a request. The file path is derived from its
+       hash, and the material itself is stored in the file to detect hash
+       collisions. */
+    static bool makeKey( Media& media, const Parser::ThumbnailerRequest& request, std::string& key )
+    {
+        auto mrl = media.mrl();
+        uint64_t mtime, size;
+        if ( detail::fileStat( media, mrl, mtime, size ) == false )
+            return false;
+        key = mrl;
+        key.push_back( '\0' );
+        append( key, mtime );
+        append( key, size );
+        append( key, static_cast<int32_t>( request.seekType() ) );
+        if ( request.seekType() == Parser::SeekType::Time )
+            append( key, static_cast<int64_t>( request.seekTime().count() ) );
+        else if ( request.seekType() == Parser::SeekType::Position )
+            append( key, request.seekPosition() );
+        append( key, static_cast<int32_t>( request.seekSpeed() ) );
+        append( key, static_cast<uint32_t>( request.width() ) );
+        append( key, static_cast<uint32_t>( request.height() ) );
+        append( key, static_cast<uint8_t>( request.crop() ) );
+        append( key, static_cast<int32_t>( request.pictureType() ) );
+        return true;
+    }
+
+    std::string shardPath( uint64_t hash ) const
+    {
+        char name[4];
+        snprintf( name, sizeof( name ), "%02x", static_cast<unsigned int>( hash >> 56 ) );
+        return m_directory + '/' + name;
+    }
+
+    std::string entryPath( uint64_t hash ) const
+    {
+        char name[24];
+        snprintf( name, sizeof( name ), "/%016llx.thumb", static_cast<unsigned long long>( hash ) );
+        return shardPath( hash ) + name;
+    }
+
+    static bool makeDirectory( const std::string& path )
+    {
+#ifdef _WIN32
+        if ( _mkdir( path.c_str() ) == 0 )
+            return true;
+#else
+        if ( mkdir( path.c_str(), 0755 ) == 0 )
+            return true;
+#endif
+        return errno == EEXIST;
+    }
+
+    /* Index the existing entries, ordered by their last use, which is
+       recorded as their modification time */
+    void load()
+    {
+        struct Existing
+        {
+            int64_t mtime;
+            uint64_t hash;
+            uint64_t bytes;
+        };
+        std::vector<Existing> existing;
+        for ( auto shard = 0u; shard < 256; ++shard )
+        {
+            auto dir = shardPath( static_cast<uint64_t>( shard ) << 56 );
+            for ( const auto& name : listDirectory( dir ) )
+            {
+                auto path = dir + '/' + name;
+                // Left over by an interrupted store
+                if ( name.size() > 4 && name.compare( name.size() - 4, 4, ".tmp" ) == 0 )
+                {
+                    std::remove( path.c_str() );
+                    continue;
+                }
+                unsigned long long hash;
+                char suffix[8];
+                if ( name.size() != 22 ||
+                     sscanf( name.c_str(), "%16llx.%5s", &hash, suffix ) != 2 ||
+                     strcmp( suffix, "thumb" ) != 0 )
+                    continue;
+                int64_t mtime;
+                uint64_t size;
+                if ( fileStat( path, mtime, size ) == false )
+                    continue;
+                existing.push_back( Existing{ mtime, hash, size } );
+            }
+        }
+        std::sort( begin( existing ), end( existing ), []( const Existing& a, const Existing& b ) {
+            return a.mtime < b.mtime;
+        } );
+        for ( const auto& e : existing )
+            insertLocked( e.hash, e.bytes );
+        std::vector<uint64_t> evicted;
+        evictLocked( evicted );
+        removeFiles( evicted );
+    }
+
+    static bool fileStat( const std::string& path, int64_t& mtime, uint64_t& size )
+    {
+#ifdef _WIN32
+        struct _stat64 st;
+        if ( _stat64( path.c_str(), &st ) != 0 )
+            return false;
+#else
+        struct stat st;
+        if ( ::stat( path.c_str(), &st ) != 0 )
+            return false;
+#endif
+        mtime = static_cast<int64_t>( st.st_mtime );
+        size = static_cast<uint64_t>( st.st_size );
+        return true;
+    }
+
+    static std::vector<std::string> listDirectory( const std::string& path )
+    {
+        std::vector<std::string> names;
+#ifdef _WIN32
+        WIN32_FIND_DATAA data;
+        auto h = FindFirstFileA( ( path + "\\*" ).c_str(), &data );
+        if ( h == INVALID_HANDLE_VALUE )
+            return names;
+        do
+            names.push_back( data.cFileName );
+        while ( FindNextFileA( h, &data ) != 0 );
+        FindClose( h );
+#else
+        auto dir = opendir( path.c_str() );
+        if ( dir == nullptr )
+            return names;
+        while ( auto entry = readdir( dir ) )
+            names.push_back( entry->d_name );
+        closedir( dir );
+#endif
+        return names;
+    }
+
+    void insertLocked( uint64_t hash, uint64_t bytes )
+    {
+        unindexLocked( hash );
+        m_lru.push_front( hash );
+        m_entries[hash] = Entry{ begin( m_lru ), bytes, m_generation++ };
+        m_bytes += bytes;
+    }
+
+    /* Only forgets the entry, the caller removes the file once the lock is
+       released */
+    bool unindexLocked( uint64_t hash )
+    {
+        auto it = m_entries.find( hash );
+        if ( it == end( m_entries ) )
+            return false;
+        m_bytes -= it->second.bytes;
+        m_lru.erase( it->second.lru );
+        m_entries.erase( it );
+        return true;
+    }
+
+    void evictLocked( std::vector<uint64_t>& evicted )
+    {
+        while ( m_bytes > m_maxBytes && m_lru.empty() == false )
+        {
+            evicted.push_back( m_lru.back() );
+            unindexLocked( m_lru.back() );
+            ++m_stats.evictions;
+        }
+    }
+
+    /* A file removed after the same entry was stored again only costs a miss,
+       as the entry is then dropped on lookup */
+    void removeFiles( const std::vector<uint64_t>& hashes ) const
+    {
+        for ( auto hash : hashes )
+            std::remove( entryPath( hash ).c_str() );
+    }
+
+    bool find( const std::string& key, Image& image )
+    {
+        auto hash = detail::fnv1a( key.data(), key.size() );
+        uint64_t generation;
+        {
+            std::lock_guard<std::recursive_mutex> lock( m_mutex );
+            auto it = m_entries.find( hash );
+            if ( it == end( m_entries ) )
+            {
+                ++m_stats.misses;
+                return false;
+            }
+            generation = it->second.generation;
+        }
+        auto path = entryPath( hash );
+        auto success = read( path, key, image );
+        if ( success == true )
+        {
+            // Record the use, so the LRU order survives restarts
+#ifdef _WIN32
+            _utime( path.c_str(), nullptr );
+#else
+            utime( path.c_str(), nullptr );
+#endif
+        }
+        std::unique_lock<std::recursive_mutex> lock( m_mutex );
+        auto it = m_entries.find( hash );
+        auto current = it != end( m_entries ) && it->second.generation == generation;
+        if ( success == false )
+        {
+            ++m_stats.misses;
+            // Hash collision, or corrupted entry: it will be replaced. An
+            // entry stored meanwhile is left alone.
+            if ( current == true )
+            {
+                unindexLocked( hash );
+                lock.unlock();
+                std::remove( path.c_str() );
+            }
+            return false;
+        }
+        if ( current == true )
+            m_lru.splice( begin( m_lru ), m_lru, it->second.lru );
+        ++m_stats.hits;
+        m_stats.bytesSaved += image.m_data->size();
+        return true;
+    }
+
+    static bool read( const std::string& path, const std::string& key, Image& image )
+    {
+        int64_t mtime;
+        uint64_t size;
+        if ( fileStat( path, mtime, size ) == false )
+            return false;
+        auto f = fopen( path.c_str(), "rb" );
+        if ( f == nullptr )
+            return false;
+        std::unique_ptr<FILE, int(*)(FILE*)> guard( f, fclose );
+        Header h;
+        if ( fread( &h, sizeof( h ), 1, f ) != 1 || h.magic != Magic || h.keySize != key.size() )
+            return false;
+        // Check the payload size before trusting it with an allocation
+        if ( h.dataSize == 0 || size < sizeof( h ) + h.keySize ||
+             h.dataSize != size - sizeof( h ) - h.keySize )
+            return false;
+        std::string storedKey( h.keySize, '\0' );
+        if ( fread( &storedKey[0], h.keySize, 1, f ) != 1 || storedKey != key )
+            return false;
+        auto data = std::make_shared<std::vector<uint8_t>>( static_cast<size_t>( h.dataSize ) );
+        if ( fread( data->data(), data->size(), 1, f ) != 1 )
+            return false;
+        image.m_type = static_cast<Picture::Type>( h.type );
+        image.m_width = h.width;
+        image.m_height = h.height;
+        image.m_stride = h.stride;
+        image.m_time = std::chrono::microseconds{ h.time };
+        image.m_data = std::move( data );
+        return true;
+    }
+
+    bool store( const std::string& key, const Image& image )
+    {
+        auto hash = detail::fnv1a( key.data(), key.size() );
+        if ( makeDirectory( shardPath( hash ) ) == false )
+            return false;
+        Header h;
+        memset( &h, 0, sizeof( h ) );
+        h.magic = Magic;
+        h.type = static_cast<uint32_t>( image.m_type );
+        h.width = image.m_width;
+        h.height = image.m_height;
+        h.stride = image.m_stride;
+        h.keySize = static_cast<uint32_t>( key.size() );
+        h.time = image.m_time.count();
+        h.dataSize = image.m_data->size();
+
+        // Write to a temporary file, so a crash never leaves a truncated
+        // entry. Its name is unique, as the same entry can be stored from
+        // several thumbnailer threads.
+        auto path = entryPath( hash );
+        auto tmpPath = path + '.' + std::to_string( m_nextTmp.fetch_add( 1 ) ) + ".tmp";
+        auto f = fopen( tmpPath.c_str(), "wb" );
+        if ( f == nullptr )
+            return false;
+        auto success = fwrite( &h, sizeof( h ), 1, f ) == 1 &&
+                fwrite( key.data(), key.size(), 1, f ) == 1 &&
+                fwrite( image.m_data->data(), image.m_data->size(), 1, f ) == 1;
+        success = fclose( f ) == 0 && success;
+        if ( success == true )
+        {
+#ifdef _WIN32
+            // rename() doesn't overwrite existing files on Windows
+            std::remove( path.c_str() );
+#endif
+            success = std::rename( tmpPath.c_str(), path.c_str() ) == 0;
+        }
+        if ( success == false )
+        {
+            std::remove( tmpPath.c_str() );
+            return false;
+        }
+        std::vector<uint64_t> evicted;
+        {
+            std::lock_guard<std::recursive_mutex> lock( m_mutex );
+            insertLocked( hash, sizeof( h ) + key.size() + image.m_data->size() );
+            ++m_stats.stores;
+            evictLocked( evicted );
+        }
+        removeFiles( evicted );
+        return true;
+    }
+
+    static Image toImage( const Picture& picture )
+    {
+        Image image;
+        if ( picture.isValid() == false )
+            return image;
+        size_t size;
+        auto buffer = picture.buffer( &size );
+        image.m_type = picture.type();
+        image.m_width = picture.width();
+        image.m_height = picture.height();
+        image.m_stride = image.m_type == Picture::Type::Argb ? picture.stride() : 0;
+        image.m_time = picture.time();
+        image.m_data = std::make_shared<std::vector<uint8_t>>( buffer, buffer + size );
+        return image;
+    }
+
+    void onThumbnailed( Parser::Task&& task, const Picture& picture )
+    {
+        auto image = toImage( picture );
+        Pending pending;
+        {
+            std::lock_guard<std::recursive_mutex> lock( m_mutex );
+            auto it = m_pending.find( Parser::TaskIdentifier( task ) );
+            assert( it != end( m_pending ) );
+            pending = std::move( it->second );
+            m_pending.erase( it );
+            ++m_inCallbacks;
+        }
+        if ( pending.cacheable == true && image.isValid() == true )
+            store( pending.key, image );
+        if ( pending.onThumbnail )
+        {
+            auto media = task.getMedia();
+            pending.onThumbnail( media, image );
+        }
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        --m_inCallbacks;
+        m_cond.notify_all();
+    }
+
+private:
+    Parser& m_parser;
+    const std::string m_directory;
+    const uint64_t m_maxBytes;
+    Parser::ThumbnailerCallbacks m_cbs;
+
+    mutable std::recursive_mutex m_mutex;
+    std::condition_variable_any m_cond;
+    /* Most recently used first */
+    std::list<uint64_t> m_lru;
+    std::unordered_map<uint64_t, Entry> m_entries;
+    uint64_t m_bytes;
+    uint64_t m_generation;
+    std::unordered_map<Parser::TaskIdentifier, Pending> m_pending;
+    unsigned int m_inCallbacks;
+    std::atomic<uint64_t> m_nextTmp;
+    Stats m_stats;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_THUMBNAILCACHE_HPP
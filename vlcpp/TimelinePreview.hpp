@@ -0,0 +1,288 @@
+/*****************************************************************************
+ * TimelinePreview.hpp: Seek bar preview sprite sheet generation
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_TIMELINEPREVIEW_HPP
+#define LIBVLC_CXX_TIMELINEPREVIEW_HPP
+
+#include "Media.hpp"
+#include "Picture.hpp"
+#include "Parser.hpp"
+#include "Future.hpp"
+#include "ImageView.hpp"
+#include "PngWriter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace VLC
+{
+
+///
+/// \brief The TimelinePreview class generates the thumbnails of a seek bar
+/// preview, and packs them in a single sprite sheet.
+///
+/// The thumbnails are requested at evenly spaced positions, using fast
+/// seeking, and are all queued at once so that the parser thumbnailer threads,
+/// see Parser::Config::setMaxThumbnailerThreads, work in parallel. Each
+/// thumbnail is copied to its tile as soon as it is available.
+///
+class TimelinePreview
+{
+public:
+    struct Tile
+    {
+        /// Requested position, in the [0, 1] range
+        double position;
+        /// Actual time of the thumbnail
+        std::chrono::microseconds time;
+        /// Position of the tile in the atlas, in pixels
+        uint32_t x;
+        uint32_t y;
+        /// False if the thumbnail couldn't be generated. The tile is
+        /// transparent in that case.
+        bool valid;
+        /// Time between the request being queued and the tile being filled
+        std::chrono::microseconds latency;
+    };
+
+    struct Report
+    {
+        std::chrono::milliseconds wallTime;
+        std::chrono::microseconds minLatency;
+        std::chrono::microseconds maxLatency;
+        std::chrono::microseconds averageLatency;
+        size_t failed;
+    };
+
+    /**
+     * \param nbTiles The number of thumbnails to generate
+     * \param tileWidth, tileHeight The size of each thumbnail. Thumbnails are
+     * cropped to this aspect ratio
+     * \param columns The number of tiles per atlas line
+     */
+    TimelinePreview( unsigned int nbTiles, uint32_t tileWidth, uint32_t tileHeight,
+                     unsigned int columns = 10 )
+        : m_tileWidth( tileWidth )
+        , m_tileHeight( tileHeight )
+        , m_columns( std::min( columns, nbTiles ) )
+        , m_tiles( nbTiles )
+    {
+        if ( nbTiles == 0 || tileWidth == 0 || tileHeight == 0 || columns == 0 )
+            throw std::invalid_argument( "Invalid timeline preview layout" );
+        auto rows = ( nbTiles + m_columns - 1 ) / m_columns;
+        m_width = m_columns * tileWidth;
+        m_height = rows * tileHeight;
+        m_atlas.resize( static_cast<size_t>( m_width ) * 4 * m_height );
+        for ( auto i = 0u; i < nbTiles; ++i )
+        {
+            auto& t = m_tiles[i];
+            t.position = ( i + .5 ) / nbTiles;
+            t.time = std::chrono::microseconds{ 0 };
+            t.x = ( i % m_columns ) * tileWidth;
+            t.y = ( i / m_columns ) * tileHeight;
+            t.valid = false;
+            t.latency = std::chrono::microseconds{ 0 };
+        }
+    }
+
+    /**
+     * Generate all the thumbnails of a media, and block until they are all
+     * packed in the atlas.
+     *
+     * \param parser The parser used to generate the thumbnails
+     * \param media The media to preview
+     * \return The generation report
+     */
+    Report generate( Parser& parser, Media& media )
+    {
+        std::fill( begin( m_atlas ), end( m_atlas ), 0 );
+        for ( auto& tile : m_tiles )
+        {
+            tile.time = std::chrono::microseconds{ 0 };
+            tile.valid = false;
+            tile.latency = std::chrono::microseconds{ 0 };
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Future<Parser::Result>> futures;
+        futures.reserve( m_tiles.size() );
+        for ( auto& tile : m_tiles )
+        {
+            Parser::ThumbnailerRequest req( media );
+            req.setSize( m_tileWidth, m_tileHeight, true )
+               .setPictureType( Picture::Type::Argb )
+               .setSeekPosition( tile.position, Parser::ThumbnailSeekSpeed::Fast );
+            auto queued = std::chrono::steady_clock::now();
+            auto future = parser.thumbnailAsync( req );
+            // Tiles are disjoint, so they can be filled concurrently
+            auto t = &tile;
+            future.then( [this, t, queued]( const Parser::Result& r ) {
+                fill( *t, r.picture );
+                t->latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - queued );
+            } );
+            futures.push_back( std::move( future ) );
+        }
+        whenAll( futures ).wait();
+
+        Report report;
+        report.wallTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start );
+        report.minLatency = report.maxLatency = m_tiles[0].latency;
+        report.failed = 0;
+        std::chrono::microseconds total{ 0 };
+        for ( const auto& t : m_tiles )
+        {
+            report.minLatency = std::min( report.minLatency, t.latency );
+            report.maxLatency = std::max( report.maxLatency, t.latency );
+            total += t.latency;
+            if ( t.valid == false )
+                ++report.failed;
+        }
+        report.averageLatency = total / static_cast<int64_t>( m_tiles.size() );
+        return report;
+    }
+
+    /**
+     * Returns the tiles, in timeline order
+     */
+    const std::vector<Tile>& tiles() const
+    {
+        return m_tiles;
+    }
+
+    /**
+     * Returns the index of the tile to display for a time, given the media
+     * duration
+     */
+    size_t tileAt( std::chrono::microseconds time, std::chrono::microseconds duration ) const
+    {
+        if ( duration.count() <= 0 || time.count() <= 0 )
+            return 0;
+        auto index = static_cast<size_t>( time.count() * m_tiles.size() / duration.count() );
+        return std::min( index, m_tiles.size() - 1 );
+    }
+
+    /**
+     * Returns the atlas pixels, as Argb, without any line padding
+     */
+    const std::vector<uint8_t>& atlas() const
+    {
+        return m_atlas;
+    }
+
+    uint32_t width() const
+    {
+        return m_width;
+    }
+
+    uint32_t height() const
+    {
+        return m_height;
+    }
+
+    /**
+     * Save the atlas as a PNG image
+     */
+    bool saveAtlas( const std::string& path ) const
+    {
+        return detail::writeArgbAsPng( path, m_atlas.data(), m_width, m_height, m_width * 4 );
+    }
+
+    /**
+     * Save the time to tile index as a WebVTT file, as used by most web
+     * players for seek bar previews.
+     *
+     * \param path The index file path
+     * \param atlasUrl The atlas URL, as referenced by the index
+     * \param duration The media duration
+     */
+    bool saveIndex( const std::string& path, const std::string& atlasUrl,
+                    std::chrono::microseconds duration ) const
+    {
+        auto f = fopen( path.c_str(), "w" );
+        if ( f == nullptr )
+            return false;
+        auto success = fputs( "WEBVTT\n", f ) >= 0;
+        auto slice = duration / static_cast<int64_t>( m_tiles.size() );
+        for ( auto i = 0u; i < m_tiles.size() && success == true; ++i )
+        {
+            const auto& t = m_tiles[i];
+            auto from = formatTime( slice * i );
+            auto to = formatTime( i + 1 == m_tiles.size() ? duration : slice * ( i + 1 ) );
+            success = fprintf( f, "\n%s --> %s\n%s#xywh=%u,%u,%u,%u\n", from.c_str(), to.c_str(),
+                               atlasUrl.c_str(), t.x, t.y, m_tileWidth, m_tileHeight ) > 0;
+        }
+        return fclose( f ) == 0 && success;
+    }
+
+private:
+    void fill( Tile& tile, const Picture& picture )
+    {
+        if ( picture.isValid() == false || picture.type() != Picture::Type::Argb )
+            return;
+        ImageView view;
+        try
+        {
+            view = ImageView( picture );
+        }
+        catch ( const std::invalid_argument& )
+        {
+            return;
+        }
+        auto width = std::min( view.width(), m_tileWidth );
+        auto height = std::min( view.height(), m_tileHeight );
+        auto dst = m_atlas.data() + ( static_cast<size_t>( tile.y ) * m_width + tile.x ) * 4;
+        for ( auto row : view.subview( 0, 0, width, height ) )
+        {
+            memcpy( dst, row, width * 4 );
+            dst += m_width * 4;
+        }
+        tile.time = picture.time();
+        tile.valid = true;
+    }
+
+    static std::string formatTime( std::chrono::microseconds t )
+    {
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>( t ).count();
+        char buff[32];
+        snprintf( buff, sizeof( buff ), "%02lld:%02lld:%02lld.%03lld",
+                  static_cast<long long>( ms / 3600000 ), static_cast<long long>( ms / 60000 % 60 ),
+                  static_cast<long long>( ms / 1000 % 60 ), static_cast<long long>( ms % 1000 ) );
+        return buff;
+    }
+
+private:
+    const uint32_t m_tileWidth;
+    const uint32_t m_tileHeight;
+    const unsigned int m_columns;
+    uint32_t m_width;
+    uint32_t m_height;
+    std::vector<Tile> m_tiles;
+    std::vector<uint8_t> m_atlas;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_TIMELINEPREVIEW_HPP
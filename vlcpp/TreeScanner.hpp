@@ -0,0 +1,427 @@
+/*****************************************************************************
+ * TreeScanner.hpp: Parallel recursive parsing of directories and playlists
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_TREESCANNER_HPP
+#define LIBVLC_CXX_TREESCANNER_HPP
+
+#include "Media.hpp"
+#include "MediaList.hpp"
+#include "Parser.hpp"
+#include "ParsedMediaInfo.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace VLC
+{
+
+///
+/// \brief The TreeScanner class parses a tree of directories and playlists.
+///
+/// Every parsed media is reported to a sink, and the sub items of the
+/// containers are fed back to the parser as soon as their parent completes,
+/// so all the parser threads are kept busy whatever the shape of the tree,
+/// instead of parsing it one level at a time.
+///
+/// The sub items waiting to be parsed are spread across worker threads, each
+/// owning a deque: a worker parses its own items depth first, and steals the
+/// oldest items of the other workers when it runs out of work. The number of
+/// requests in flight, which includes the parsed media waiting for their
+/// sub items to be expanded, is bounded.
+///
+class TreeScanner
+{
+public:
+    struct Entry
+    {
+        Media media;
+        Parser::Status status;
+        /// 0 for the roots
+        unsigned int depth;
+        /// Only valid if the request succeeded
+        ParsedMediaInfo info;
+    };
+
+    struct Stats
+    {
+        size_t parsed;
+        size_t failed;
+        /// Number of media which had sub items
+        size_t expanded;
+        /// Number of sub items pulled from another worker deque
+        size_t stolen;
+        unsigned int maxDepth;
+        std::chrono::milliseconds elapsed;
+    };
+
+    /**
+     * Sink prototype. It is called from the worker threads, concurrently,
+     * and must be thread safe.
+     */
+    using Sink = std::function<void(const Entry&)>;
+
+    /**
+     * \param parser The parser to queue requests to. It must outlive the scanner.
+     * \param maxInFlight The maximum number of requests in flight
+     * \param nbWorkers The number of worker threads, 0 for the number of cores
+     * \param flags The parse flags used for all the requests
+     * \param maxDepth The depth past which sub items aren't expanded
+     */
+    TreeScanner( Parser& parser, size_t maxInFlight, unsigned int nbWorkers = 0,
+                 Parser::ParseFlags flags = Parser::ParseFlags::Parse,
+                 unsigned int maxDepth = std::numeric_limits<unsigned int>::max() )
+        : m_parser( parser )
+        , m_maxInFlight( maxInFlight )
+        , m_flags( flags )
+        , m_maxDepth( maxDepth )
+        , m_cbs( [this]( Parser::Task&& task, Parser::Status status, void* context ) {
+            onParsed( std::move( task ), status, context );
+        } )
+        , m_queues( nbWorkers != 0 ? nbWorkers :
+                        std::max( std::thread::hardware_concurrency(), 1u ) )
+        , m_inFlight( 0 )
+        , m_outstanding( 0 )
+        , m_epoch( 0 )
+        , m_cancelled( false )
+        , m_running( false )
+    {
+        if ( maxInFlight == 0 )
+            throw std::invalid_argument( "TreeScanner maxInFlight can't be 0" );
+    }
+
+    TreeScanner( const TreeScanner& ) = delete;
+    TreeScanner& operator=( const TreeScanner& ) = delete;
+
+    /**
+     * Parse the provided roots, and all their sub items, recursively. Blocks
+     * until the whole tree is parsed, or the scan is cancelled.
+     *
+     * \param roots The media to start from
+     * \param sink Called for each parsed media
+     * \return The scan statistics
+     */
+    Stats run( const std::vector<Media>& roots, Sink sink )
+    {
+        if ( m_running.exchange( true ) == true )
+            throw std::logic_error( "TreeScanner is already running" );
+        m_sink = std::move( sink );
+        m_cancelled = false;
+        m_stats = Stats{};
+        auto start = std::chrono::steady_clock::now();
+
+        for ( auto i = 0u; i < roots.size(); ++i )
+            push( i % m_queues.size(), Pending{ roots[i], 0 } );
+
+        std::vector<std::thread> workers;
+        for ( auto i = 0u; i < m_queues.size(); ++i )
+            workers.emplace_back( &TreeScanner::work, this, i );
+        for ( auto& w : workers )
+            w.join();
+
+        m_running = false;
+        std::lock_guard<std::mutex> lock( m_statsMutex );
+        m_stats.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start );
+        return m_stats;
+    }
+
+    /**
+     * Stop the scan: the sub items not queued yet are dropped, and the
+     * requests in flight are reported, but not expanded. run() returns once
+     * they are finished.
+     *
+     * Can be called from any thread, including from the sink.
+     */
+    void cancel()
+    {
+        m_cancelled = true;
+        wake();
+    }
+
+    /**
+     * Returns the statistics of the current, or last, scan
+     */
+    Stats stats() const
+    {
+        std::lock_guard<std::mutex> lock( m_statsMutex );
+        return m_stats;
+    }
+
+private:
+    struct Pending
+    {
+        Media media;
+        unsigned int depth;
+    };
+
+    struct Completed
+    {
+        Media media;
+        Parser::Status status;
+        unsigned int depth;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Pending> items;
+    };
+
+    void push( size_t worker, Pending p )
+    {
+        ++m_outstanding;
+        {
+            auto& q = m_queues[worker];
+            std::lock_guard<std::mutex> lock( q.mutex );
+            q.items.push_back( std::move( p ) );
+        }
+        wake();
+    }
+
+    /* The owner pops its newest item, to go depth first and keep the
+       deques short, and thieves take the oldest ones, which tend to be the
+       closest to the roots, hence the biggest sub trees */
+    bool pop( size_t worker, Pending& p )
+    {
+        {
+            auto& q = m_queues[worker];
+            std::lock_guard<std::mutex> lock( q.mutex );
+            if ( q.items.empty() == false )
+            {
+                p = std::move( q.items.back() );
+                q.items.pop_back();
+                return true;
+            }
+        }
+        for ( auto i = 1u; i < m_queues.size(); ++i )
+        {
+            auto& q = m_queues[( worker + i ) % m_queues.size()];
+            std::lock_guard<std::mutex> lock( q.mutex );
+            if ( q.items.empty() == false )
+            {
+                p = std::move( q.items.front() );
+                q.items.pop_front();
+                std::lock_guard<std::mutex> statsLock( m_statsMutex );
+                ++m_stats.stolen;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool reserveSlot()
+    {
+        auto n = m_inFlight.load();
+        while ( n < m_maxInFlight )
+        {
+            if ( m_inFlight.compare_exchange_weak( n, n + 1 ) == true )
+                return true;
+        }
+        return false;
+    }
+
+    void releaseSlot()
+    {
+        --m_inFlight;
+        wake();
+    }
+
+    void finish()
+    {
+        if ( --m_outstanding == 0 )
+            wake();
+    }
+
+    void wake()
+    {
+        std::lock_guard<std::mutex> lock( m_sleepMutex );
+        ++m_epoch;
+        m_sleepCond.notify_all();
+    }
+
+    bool popCompleted( Completed& c )
+    {
+        std::lock_guard<std::mutex> lock( m_completedMutex );
+        if ( m_completed.empty() == true )
+            return false;
+        c = std::move( m_completed.front() );
+        m_completed.pop_front();
+        return true;
+    }
+
+    void work( size_t worker )
+    {
+        while ( true )
+        {
+            uint64_t epoch;
+            {
+                std::lock_guard<std::mutex> lock( m_sleepMutex );
+                epoch = m_epoch;
+            }
+            if ( m_outstanding == 0 )
+                return;
+
+            // Expanding the completed requests first releases their slot,
+            // and produces more work
+            Completed c;
+            if ( popCompleted( c ) == true )
+            {
+                expand( worker, c );
+                continue;
+            }
+
+            Pending p;
+            if ( m_cancelled == true )
+            {
+                if ( pop( worker, p ) == true )
+                {
+                    finish();
+                    continue;
+                }
+            }
+            else if ( reserveSlot() == true )
+            {
+                if ( pop( worker, p ) == true )
+                {
+                    dispatch( p );
+                    continue;
+                }
+                // Nothing to dispatch: there is no one to wake up either
+                --m_inFlight;
+            }
+
+            std::unique_lock<std::mutex> lock( m_sleepMutex );
+            m_sleepCond.wait( lock, [this, epoch] { return m_epoch != epoch; } );
+        }
+    }
+
+    void dispatch( Pending& p )
+    {
+        Parser::Request req( p.media );
+        req.setParseFlags( m_flags )
+           .setUserContext( reinterpret_cast<void*>( static_cast<uintptr_t>( p.depth ) ) );
+        try
+        {
+            m_parser.queue( req, m_cbs );
+        }
+        catch ( const std::runtime_error& )
+        {
+            releaseSlot();
+            Completed c{ std::move( p.media ), Parser::Status::Failed, p.depth };
+            report( c );
+            finish();
+        }
+    }
+
+    void onParsed( Parser::Task&& task, Parser::Status status, void* context )
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_completedMutex );
+            m_completed.push_back( Completed{ task.getMedia(), status,
+                                              static_cast<unsigned int>(
+                                                  reinterpret_cast<uintptr_t>( context ) ) } );
+        }
+        wake();
+    }
+
+    void report( Completed& c )
+    {
+        Entry entry{ c.media, c.status, c.depth, ParsedMediaInfo() };
+        if ( c.status == Parser::Status::Done )
+            entry.info = ParsedMediaInfo( c.media );
+        {
+            std::lock_guard<std::mutex> lock( m_statsMutex );
+            ++m_stats.parsed;
+            if ( c.status != Parser::Status::Done )
+                ++m_stats.failed;
+            m_stats.maxDepth = std::max( m_stats.maxDepth, c.depth );
+        }
+        if ( m_sink )
+            m_sink( entry );
+    }
+
+    void expand( size_t worker, Completed& c )
+    {
+        report( c );
+        if ( c.status == Parser::Status::Done && m_cancelled == false && c.depth < m_maxDepth )
+        {
+            auto subitems = c.media.subitems();
+            if ( subitems != nullptr )
+            {
+                std::vector<Media> children;
+                {
+                    MediaList::Lock lock( *subitems );
+                    auto count = subitems->count();
+                    for ( auto i = 0; i < count; ++i )
+                        children.push_back( subitems->itemAtIndex( i ) );
+                }
+                if ( children.empty() == false )
+                {
+                    std::lock_guard<std::mutex> lock( m_statsMutex );
+                    ++m_stats.expanded;
+                }
+                for ( auto& child : children )
+                    push( worker, Pending{ std::move( child ), c.depth + 1 } );
+            }
+        }
+        releaseSlot();
+        finish();
+    }
+
+private:
+    Parser& m_parser;
+    const size_t m_maxInFlight;
+    const Parser::ParseFlags m_flags;
+    const unsigned int m_maxDepth;
+    Parser::Callbacks m_cbs;
+
+    std::vector<Queue> m_queues;
+    std::mutex m_completedMutex;
+    std::deque<Completed> m_completed;
+
+    /* Requests queued to libvlc, or completed and not expanded yet */
+    std::atomic<size_t> m_inFlight;
+    /* Items pushed, and not expanded yet */
+    std::atomic<size_t> m_outstanding;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCond;
+    uint64_t m_epoch;
+
+    std::atomic<bool> m_cancelled;
+    std::atomic<bool> m_running;
+    Sink m_sink;
+    mutable std::mutex m_statsMutex;
+    Stats m_stats;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_TREESCANNER_HPP
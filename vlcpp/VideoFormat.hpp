@@ -0,0 +1,370 @@
+/*****************************************************************************
+ * VideoFormat.hpp: Video format negotiation for the format callbacks
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_VIDEOFORMAT_HPP
+#define LIBVLC_CXX_VIDEOFORMAT_HPP
+
+#include "structures.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+namespace VLC
+{
+
+///
+/// \brief The VideoFormat class computes the planes layout of a chroma, to
+/// be returned from the format callback of MediaPlayer::setVideoFormatCallbacks()
+///
+/// It knows the packed RGB and YUV chromas, and the planar and semi planar
+/// YUV ones. The pitches are rounded to an alignment, 64 bytes by default, so
+/// that each line of each plane starts aligned, which vectorized consumers
+/// expect. The number of lines can be rounded as well.
+///
+/// The video can optionally be downscaled to fit a bounding box. The output
+/// then has square pixels, and keeps the display aspect ratio given by the
+/// sample aspect ratio of the video track.
+///
+/// \code
+/// mp.setVideoFormatCallbacks( VideoFormat( "I420" ).setMaxSize( 640, 360 )
+///                                                  .setSar( track )
+///                                                  .callback( 3 ), nullptr );
+/// \endcode
+///
+class VideoFormat
+{
+public:
+    static constexpr unsigned int MaxPlanes = 3;
+
+    ///
+    /// \brief The negotiated format of the pictures
+    ///
+    struct Layout
+    {
+        /// Nul terminated fourcc
+        char chroma[5];
+        uint32_t width;
+        uint32_t height;
+        unsigned int nbPlanes;
+        uint32_t pitches[MaxPlanes];
+        uint32_t lines[MaxPlanes];
+
+        size_t planeSize( unsigned int plane ) const
+        {
+            return static_cast<size_t>( pitches[plane] ) * lines[plane];
+        }
+
+        /**
+         * Returns the size of a picture, its planes being contiguous
+         */
+        size_t frameSize() const
+        {
+            size_t size = 0;
+            for ( auto i = 0u; i < nbPlanes; ++i )
+                size += planeSize( i );
+            return size;
+        }
+
+        /**
+         * Fill the arguments of the format callback
+         */
+        void fill( char* outChroma, uint32_t* outWidth, uint32_t* outHeight,
+                   uint32_t* outPitches, uint32_t* outLines ) const
+        {
+            memcpy( outChroma, chroma, 4 );
+            *outWidth = width;
+            *outHeight = height;
+            for ( auto i = 0u; i < nbPlanes; ++i )
+            {
+                outPitches[i] = pitches[i];
+                outLines[i] = lines[i];
+            }
+        }
+    };
+
+    /**
+     * Format callback prototype, see MediaPlayer::setVideoFormatCallbacks()
+     */
+    using FormatCb = std::function<uint32_t(char* chroma, uint32_t* width, uint32_t* height,
+                                            uint32_t* pitches, uint32_t* lines)>;
+
+    /**
+     * \param chroma The fourcc of the pictures
+     * \throw std::invalid_argument if the chroma isn't supported
+     */
+    explicit VideoFormat( const std::string& chroma )
+        : m_desc( find( chroma ) )
+        , m_pitchAlignment( 64 )
+        , m_linesAlignment( 1 )
+        , m_maxWidth( 0 )
+        , m_maxHeight( 0 )
+        , m_sarNum( 1 )
+        , m_sarDen( 1 )
+    {
+        if ( m_desc == nullptr )
+            throw std::invalid_argument( "Unsupported chroma " + chroma );
+    }
+
+    /**
+     * Returns true if the planes layout of a chroma is known
+     */
+    static bool isSupported( const std::string& chroma )
+    {
+        return find( chroma ) != nullptr;
+    }
+
+    std::string chroma() const
+    {
+        return m_desc->fourcc;
+    }
+
+    /**
+     * Round the pitches to a multiple of the given number of bytes
+     *
+     * \throw std::invalid_argument if alignment is 0
+     */
+    VideoFormat& setPitchAlignment( uint32_t alignment )
+    {
+        if ( alignment == 0 )
+            throw std::invalid_argument( "Invalid pitch alignment" );
+        m_pitchAlignment = alignment;
+        return *this;
+    }
+
+    /**
+     * Round the number of lines of each plane to a multiple of the given
+     * number
+     *
+     * \throw std::invalid_argument if alignment is 0
+     */
+    VideoFormat& setLinesAlignment( uint32_t alignment )
+    {
+        if ( alignment == 0 )
+            throw std::invalid_argument( "Invalid lines alignment" );
+        m_linesAlignment = alignment;
+        return *this;
+    }
+
+    /**
+     * Downscale the pictures to fit in a bounding box. Pictures are never
+     * upscaled.
+     *
+     * \param width The maximum width, or 0 for no limit
+     * \param height The maximum height, or 0 for no limit
+     */
+    VideoFormat& setMaxSize( uint32_t width, uint32_t height )
+    {
+        m_maxWidth = width;
+        m_maxHeight = height;
+        return *this;
+    }
+
+    /**
+     * Set the sample aspect ratio of the source, which is honored when
+     * downscaling. An invalid ratio is treated as square pixels.
+     */
+    VideoFormat& setSar( uint32_t num, uint32_t den )
+    {
+        m_sarNum = num != 0 && den != 0 ? num : 1;
+        m_sarDen = num != 0 && den != 0 ? den : 1;
+        return *this;
+    }
+
+    VideoFormat& setSar( const MediaTrack& track )
+    {
+        return setSar( track.sarNum(), track.sarDen() );
+    }
+
+    /**
+     * Compute the format of the pictures for a given source size
+     *
+     * \param width The source width, as given to the format callback
+     * \param height The source height, as given to the format callback
+     * \param layout The layout to fill
+     * \return false if the size is empty
+     */
+    bool negotiate( uint32_t width, uint32_t height, Layout& layout ) const
+    {
+        if ( width == 0 || height == 0 )
+            return false;
+        if ( m_maxWidth != 0 || m_maxHeight != 0 )
+            fit( width, height );
+        // Packed YUV chromas hold pixels pairs
+        width = align( width, m_desc->widthMultiple );
+        memcpy( layout.chroma, m_desc->fourcc, 5 );
+        layout.width = width;
+        layout.height = height;
+        layout.nbPlanes = m_desc->nbPlanes;
+        for ( auto i = 0u; i < MaxPlanes; ++i )
+        {
+            if ( i >= m_desc->nbPlanes )
+            {
+                layout.pitches[i] = layout.lines[i] = 0;
+                continue;
+            }
+            const auto& p = m_desc->planes[i];
+            auto samples = ( width + p.widthDiv - 1 ) / p.widthDiv;
+            layout.pitches[i] = align( samples * p.bytes, m_pitchAlignment );
+            layout.lines[i] = align( ( height + p.heightDiv - 1 ) / p.heightDiv, m_linesAlignment );
+        }
+        return true;
+    }
+
+    /**
+     * Returns a format callback negotiating the format with this
+     * configuration, which is copied.
+     *
+     * \param nbPictures The number of pictures to return to libvlc
+     * \param onFormat An optional callback, called with the negotiated
+     *                 format, typically to allocate the pictures
+     */
+    FormatCb callback( uint32_t nbPictures,
+                       std::function<void(const Layout&)> onFormat = nullptr ) const
+    {
+        auto format = *this;
+        return [format, nbPictures, onFormat]( char* chroma, uint32_t* width, uint32_t* height,
+                                                uint32_t* pitches, uint32_t* lines ) -> uint32_t {
+            Layout layout;
+            if ( format.negotiate( *width, *height, layout ) == false )
+                return 0;
+            if ( onFormat )
+                onFormat( layout );
+            layout.fill( chroma, width, height, pitches, lines );
+            return nbPictures;
+        };
+    }
+
+private:
+    struct PlaneDesc
+    {
+        uint8_t bytes;
+        uint8_t widthDiv;
+        uint8_t heightDiv;
+    };
+
+    struct ChromaDesc
+    {
+        char fourcc[5];
+        unsigned int nbPlanes;
+        uint32_t widthMultiple;
+        PlaneDesc planes[MaxPlanes];
+    };
+
+    static const ChromaDesc* find( const std::string& chroma )
+    {
+        static const ChromaDesc descs[] = {
+            { "RV32", 1, 1, { { 4, 1, 1 } } },
+            { "RGBA", 1, 1, { { 4, 1, 1 } } },
+            { "BGRA", 1, 1, { { 4, 1, 1 } } },
+            { "ARGB", 1, 1, { { 4, 1, 1 } } },
+            { "RV24", 1, 1, { { 3, 1, 1 } } },
+            { "RV16", 1, 1, { { 2, 1, 1 } } },
+            { "RV15", 1, 1, { { 2, 1, 1 } } },
+            { "GREY", 1, 1, { { 1, 1, 1 } } },
+            { "UYVY", 1, 2, { { 2, 1, 1 } } },
+            { "YUY2", 1, 2, { { 2, 1, 1 } } },
+            { "YVYU", 1, 2, { { 2, 1, 1 } } },
+            { "VYUY", 1, 2, { { 2, 1, 1 } } },
+            { "I420", 3, 1, { { 1, 1, 1 }, { 1, 2, 2 }, { 1, 2, 2 } } },
+            { "YV12", 3, 1, { { 1, 1, 1 }, { 1, 2, 2 }, { 1, 2, 2 } } },
+            { "J420", 3, 1, { { 1, 1, 1 }, { 1, 2, 2 }, { 1, 2, 2 } } },
+            { "I0AL", 3, 1, { { 2, 1, 1 }, { 2, 2, 2 }, { 2, 2, 2 } } },
+            { "I422", 3, 1, { { 1, 1, 1 }, { 1, 2, 1 }, { 1, 2, 1 } } },
+            { "J422", 3, 1, { { 1, 1, 1 }, { 1, 2, 1 }, { 1, 2, 1 } } },
+            { "I444", 3, 1, { { 1, 1, 1 }, { 1, 1, 1 }, { 1, 1, 1 } } },
+            { "J444", 3, 1, { { 1, 1, 1 }, { 1, 1, 1 }, { 1, 1, 1 } } },
+            { "NV12", 2, 1, { { 1, 1, 1 }, { 2, 2, 2 } } },
+            { "NV21", 2, 1, { { 1, 1, 1 }, { 2, 2, 2 } } },
+            { "NV16", 2, 1, { { 1, 1, 1 }, { 2, 2, 1 } } },
+            { "P010", 2, 1, { { 2, 1, 1 }, { 4, 2, 2 } } },
+        };
+        if ( chroma.size() != 4 )
+            return nullptr;
+        for ( const auto& d : descs )
+        {
+            if ( chroma == d.fourcc )
+                return &d;
+        }
+        return nullptr;
+    }
+
+    static uint32_t align( uint32_t v, uint32_t alignment )
+    {
+        return ( v + alignment - 1 ) / alignment * alignment;
+    }
+
+    /* The subsampling of the chroma, which the dimensions of a downscaled
+       picture are rounded to */
+    uint32_t widthStep() const
+    {
+        uint32_t step = m_desc->widthMultiple;
+        for ( auto i = 0u; i < m_desc->nbPlanes; ++i )
+            step = std::max<uint32_t>( step, m_desc->planes[i].widthDiv );
+        return step;
+    }
+
+    uint32_t heightStep() const
+    {
+        uint32_t step = 1;
+        for ( auto i = 0u; i < m_desc->nbPlanes; ++i )
+            step = std::max<uint32_t>( step, m_desc->planes[i].heightDiv );
+        return step;
+    }
+
+    /* Shrink the size to the bounding box, with square pixels */
+    void fit( uint32_t& width, uint32_t& height ) const
+    {
+        // The display size, without enlarging either dimension
+        double w = width;
+        double h = height;
+        if ( m_sarNum > m_sarDen )
+            h = h * m_sarDen / m_sarNum;
+        else
+            w = w * m_sarNum / m_sarDen;
+        auto scale = 1.;
+        if ( m_maxWidth != 0 )
+            scale = std::min( scale, m_maxWidth / w );
+        if ( m_maxHeight != 0 )
+            scale = std::min( scale, m_maxHeight / h );
+        auto round = []( double v, uint32_t step ) -> uint32_t {
+            auto n = static_cast<uint32_t>( std::floor( v / step ) );
+            return std::max<uint32_t>( n, 1 ) * step;
+        };
+        width = round( w * scale + .5, widthStep() );
+        height = round( h * scale + .5, heightStep() );
+    }
+
+private:
+    const ChromaDesc* m_desc;
+    uint32_t m_pitchAlignment;
+    uint32_t m_linesAlignment;
+    uint32_t m_maxWidth;
+    uint32_t m_maxHeight;
+    uint32_t m_sarNum;
+    uint32_t m_sarDen;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_VIDEOFORMAT_HPP
@@ -0,0 +1,356 @@
+/*****************************************************************************
+ * VideoFrameMailbox.hpp: Latest video frame, triple buffered
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_VIDEOFRAMEMAILBOX_HPP
+#define LIBVLC_CXX_VIDEOFRAMEMAILBOX_HPP
+
+#include "MediaPlayer.hpp"
+#include "VideoFormat.hpp"
+#include "VideoFrameSink.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace VLC
+{
+
+///
+/// \brief The VideoFrameMailbox class implements the video callbacks of a
+/// MediaPlayer with three buffers, and lets a single consumer read the most
+/// recent displayed frame, in place.
+///
+/// The video output decodes to its own buffer, and publishes it by swapping
+/// it with the mailbox one. The consumer takes the mailbox buffer by swapping
+/// it with the one it has been reading. Both swaps are a single atomic
+/// exchange, so the video output never waits for the consumer, and no frame
+/// is ever copied. A frame published while the previous one wasn't taken yet
+/// replaces it, and is counted as overwritten.
+///
+/// This suits previews and analytics, which only care about the newest
+/// frame. See VideoFrameSink for consumers which need every frame.
+///
+class VideoFrameMailbox
+{
+private:
+    struct Buffers;
+
+public:
+    using Format = VideoFormat::Layout;
+
+    ///
+    /// \brief A frame taken from the mailbox. It remains valid, and its
+    /// content unchanged, until the next call to latest().
+    ///
+    class Frame
+    {
+    public:
+        Frame()
+            : m_index( 0 )
+        {
+        }
+
+        bool isValid() const
+        {
+            return m_buffers != nullptr;
+        }
+
+        const Format& format() const
+        {
+            return m_buffers->format;
+        }
+
+        uint32_t width() const
+        {
+            return m_buffers->format.width;
+        }
+
+        uint32_t height() const
+        {
+            return m_buffers->format.height;
+        }
+
+        /**
+         * Returns a pointer to the first line of a plane. No bound checking
+         * is performed.
+         */
+        uint8_t* plane( unsigned int index ) const
+        {
+            return m_buffers->planes[m_index][index];
+        }
+
+        uint32_t pitch( unsigned int index ) const
+        {
+            return m_buffers->format.pitches[index];
+        }
+
+        /**
+         * Returns the display order of the frame, starting from 0 for each
+         * mailbox. Gaps are overwritten frames.
+         */
+        uint64_t sequence() const
+        {
+            return m_buffers->sequences[m_index];
+        }
+
+        /**
+         * Returns the time at which the display callback was called
+         */
+        std::chrono::steady_clock::time_point displayTime() const
+        {
+            return m_buffers->displayTimes[m_index];
+        }
+
+    private:
+        Frame( std::shared_ptr<Buffers> buffers, uint32_t index )
+            : m_buffers( std::move( buffers ) )
+            , m_index( index )
+        {
+        }
+
+        std::shared_ptr<Buffers> m_buffers;
+        uint32_t m_index;
+
+        friend class VideoFrameMailbox;
+    };
+
+    struct Stats
+    {
+        /// Frames published by the video output
+        uint64_t produced;
+        /// Frames taken by the consumer
+        uint64_t consumed;
+        /// Frames replaced by a newer one before being taken
+        uint64_t overwritten;
+    };
+
+    /**
+     * \param format The format negotiation of the frames
+     */
+    explicit VideoFrameMailbox( const VideoFormat& format )
+        : m_format( format )
+        , m_sequence( 0 )
+        , m_produced( 0 )
+        , m_consumed( 0 )
+        , m_overwritten( 0 )
+    {
+    }
+
+    /**
+     * \param chroma The fourcc of the frames
+     * \throw std::invalid_argument if the chroma isn't supported
+     */
+    explicit VideoFrameMailbox( const std::string& chroma )
+        : VideoFrameMailbox( VideoFormat( chroma ) )
+    {
+    }
+
+    VideoFrameMailbox( const VideoFrameMailbox& ) = delete;
+    VideoFrameMailbox& operator=( const VideoFrameMailbox& ) = delete;
+
+    /**
+     * Install the video callbacks on a media player. This must be called
+     * before playback starts, and the mailbox must outlive the playback.
+     */
+    void attach( MediaPlayer& mp )
+    {
+        mp.setVideoFormatCallbacks(
+            [this]( char* chroma, uint32_t* width, uint32_t* height,
+                    uint32_t* pitches, uint32_t* lines ) -> uint32_t {
+                return setup( chroma, width, height, pitches, lines );
+            },
+            [this]() {
+                cleanup();
+            } );
+        mp.setVideoCallbacks(
+            [this]( void** planes ) -> void* {
+                return lock( planes );
+            },
+            []( void*, void* const* ) {
+            },
+            [this]( void* ) {
+                display();
+            } );
+    }
+
+    /**
+     * Returns the most recent frame. If no frame was published since the
+     * previous call, the same frame is returned again, see Frame::sequence().
+     * This is meant to be called from a single consumer thread, and
+     * invalidates the frames it previously returned.
+     *
+     * \return The latest frame, or an invalid frame if none was displayed yet
+     */
+    Frame latest()
+    {
+        auto buffers = std::atomic_load( &m_buffers );
+        if ( buffers == nullptr )
+            return Frame();
+        auto state = buffers->state.load( std::memory_order_relaxed );
+        if ( ( state & Fresh ) != 0 )
+        {
+            state = buffers->state.exchange( buffers->read, std::memory_order_acq_rel );
+            // The video output may have retired these buffers meanwhile
+            if ( ( state & Fresh ) != 0 )
+                m_consumed.fetch_add( 1, std::memory_order_relaxed );
+            buffers->read = state & IndexMask;
+            buffers->hasRead = true;
+        }
+        if ( buffers->hasRead == false )
+            return Frame();
+        auto index = buffers->read;
+        return Frame( std::move( buffers ), index );
+    }
+
+    /**
+     * Returns true if a frame was published since the last call to latest()
+     */
+    bool hasNewFrame() const
+    {
+        auto buffers = std::atomic_load( &m_buffers );
+        return buffers != nullptr &&
+                ( buffers->state.load( std::memory_order_relaxed ) & Fresh ) != 0;
+    }
+
+    Stats stats() const
+    {
+        return Stats{ m_produced.load( std::memory_order_relaxed ),
+                      m_consumed.load( std::memory_order_relaxed ),
+                      m_overwritten.load( std::memory_order_relaxed ) };
+    }
+
+private:
+    /* The mailbox state packs the index of the mailbox buffer with a flag
+       telling whether the consumer already took it */
+    static constexpr uint32_t IndexMask = 0x3;
+    static constexpr uint32_t Fresh = 0x4;
+
+    struct Buffers
+    {
+        explicit Buffers( const Format& f )
+            : format( f )
+            , state( 1 )
+            , write( 0 )
+            , read( 2 )
+            , hasRead( false )
+        {
+            const auto alignment = VideoFrameSink::Alignment;
+            auto frameSize = ( f.frameSize() + alignment - 1 ) / alignment * alignment;
+            memory.reset( new uint8_t[frameSize * 3 + alignment] );
+            auto base = reinterpret_cast<uintptr_t>( memory.get() );
+            auto data = memory.get() + ( ( alignment - base % alignment ) % alignment );
+            for ( auto i = 0u; i < 3; ++i )
+            {
+                auto plane = data + frameSize * i;
+                for ( auto p = 0u; p < VideoFormat::MaxPlanes; ++p )
+                {
+                    planes[i][p] = p < f.nbPlanes ? plane : nullptr;
+                    if ( p < f.nbPlanes )
+                        plane += f.planeSize( p );
+                }
+                sequences[i] = 0;
+            }
+        }
+
+        const Format format;
+        std::unique_ptr<uint8_t[]> memory;
+        uint8_t* planes[3][VideoFormat::MaxPlanes];
+        uint64_t sequences[3];
+        std::chrono::steady_clock::time_point displayTimes[3];
+        std::atomic<uint32_t> state;
+        /* Only used by the video output */
+        uint32_t write;
+        /* Only used by the consumer */
+        uint32_t read;
+        bool hasRead;
+    };
+
+    uint32_t setup( char* chroma, uint32_t* width, uint32_t* height,
+                    uint32_t* pitches, uint32_t* lines )
+    {
+        Format format;
+        if ( m_format.negotiate( *width, *height, format ) == false )
+            return 0;
+        format.fill( chroma, width, height, pitches, lines );
+        retire();
+        m_current = std::make_shared<Buffers>( format );
+        std::atomic_store( &m_buffers, m_current );
+        return 1;
+    }
+
+    void cleanup()
+    {
+        // Keep the published buffers, so the consumer can still read the
+        // last frame
+        m_current.reset();
+    }
+
+    /* Count the frame which the consumer won't get to take, if any, as the
+       published buffers are about to be replaced. Only the video output
+       thread stores m_buffers, so it can read it without atomic_load */
+    void retire()
+    {
+        if ( m_buffers != nullptr &&
+             ( m_buffers->state.fetch_and( IndexMask, std::memory_order_acq_rel ) & Fresh ) != 0 )
+            m_overwritten.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    void* lock( void** planes )
+    {
+        // A picture which wasn't displayed is simply decoded over
+        auto& b = *m_current;
+        for ( auto i = 0u; i < b.format.nbPlanes; ++i )
+            planes[i] = b.planes[b.write][i];
+        return nullptr;
+    }
+
+    void display()
+    {
+        auto& b = *m_current;
+        b.sequences[b.write] = m_sequence++;
+        b.displayTimes[b.write] = std::chrono::steady_clock::now();
+        auto state = b.state.exchange( b.write | Fresh, std::memory_order_acq_rel );
+        b.write = state & IndexMask;
+        m_produced.fetch_add( 1, std::memory_order_relaxed );
+        if ( ( state & Fresh ) != 0 )
+            m_overwritten.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+private:
+    const VideoFormat m_format;
+
+    /* Only used from the video output thread */
+    std::shared_ptr<Buffers> m_current;
+    uint64_t m_sequence;
+
+    /* Accessed with atomic_load & atomic_store */
+    std::shared_ptr<Buffers> m_buffers;
+
+    std::atomic<uint64_t> m_produced;
+    std::atomic<uint64_t> m_consumed;
+    std::atomic<uint64_t> m_overwritten;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_VIDEOFRAMEMAILBOX_HPP
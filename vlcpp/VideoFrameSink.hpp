@@ -0,0 +1,449 @@
+/*****************************************************************************
+ * VideoFrameSink.hpp: Pooled frame buffers for the video callbacks
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_VIDEOFRAMESINK_HPP
+#define LIBVLC_CXX_VIDEOFRAMESINK_HPP
+
+#include "MediaPlayer.hpp"
+#include "VideoFormat.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace VLC
+{
+
+///
+/// \brief The VideoFrameSink class implements the video callbacks of a
+/// MediaPlayer on top of a pool of frame buffers, and hands the displayed
+/// frames to a consumer as reference counted handles.
+///
+/// The pool is allocated from the format callback, in the layout negotiated
+/// by a VideoFormat: by default, the planes and pitches are 64 bytes aligned.
+/// It holds the number of buffers requested by the video output, plus the
+/// number of frames the consumer is expected to hold at once.
+///
+/// The lock callback takes a buffer from a lock free list, in constant time.
+/// A frame returns to the list once the video output is done with it and all
+/// the handles to it are released, from whichever thread releases the last
+/// one. The video output thread never waits: when the consumer holds all the
+/// frames, the next pictures are decoded to a scratch buffer and dropped.
+///
+/// Frames keep their pool alive, so they remain valid after a format change,
+/// or once the sink is destroyed.
+///
+class VideoFrameSink
+{
+private:
+    struct Slot;
+    struct Pool;
+
+public:
+    /// Alignment of the frames in memory
+    static constexpr uint32_t Alignment = 64;
+    static constexpr unsigned int MaxPlanes = VideoFormat::MaxPlanes;
+
+    using Format = VideoFormat::Layout;
+
+    ///
+    /// \brief A reference counted handle on a displayed frame
+    ///
+    class Frame
+    {
+    public:
+        Frame()
+            : m_slot( nullptr )
+        {
+        }
+
+        Frame( const Frame& other )
+            : m_pool( other.m_pool )
+            , m_slot( other.m_slot )
+        {
+            if ( m_slot != nullptr )
+                m_slot->refs.fetch_add( 1, std::memory_order_relaxed );
+        }
+
+        Frame( Frame&& other )
+            : m_pool( std::move( other.m_pool ) )
+            , m_slot( other.m_slot )
+        {
+            other.m_slot = nullptr;
+        }
+
+        Frame& operator=( Frame other )
+        {
+            std::swap( m_pool, other.m_pool );
+            std::swap( m_slot, other.m_slot );
+            return *this;
+        }
+
+        ~Frame()
+        {
+            reset();
+        }
+
+        /**
+         * Release this handle. The frame returns to the pool once all its
+         * handles are released.
+         */
+        void reset()
+        {
+            if ( m_slot != nullptr &&
+                 m_slot->refs.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+                m_pool->push( m_slot );
+            m_slot = nullptr;
+            m_pool.reset();
+        }
+
+        bool isValid() const
+        {
+            return m_slot != nullptr;
+        }
+
+        const Format& format() const
+        {
+            return m_pool->format;
+        }
+
+        uint32_t width() const
+        {
+            return m_pool->format.width;
+        }
+
+        uint32_t height() const
+        {
+            return m_pool->format.height;
+        }
+
+        /**
+         * Returns a pointer to the first line of a plane. No bound checking
+         * is performed.
+         */
+        uint8_t* plane( unsigned int index ) const
+        {
+            return m_slot->planes[index];
+        }
+
+        uint32_t pitch( unsigned int index ) const
+        {
+            return m_pool->format.pitches[index];
+        }
+
+        /**
+         * Returns the display order of the frame, starting from 0 for each
+         * sink
+         */
+        uint64_t sequence() const
+        {
+            return m_slot->sequence;
+        }
+
+        /**
+         * Returns the time at which the display callback was called
+         */
+        std::chrono::steady_clock::time_point displayTime() const
+        {
+            return m_slot->displayTime;
+        }
+
+    private:
+        Frame( std::shared_ptr<Pool> pool, Slot* slot )
+            : m_pool( std::move( pool ) )
+            , m_slot( slot )
+        {
+        }
+
+        std::shared_ptr<Pool> m_pool;
+        Slot* m_slot;
+
+        friend class VideoFrameSink;
+    };
+
+    struct Stats
+    {
+        /// Frames handed to the consumer
+        uint64_t delivered;
+        /// Frames dropped because the consumer held all the buffers
+        uint64_t dropped;
+        /// Number of buffers in the current pool
+        size_t poolSize;
+    };
+
+    /**
+     * Consumer callback prototype. It is called from the video output thread,
+     * and should return quickly: keep the frame to process it elsewhere.
+     */
+    using OnFrame = std::function<void(Frame&&)>;
+
+    /**
+     * \param format The format negotiation of the frames
+     * \param onFrame The consumer callback
+     * \param heldFrames The number of frames the consumer is expected to
+     *                   hold at once, on top of the ones the video output
+     *                   needs
+     */
+    VideoFrameSink( const VideoFormat& format, OnFrame onFrame, unsigned int heldFrames = 2 )
+        : m_format( format )
+        , m_onFrame( std::move( onFrame ) )
+        , m_heldFrames( heldFrames )
+        , m_undisplayed( nullptr )
+        , m_sequence( 0 )
+        , m_delivered( 0 )
+        , m_dropped( 0 )
+        , m_poolSize( 0 )
+    {
+    }
+
+    /**
+     * \param chroma The fourcc of the frames, for instance "RV32" or "I420"
+     * \param onFrame The consumer callback
+     * \param heldFrames The number of frames the consumer is expected to
+     *                   hold at once, on top of the ones the video output
+     *                   needs
+     * \throw std::invalid_argument if the chroma isn't supported
+     */
+    VideoFrameSink( const std::string& chroma, OnFrame onFrame, unsigned int heldFrames = 2 )
+        : VideoFrameSink( VideoFormat( chroma ), std::move( onFrame ), heldFrames )
+    {
+    }
+
+    VideoFrameSink( const VideoFrameSink& ) = delete;
+    VideoFrameSink& operator=( const VideoFrameSink& ) = delete;
+
+    /**
+     * Install the video callbacks on a media player. This must be called
+     * before playback starts, and the sink must outlive the playback.
+     */
+    void attach( MediaPlayer& mp )
+    {
+        mp.setVideoFormatCallbacks(
+            [this]( char* chroma, uint32_t* width, uint32_t* height,
+                    uint32_t* pitches, uint32_t* lines ) -> uint32_t {
+                return setup( chroma, width, height, pitches, lines );
+            },
+            [this]() {
+                cleanup();
+            } );
+        mp.setVideoCallbacks(
+            [this]( void** planes ) -> void* {
+                return lock( planes );
+            },
+            [this]( void* picture, void* const* ) {
+                unlock( picture );
+            },
+            [this]( void* picture ) {
+                display( picture );
+            } );
+    }
+
+    Stats stats() const
+    {
+        return Stats{ m_delivered.load( std::memory_order_relaxed ),
+                      m_dropped.load( std::memory_order_relaxed ),
+                      m_poolSize.load( std::memory_order_relaxed ) };
+    }
+
+private:
+    /* Number of buffers requested for the video output */
+    static constexpr uint32_t NbOutputFrames = 3;
+    static constexpr uint32_t Nil = 0xffffffff;
+
+    struct Slot
+    {
+        std::atomic<uint32_t> refs;
+        std::atomic<uint32_t> next;
+        uint32_t index;
+        uint8_t* planes[MaxPlanes];
+        uint64_t sequence;
+        std::chrono::steady_clock::time_point displayTime;
+    };
+
+    ///
+    /// The buffers, and a Treiber stack of the free ones. The stack head
+    /// packs the index of the top slot with a counter incremented on every
+    /// update, so that a slot popped and pushed back concurrently with a pop
+    /// doesn't go unnoticed (ABA).
+    ///
+    struct Pool
+    {
+        Pool( const Format& f, uint32_t nbFrames )
+            : format( f )
+            , nbFrames( nbFrames )
+            , slots( new Slot[nbFrames + 1] )
+            , head( Nil )
+        {
+            auto frameSize = ( f.frameSize() + Alignment - 1 ) / Alignment * Alignment;
+            memory.reset( new uint8_t[frameSize * ( nbFrames + 1 ) + Alignment] );
+            auto base = reinterpret_cast<uintptr_t>( memory.get() );
+            auto data = memory.get() + ( ( Alignment - base % Alignment ) % Alignment );
+            // The last slot is the scratch buffer, which is never listed
+            for ( auto i = 0u; i <= nbFrames; ++i )
+            {
+                auto& s = slots[i];
+                s.refs.store( 0, std::memory_order_relaxed );
+                s.index = i;
+                s.sequence = 0;
+                auto plane = data + frameSize * i;
+                for ( auto p = 0u; p < MaxPlanes; ++p )
+                {
+                    s.planes[p] = p < f.nbPlanes ? plane : nullptr;
+                    if ( p < f.nbPlanes )
+                        plane += f.planeSize( p );
+                }
+                if ( i < nbFrames )
+                    push( &s );
+            }
+        }
+
+        bool pop( Slot*& slot )
+        {
+            auto h = head.load( std::memory_order_acquire );
+            uint64_t next;
+            do
+            {
+                auto index = static_cast<uint32_t>( h );
+                if ( index == Nil )
+                    return false;
+                slot = &slots[index];
+                next = ( ( h >> 32 ) + 1 ) << 32 | slot->next.load( std::memory_order_relaxed );
+            } while ( head.compare_exchange_weak( h, next, std::memory_order_acq_rel,
+                                                  std::memory_order_acquire ) == false );
+            return true;
+        }
+
+        void push( Slot* slot )
+        {
+            auto h = head.load( std::memory_order_relaxed );
+            uint64_t next;
+            do
+            {
+                slot->next.store( static_cast<uint32_t>( h ), std::memory_order_relaxed );
+                next = ( ( h >> 32 ) + 1 ) << 32 | slot->index;
+            } while ( head.compare_exchange_weak( h, next, std::memory_order_release,
+                                                  std::memory_order_relaxed ) == false );
+        }
+
+        Slot* scratch()
+        {
+            return &slots[nbFrames];
+        }
+
+        const Format format;
+        const uint32_t nbFrames;
+        std::unique_ptr<Slot[]> slots;
+        std::unique_ptr<uint8_t[]> memory;
+        std::atomic<uint64_t> head;
+    };
+
+    uint32_t setup( char* chroma, uint32_t* width, uint32_t* height,
+                    uint32_t* pitches, uint32_t* lines )
+    {
+        Format format;
+        if ( m_format.negotiate( *width, *height, format ) == false )
+            return 0;
+        format.fill( chroma, width, height, pitches, lines );
+        auto nbFrames = NbOutputFrames + m_heldFrames;
+        m_pool = std::make_shared<Pool>( format, nbFrames );
+        m_undisplayed = nullptr;
+        m_poolSize.store( nbFrames, std::memory_order_relaxed );
+        return NbOutputFrames;
+    }
+
+    void cleanup()
+    {
+        releaseUndisplayed();
+        // Frames still held by the consumer keep the pool alive
+        m_pool.reset();
+        m_poolSize.store( 0, std::memory_order_relaxed );
+    }
+
+    void releaseUndisplayed()
+    {
+        if ( m_undisplayed != nullptr &&
+             m_undisplayed->refs.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+            m_pool->push( m_undisplayed );
+        m_undisplayed = nullptr;
+    }
+
+    void* lock( void** planes )
+    {
+        // libvlc displays each picture right after unlocking it, so a
+        // picture still not displayed was dropped by the video output
+        releaseUndisplayed();
+        Slot* slot;
+        if ( m_pool->pop( slot ) == true )
+            slot->refs.store( 1, std::memory_order_relaxed );
+        else
+            slot = m_pool->scratch();
+        for ( auto i = 0u; i < m_pool->format.nbPlanes; ++i )
+            planes[i] = slot->planes[i];
+        return slot;
+    }
+
+    void unlock( void* picture )
+    {
+        auto slot = static_cast<Slot*>( picture );
+        if ( slot != m_pool->scratch() )
+            m_undisplayed = slot;
+    }
+
+    void display( void* picture )
+    {
+        auto slot = static_cast<Slot*>( picture );
+        if ( slot == m_pool->scratch() )
+        {
+            m_dropped.fetch_add( 1, std::memory_order_relaxed );
+            return;
+        }
+        if ( slot == m_undisplayed )
+            m_undisplayed = nullptr;
+        slot->sequence = m_sequence++;
+        slot->displayTime = std::chrono::steady_clock::now();
+        m_delivered.fetch_add( 1, std::memory_order_relaxed );
+        // The handle takes over the video output reference
+        Frame frame( m_pool, slot );
+        if ( m_onFrame )
+            m_onFrame( std::move( frame ) );
+    }
+
+private:
+    const VideoFormat m_format;
+    OnFrame m_onFrame;
+    const unsigned int m_heldFrames;
+
+    /* Only used from the video output thread */
+    std::shared_ptr<Pool> m_pool;
+    Slot* m_undisplayed;
+    uint64_t m_sequence;
+
+    std::atomic<uint64_t> m_delivered;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<size_t> m_poolSize;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_VIDEOFRAMESINK_HPP
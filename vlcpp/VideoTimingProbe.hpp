@@ -0,0 +1,488 @@
+/*****************************************************************************
+ * VideoTimingProbe.hpp: Timing instrumentation of the video callbacks
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_VIDEOTIMINGPROBE_HPP
+#define LIBVLC_CXX_VIDEOTIMINGPROBE_HPP
+
+#include "MediaPlayer.hpp"
+#include "structures.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+# include <intrin.h>
+#endif
+
+namespace VLC
+{
+
+///
+/// \brief The VideoTimingProbe class measures the timing of the video
+/// callbacks, to diagnose stuttering custom renderers.
+///
+/// It wraps the callbacks given to MediaPlayer::setVideoCallbacks(), and
+/// timestamps the return of lock, and the calls to unlock and display.
+/// From those, it measures:
+///  - the lock hold time, between lock and unlock, which is the time the
+///    decoder spends writing the picture
+///  - the lock to display latency
+///  - the interval between two displays
+///  - the jitter, which is the difference between that interval and the
+///    frame duration of the video track, once the frame rate is known
+/// Frames displayed more than half a frame duration late are counted as late.
+///
+/// The measures are kept in histograms covering a rolling time window, which
+/// can be read from any thread while the video output thread updates them.
+/// Reading never blocks the video output, at the cost of snapshots which may
+/// be off by the few frames recorded while they are taken.
+///
+/// Defining VLCPP_DISABLE_VIDEO_TIMING removes the instrumentation: the
+/// callbacks are then installed as is, and snapshots are empty.
+///
+class VideoTimingProbe
+{
+public:
+    ///
+    /// \brief A histogram of durations, in microseconds. Each power of two
+    /// is split in 4 buckets, so values are known within 25%.
+    ///
+    class Histogram
+    {
+    public:
+        static constexpr size_t NbBuckets = 104;
+
+        Histogram()
+            : buckets()
+            , count( 0 )
+            , total( 0 )
+            , max( 0 )
+        {
+        }
+
+        /**
+         * Returns the mean of the recorded values, or 0 if there are none
+         */
+        std::chrono::microseconds mean() const
+        {
+            if ( count == 0 )
+                return std::chrono::microseconds{ 0 };
+            return std::chrono::microseconds{ static_cast<int64_t>( total / count ) };
+        }
+
+        /**
+         * Returns an upper bound of the given percentile
+         *
+         * \param p The percentile, between 0 and 100
+         * \throw std::out_of_range if p is out of bounds
+         */
+        std::chrono::microseconds percentile( double p ) const
+        {
+            if ( p < 0 || p > 100 )
+                throw std::out_of_range( "Invalid percentile" );
+            if ( count == 0 )
+                return std::chrono::microseconds{ 0 };
+            auto rank = static_cast<uint64_t>( p / 100 * count + .5 );
+            uint64_t seen = 0;
+            for ( auto i = 0u; i < NbBuckets; ++i )
+            {
+                seen += buckets[i];
+                if ( seen >= rank && seen > 0 )
+                    return std::chrono::microseconds{
+                        static_cast<int64_t>( std::min( upperBound( i ), max ) ) };
+            }
+            return std::chrono::microseconds{ static_cast<int64_t>( max ) };
+        }
+
+        /**
+         * Returns the bucket of a value
+         */
+        static size_t bucket( uint64_t us )
+        {
+            if ( us < 4 )
+                return static_cast<size_t>( us );
+            auto octave = 63u - static_cast<unsigned int>( clz( us ) );
+            auto index = ( octave - 1 ) * 4 + ( ( us >> ( octave - 2 ) ) & 3 );
+            return std::min<size_t>( index, NbBuckets - 1 );
+        }
+
+        /**
+         * Returns the smallest value of the bucket following the given one
+         */
+        static uint64_t upperBound( size_t bucket )
+        {
+            auto next = bucket + 1;
+            if ( next < 4 )
+                return next;
+            return uint64_t{ 4 + next % 4 } << ( next / 4 - 1 );
+        }
+
+        std::array<uint64_t, NbBuckets> buckets;
+        uint64_t count;
+        /// The sum of the values, in microseconds
+        uint64_t total;
+        /// The largest value, in microseconds
+        uint64_t max;
+
+    private:
+        static unsigned int clz( uint64_t v )
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned int>( __builtin_clzll( v ) );
+#elif defined(_MSC_VER) && ( defined(_M_X64) || defined(_M_ARM64) )
+            unsigned long index;
+            _BitScanReverse64( &index, v );
+            return 63u - static_cast<unsigned int>( index );
+#else
+            auto n = 0u;
+            for ( auto shift = 32u; shift > 0; shift /= 2 )
+            {
+                if ( ( v >> ( 64 - shift ) ) == 0 )
+                {
+                    n += shift;
+                    v <<= shift;
+                }
+            }
+            return n;
+#endif
+        }
+    };
+
+    struct Snapshot
+    {
+        Histogram lockHold;
+        Histogram lockToDisplay;
+        Histogram displayInterval;
+        /// Absolute difference between the display interval and the frame
+        /// duration. Empty until the frame rate is known.
+        Histogram jitter;
+        /// Frames displayed during the window
+        uint64_t frames;
+        /// Frames displayed late during the window
+        uint64_t late;
+        /// Frames displayed since the probe was created
+        uint64_t totalFrames;
+        /// Late frames since the probe was created
+        uint64_t totalLate;
+        /// The expected interval between frames, or 0 if unknown
+        std::chrono::microseconds frameDuration;
+    };
+
+    /**
+     * \param window The duration covered by the histograms. It is split in
+     *               4 parts, the oldest being discarded as time goes on.
+     * \throw std::invalid_argument if the window is shorter than 4µs
+     */
+    explicit VideoTimingProbe( std::chrono::microseconds window = std::chrono::seconds( 10 ) )
+        : m_epochDuration( window / static_cast<int64_t>( NbEpochs ) )
+        , m_epoch( 0 )
+        , m_started( false )
+        , m_frameDuration( 0 )
+        , m_totalFrames( 0 )
+        , m_totalLate( 0 )
+    {
+        if ( m_epochDuration.count() <= 0 )
+            throw std::invalid_argument( "Invalid timing window" );
+    }
+
+    VideoTimingProbe( const VideoTimingProbe& ) = delete;
+    VideoTimingProbe& operator=( const VideoTimingProbe& ) = delete;
+
+    /**
+     * Install the video callbacks on a media player, with the timing
+     * instrumentation around them. See MediaPlayer::setVideoCallbacks()
+     * for the callbacks prototypes. The probe must outlive the playback.
+     */
+    template <typename LockCb, typename UnlockCb, typename DisplayCb>
+    void setVideoCallbacks( MediaPlayer& mp, LockCb&& lock, UnlockCb&& unlock, DisplayCb&& display )
+    {
+#ifdef VLCPP_DISABLE_VIDEO_TIMING
+        mp.setVideoCallbacks( std::forward<LockCb>( lock ), std::forward<UnlockCb>( unlock ),
+                              std::forward<DisplayCb>( display ) );
+#else
+        using Cbs = Callbacks<typename std::decay<LockCb>::type,
+                              typename std::decay<UnlockCb>::type,
+                              typename std::decay<DisplayCb>::type>;
+        auto cbs = std::make_shared<Cbs>( std::forward<LockCb>( lock ),
+                                          std::forward<UnlockCb>( unlock ),
+                                          std::forward<DisplayCb>( display ) );
+        mp.setVideoCallbacks(
+            [this, cbs]( void** planes ) -> void* {
+                auto picture = cbs->lock( planes );
+                locked();
+                return picture;
+            },
+            [this, cbs]( void* picture, void* const* planes ) {
+                unlocked();
+                call( cbs->unlock, picture, planes );
+            },
+            [this, cbs]( void* picture ) {
+                displayed();
+                call( cbs->display, picture );
+            } );
+#endif
+    }
+
+    /**
+     * Set the frame rate the display intervals are compared to. This can be
+     * called while playing, typically once the video track is selected.
+     */
+    void setFrameRate( uint32_t fpsNum, uint32_t fpsDen )
+    {
+        int64_t duration = 0;
+        if ( fpsNum != 0 && fpsDen != 0 )
+            duration = static_cast<int64_t>( uint64_t{ fpsDen } * 1000000 / fpsNum );
+        m_frameDuration.store( duration, std::memory_order_relaxed );
+    }
+
+    /**
+     * Set the frame rate from a video track
+     */
+    void setFrameRate( const MediaTrack& track )
+    {
+        setFrameRate( track.fpsNum(), track.fpsDen() );
+    }
+
+    /**
+     * Timestamp the return of a lock callback. This, unlocked() and
+     * displayed() are called by the callbacks installed with
+     * setVideoCallbacks(), and can be used to instrument other callbacks,
+     * from the video output thread only.
+     */
+    void locked()
+    {
+#ifndef VLCPP_DISABLE_VIDEO_TIMING
+        m_lockTime = Clock::now();
+#endif
+    }
+
+    void unlocked()
+    {
+#ifndef VLCPP_DISABLE_VIDEO_TIMING
+        auto now = Clock::now();
+        rotate( now );
+        record( &Epoch::lockHold, now - m_lockTime );
+#endif
+    }
+
+    void displayed()
+    {
+#ifndef VLCPP_DISABLE_VIDEO_TIMING
+        auto now = Clock::now();
+        rotate( now );
+        auto& e = m_epochs[m_epoch];
+        record( &Epoch::lockToDisplay, now - m_lockTime );
+        increment( e.frames );
+        m_totalFrames.fetch_add( 1, std::memory_order_relaxed );
+        if ( m_started == true )
+        {
+            auto interval = now - m_lastDisplay;
+            record( &Epoch::displayInterval, interval );
+            auto expected = std::chrono::microseconds{ m_frameDuration.load( std::memory_order_relaxed ) };
+            if ( expected.count() > 0 )
+            {
+                auto jitter = interval > expected ? interval - expected : expected - interval;
+                record( &Epoch::jitter, jitter );
+                if ( interval > expected + expected / 2 )
+                {
+                    increment( e.late );
+                    m_totalLate.fetch_add( 1, std::memory_order_relaxed );
+                }
+            }
+        }
+        m_started = true;
+        m_lastDisplay = now;
+#endif
+    }
+
+    /**
+     * Returns the histograms of the current window. This can be called from
+     * any thread.
+     */
+    Snapshot snapshot() const
+    {
+        Snapshot s;
+        s.frames = 0;
+        s.late = 0;
+        for ( const auto& e : m_epochs )
+        {
+            merge( s.lockHold, e.lockHold );
+            merge( s.lockToDisplay, e.lockToDisplay );
+            merge( s.displayInterval, e.displayInterval );
+            merge( s.jitter, e.jitter );
+            s.frames += e.frames.load( std::memory_order_relaxed );
+            s.late += e.late.load( std::memory_order_relaxed );
+        }
+        s.totalFrames = m_totalFrames.load( std::memory_order_relaxed );
+        s.totalLate = m_totalLate.load( std::memory_order_relaxed );
+        s.frameDuration = std::chrono::microseconds{ m_frameDuration.load( std::memory_order_relaxed ) };
+        return s;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t NbEpochs = 4;
+
+    template <typename LockCb, typename UnlockCb, typename DisplayCb>
+    struct Callbacks
+    {
+        template <typename L, typename U, typename D>
+        Callbacks( L&& l, U&& u, D&& d )
+            : lock( std::forward<L>( l ) )
+            , unlock( std::forward<U>( u ) )
+            , display( std::forward<D>( d ) )
+        {
+        }
+
+        LockCb lock;
+        UnlockCb unlock;
+        DisplayCb display;
+    };
+
+    template <typename Cb, typename... Args>
+    static void call( Cb& cb, Args... args )
+    {
+        cb( args... );
+    }
+
+    template <typename... Args>
+    static void call( std::nullptr_t, Args... )
+    {
+    }
+
+    /* Only the video output thread writes the counters, so they are updated
+       with plain loads and stores, which only need to be atomic for the
+       readers */
+    static void increment( std::atomic<uint64_t>& v, uint64_t n = 1 )
+    {
+        v.store( v.load( std::memory_order_relaxed ) + n, std::memory_order_relaxed );
+    }
+
+    struct AtomicHistogram
+    {
+        std::atomic<uint64_t> buckets[Histogram::NbBuckets];
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> total;
+        std::atomic<uint64_t> max;
+
+        void add( uint64_t us )
+        {
+            increment( buckets[Histogram::bucket( us )] );
+            increment( count );
+            increment( total, us );
+            if ( us > max.load( std::memory_order_relaxed ) )
+                max.store( us, std::memory_order_relaxed );
+        }
+
+        void clear()
+        {
+            for ( auto& b : buckets )
+                b.store( 0, std::memory_order_relaxed );
+            count.store( 0, std::memory_order_relaxed );
+            total.store( 0, std::memory_order_relaxed );
+            max.store( 0, std::memory_order_relaxed );
+        }
+    };
+
+    struct Epoch
+    {
+        Epoch()
+        {
+            clear();
+        }
+
+        void clear()
+        {
+            lockHold.clear();
+            lockToDisplay.clear();
+            displayInterval.clear();
+            jitter.clear();
+            frames.store( 0, std::memory_order_relaxed );
+            late.store( 0, std::memory_order_relaxed );
+        }
+
+        AtomicHistogram lockHold;
+        AtomicHistogram lockToDisplay;
+        AtomicHistogram displayInterval;
+        AtomicHistogram jitter;
+        std::atomic<uint64_t> frames;
+        std::atomic<uint64_t> late;
+    };
+
+    static void merge( Histogram& h, const AtomicHistogram& a )
+    {
+        for ( auto i = 0u; i < Histogram::NbBuckets; ++i )
+            h.buckets[i] += a.buckets[i].load( std::memory_order_relaxed );
+        h.count += a.count.load( std::memory_order_relaxed );
+        h.total += a.total.load( std::memory_order_relaxed );
+        h.max = std::max( h.max, a.max.load( std::memory_order_relaxed ) );
+    }
+
+    void record( AtomicHistogram Epoch::* histogram, Clock::duration d )
+    {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>( d ).count();
+        ( m_epochs[m_epoch].*histogram ).add( us > 0 ? static_cast<uint64_t>( us ) : 0 );
+    }
+
+    /* Move to the next epoch once the current one is over, discarding the
+       oldest measures */
+    void rotate( Clock::time_point now )
+    {
+        if ( m_epochEnd == Clock::time_point{} )
+        {
+            m_epochEnd = now + m_epochDuration;
+            return;
+        }
+        for ( auto i = 0u; now >= m_epochEnd && i < NbEpochs; ++i )
+        {
+            m_epoch = ( m_epoch + 1 ) % NbEpochs;
+            m_epochs[m_epoch].clear();
+            m_epochEnd += m_epochDuration;
+        }
+        if ( now >= m_epochEnd )
+            m_epochEnd = now + m_epochDuration;
+    }
+
+private:
+    const std::chrono::microseconds m_epochDuration;
+    Epoch m_epochs[NbEpochs];
+
+    /* Only used from the video output thread */
+    size_t m_epoch;
+    Clock::time_point m_epochEnd;
+    Clock::time_point m_lockTime;
+    Clock::time_point m_lastDisplay;
+    bool m_started;
+
+    std::atomic<int64_t> m_frameDuration;
+    std::atomic<uint64_t> m_totalFrames;
+    std::atomic<uint64_t> m_totalLate;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_VIDEOTIMINGPROBE_HPP
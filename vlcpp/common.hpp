@@ -473,6 +473,69 @@ namespace VLC
             }
         };
     } //namespace imem
+
+    namespace parser
+    {
+        // The parser callbacks are registered once per Callbacks object, but
+        // libvlc receives its opaque value for each queued request. We box the
+        // CallbackArray along with the user context of the request, so the
+        // callbacks can hand it back. The box is released by the callback
+        // terminating the request.
+        struct Opaque
+        {
+            void* callbacks;
+            void* context;
+        };
+
+        // Pass the context as an extra last parameter, if the user callback
+        // accepts it. The int/long parameter gives precedence to that overload.
+        template <typename Func, typename... Args>
+        auto invoke( int, Func& func, void* context, Args&&... args )
+            -> decltype( func( std::forward<Args>( args )..., context ) )
+        {
+            return func( std::forward<Args>( args )..., context );
+        }
+
+        template <typename Func, typename... Args>
+        auto invoke( long, Func& func, void*, Args&&... args )
+            -> decltype( func( std::forward<Args>( args )... ) )
+        {
+            return func( std::forward<Args>( args )... );
+        }
+
+        template <size_t Idx, bool Terminal, typename... Args>
+        struct CallbackWrapper;
+
+        template <size_t Idx, bool Terminal, typename Ret, typename... Args>
+        struct CallbackWrapper<Idx, Terminal, Ret(*)(void*, Args...)>
+        {
+            using Wrapped = Ret(*)(void*, Args...);
+            using Base = VLC::CallbackWrapper<Idx, Wrapped>;
+
+            template <typename... ArgWrapper, size_t NbEvents, typename Func>
+            static Wrapped wrap(CallbackArray<NbEvents>& callbacks, Func&& func)
+            {
+                static_assert( sizeof...(ArgWrapper) == sizeof...(Args),
+                               "An ArgWrapper is required for each argument" );
+                callbacks[Idx] = std::unique_ptr<CallbackHandler<Func>>( new CallbackHandler<Func>( std::forward<Func>( func ) ) );
+                return [](void* opaque, Args... args) -> Ret {
+                    auto box = static_cast<Opaque*>( opaque );
+                    std::unique_ptr<Opaque> release( Terminal ? box : nullptr );
+                    auto& callbacks = *static_cast<CallbackArray<NbEvents>*>( box->callbacks );
+                    assert(callbacks[Idx] != nullptr);
+                    auto cbHandler = static_cast<CallbackHandler<Func>*>( callbacks[Idx].get() );
+                    return invoke( 0, cbHandler->func, box->context,
+                                   Base::template argWrapper<ArgWrapper>( std::forward<Args>( args ) )... );
+                };
+            }
+
+            template <size_t NbEvents>
+            static std::nullptr_t wrap(CallbackArray<NbEvents>&, std::nullptr_t)
+            {
+                return nullptr;
+            }
+        };
+    } // namespace parser
 }
 
 #endif
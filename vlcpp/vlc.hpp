@@ -29,11 +29,33 @@
 #include "MediaListPlayer.hpp"
 #include "MediaDiscoverer.hpp"
 #include "Picture.hpp"
+#include "ImageView.hpp"
+#include "PixelConvert.hpp"
 #include "Media.hpp"
 #include "MediaList.hpp"
 #include "RendererDiscoverer.hpp"
 #include "MediaPlayer.hpp"
 #include "Parser.hpp"
 #include "structures.hpp"
+#include "Future.hpp"
+#include "StatsSampler.hpp"
+#include "ParseCache.hpp"
+#include "ParseBatch.hpp"
+#include "ParserScheduler.hpp"
+#include "DeadlineParser.hpp"
+#include "ParserTaskTable.hpp"
+#include "TimelinePreview.hpp"
+#include "ThumbnailCache.hpp"
+#include "RequestCoalescer.hpp"
+#include "AdaptiveParser.hpp"
+#include "ParsedMediaInfo.hpp"
+#include "TreeScanner.hpp"
+#include "HammingIndex.hpp"
+#include "PerceptualHash.hpp"
+#include "PictureSavePool.hpp"
+#include "VideoFormat.hpp"
+#include "VideoFrameSink.hpp"
+#include "VideoFrameMailbox.hpp"
+#include "VideoTimingProbe.hpp"
 
 #endif